@@ -28,6 +28,7 @@ SPVTOOLS_SRC_FILES := \
 		source/text.cpp \
 		source/text_handler.cpp \
 		source/util/bit_vector.cpp \
+		source/util/coverage_counters.cpp \
 		source/util/parse_number.cpp \
 		source/util/string_utils.cpp \
 		source/util/timer.cpp \
@@ -36,6 +37,7 @@ SPVTOOLS_SRC_FILES := \
 		source/val/function.cpp \
 		source/val/instruction.cpp \
 		source/val/validation_state.cpp \
+		source/val/validation_stats.cpp \
 		source/val/validate.cpp \
 		source/val/validate_adjacency.cpp \
 		source/val/validate_annotation.cpp \
@@ -76,6 +76,7 @@ typedef enum spv_result_t {
   SPV_ERROR_INVALID_DATA = -14,  // Indicates data rules validation failure.
   SPV_ERROR_MISSING_EXTENSION = -15,
   SPV_ERROR_WRONG_VERSION = -16,  // Indicates wrong SPIR-V version
+  SPV_ERROR_WORK_LIMIT = -17,     // Indicates a validator work limit was hit
   SPV_FORCE_32_BIT_ENUM(spv_result_t)
 } spv_result_t;
 
@@ -537,6 +538,41 @@ typedef enum {
   spv_validator_limit_max_id_bound,
 } spv_validator_limit;
 
+// SPIR-V Validator can bound the work it spends on the following checks,
+// whose cost is not linear in the size of the module.  These limits are not
+// part of the SPIR-V specification: they bound the validation time of
+// untrusted modules.
+typedef enum {
+  // Number of edges between the blocks of all the functions of the module.
+  spv_validator_work_limit_max_cfg_edges,
+  // Number of dominance and post-dominance queries made by the control flow
+  // and id checks.
+  spv_validator_work_limit_max_dominance_queries,
+  // Number of types visited while walking the members of composite types.
+  spv_validator_work_limit_max_type_traversal,
+} spv_validator_work_limit;
+
+// Sets of checks the SPIR-V Validator can be asked to perform.
+typedef enum {
+  // All the checks.  This is the default.
+  SPV_VAL_PROFILE_FULL,
+  // Only the checks that tools consuming a module rely on to process it
+  // safely, for modules from a trusted producer that were already fully
+  // validated by the same version of the library:
+  // - the module header, instruction encodings and logical layout,
+  // - capability, extension and instruction availability,
+  // - id definitions, uses, forward references and dominance,
+  // - type, constant, function and annotation declarations,
+  // - memory instructions, such as variables, loads, stores and access chains,
+  // - composite instructions, such as extracts, inserts and shuffles,
+  // - control flow instructions and CFG structure,
+  // - entry points, execution modes and the memory model.
+  // Checks of the other instructions (image, arithmetic, extended
+  // instructions, ...), of decorations and buffer layouts, of interfaces, of
+  // built-ins and of execution model limitations are skipped.
+  SPV_VAL_PROFILE_STRUCTURAL,
+} spv_validator_profile;
+
 // Returns a string describing the given SPIR-V target environment.
 SPIRV_TOOLS_EXPORT const char* spvTargetEnvDescription(spv_target_env env);
 
@@ -670,6 +706,38 @@ SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetSkipBlockLayout(
 SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetAllowLocalSizeId(
     spv_validator_options options, bool val);
 
+// Records the set of checks the validator should perform.  See
+// spv_validator_profile.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetProfile(
+    spv_validator_options options, spv_validator_profile profile);
+
+// Records whether or not the validator should run the checks of each
+// instruction which only depend on the preceding instructions while it parses
+// the module, so that it stops parsing at the first error they find.  This
+// lowers the time taken to reject a module with an early error.  It does not
+// lower the memory used to validate a valid module: all of its instructions are
+// still stored, and the remaining checks run over the whole module once it has
+// been parsed.  The first error reported for a module with several errors may
+// differ from the one reported otherwise.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetStreaming(
+    spv_validator_options options, bool val);
+
+// Records the work limit of the given type for the validator.  Validation
+// stops with SPV_ERROR_WORK_LIMIT as soon as the limit is exceeded.  A limit
+// of 0, the default, does not bound the work.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetWorkLimit(
+    spv_validator_options options, spv_validator_work_limit limit_type,
+    uint32_t limit);
+
+// Records whether or not the validator should collect statistics about the
+// time spent and the number of instructions inspected by each family of
+// checks, and about the size of the module.  The statistics are reported as a
+// single SPV_MSG_INFO message to the message consumer of the context, unless
+// the diagnostic is requested through the |diagnostic| argument of the
+// validation call.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetCollectStats(
+    spv_validator_options options, bool val);
+
 // Creates an optimizer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvOptimizerOptionsDestroy|.
@@ -121,6 +121,29 @@ class ValidatorOptions {
     spvValidatorOptionsSetAllowLocalSizeId(options_, val);
   }
 
+  // Records the set of checks the validator should perform.
+  void SetProfile(spv_validator_profile profile) {
+    spvValidatorOptionsSetProfile(options_, profile);
+  }
+
+  // Records whether or not the validator should check instructions while it
+  // parses the module, and stop parsing at the first error.
+  void SetStreaming(bool val) {
+    spvValidatorOptionsSetStreaming(options_, val);
+  }
+
+  // Records the work limit of the given type for the validator.  A limit of 0
+  // does not bound the work.
+  void SetWorkLimit(spv_validator_work_limit limit_type, uint32_t limit) {
+    spvValidatorOptionsSetWorkLimit(options_, limit_type, limit);
+  }
+
+  // Records whether or not the validator should report statistics about the
+  // work done by each family of checks to the message consumer.
+  void SetCollectStats(bool val) {
+    spvValidatorOptionsSetCollectStats(options_, val);
+  }
+
   // Records whether or not the validator should relax the rules on pointer
   // usage in logical addressing mode.
   //
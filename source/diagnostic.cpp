@@ -184,6 +184,9 @@ std::string spvResultToString(spv_result_t res) {
     case SPV_ERROR_INVALID_LAYOUT:
       out = "SPV_ERROR_INVALID_LAYOUT";
       break;
+    case SPV_ERROR_WORK_LIMIT:
+      out = "SPV_ERROR_WORK_LIMIT";
+      break;
     default:
       out = "Unknown Error";
   }
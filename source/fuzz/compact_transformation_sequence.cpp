@@ -0,0 +1,179 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/fuzz/compact_transformation_sequence.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace spvtools {
+namespace fuzz {
+namespace {
+
+bool WriteWord(uint32_t word, std::ostream* out) {
+  const char bytes[4] = {
+      static_cast<char>(word & 0xFF), static_cast<char>((word >> 8) & 0xFF),
+      static_cast<char>((word >> 16) & 0xFF),
+      static_cast<char>((word >> 24) & 0xFF)};
+  out->write(bytes, sizeof(bytes));
+  return out->good();
+}
+
+bool ReadWord(std::istream* in, uint32_t* word) {
+  unsigned char bytes[4];
+  if (!in->read(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+    return false;
+  }
+  *word = static_cast<uint32_t>(bytes[0]) |
+          (static_cast<uint32_t>(bytes[1]) << 8) |
+          (static_cast<uint32_t>(bytes[2]) << 16) |
+          (static_cast<uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+// Returns the number of bytes left to read in |in|, or -1 if |in| cannot tell,
+// e.g. because it is not seekable.
+std::streamoff GetNumBytesLeft(std::istream* in) {
+  const auto position = in->tellg();
+  if (position < 0) {
+    return -1;
+  }
+  in->seekg(0, std::ios::end);
+  const auto end = in->tellg();
+  in->clear();
+  in->seekg(position);
+  if (end < 0) {
+    return -1;
+  }
+  return end - position;
+}
+
+}  // namespace
+
+bool WriteCompactTransformationSequence(
+    const protobufs::TransformationSequence& transformations,
+    std::ostream* out) {
+  if (!WriteWord(kCompactTransformationSequenceMagic, out) ||
+      !WriteWord(kCompactTransformationSequenceVersion, out) ||
+      !WriteWord(static_cast<uint32_t>(transformations.transformation_size()),
+                 out)) {
+    return false;
+  }
+  std::string record;
+  for (const auto& transformation : transformations.transformation()) {
+    record.clear();
+    if (!transformation.SerializeToString(&record) ||
+        !WriteWord(static_cast<uint32_t>(record.size()), out)) {
+      return false;
+    }
+    out->write(record.data(), static_cast<std::streamsize>(record.size()));
+    if (!out->good()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsCompactTransformationSequence(std::istream* in) {
+  const auto position = in->tellg();
+  uint32_t magic = 0;
+  const bool result =
+      ReadWord(in, &magic) && magic == kCompactTransformationSequenceMagic;
+  in->clear();
+  in->seekg(position);
+  return result;
+}
+
+CompactTransformationSequenceReader::CompactTransformationSequenceReader(
+    std::istream* in)
+    : in_(in),
+      has_valid_header_(false),
+      num_transformations_(0),
+      num_read_(0),
+      num_bytes_left_(-1) {
+  uint32_t magic;
+  uint32_t version;
+  has_valid_header_ = ReadWord(in_, &magic) &&
+                      magic == kCompactTransformationSequenceMagic &&
+                      ReadWord(in_, &version) &&
+                      version == kCompactTransformationSequenceVersion &&
+                      ReadWord(in_, &num_transformations_);
+  if (has_valid_header_) {
+    num_bytes_left_ = GetNumBytesLeft(in_);
+  }
+}
+
+uint32_t CompactTransformationSequenceReader::GetNumTransformations() const {
+  assert(has_valid_header_ && "The header is malformed.");
+  return num_transformations_;
+}
+
+bool CompactTransformationSequenceReader::ReadNext(
+    protobufs::Transformation* transformation) {
+  if (!has_valid_header_ || num_read_ == num_transformations_) {
+    return false;
+  }
+  uint32_t record_size;
+  if (!ReadWord(in_, &record_size)) {
+    return false;
+  }
+  // The record size comes from the input, so it is checked against the bytes
+  // actually left before anything is allocated for it.
+  if (num_bytes_left_ >= 0) {
+    num_bytes_left_ -= static_cast<std::streamoff>(sizeof(record_size));
+    if (static_cast<std::streamoff>(record_size) > num_bytes_left_) {
+      return false;
+    }
+    num_bytes_left_ -= static_cast<std::streamoff>(record_size);
+  }
+  // The record is read in bounded chunks, so that the memory used stays
+  // proportional to the bytes read even if the size of the stream is unknown.
+  std::string record;
+  char chunk[4096];
+  uint32_t num_to_read = record_size;
+  while (num_to_read > 0) {
+    const auto chunk_size = std::min<uint32_t>(num_to_read, sizeof(chunk));
+    if (!in_->read(chunk, static_cast<std::streamsize>(chunk_size))) {
+      return false;
+    }
+    record.append(chunk, chunk_size);
+    num_to_read -= chunk_size;
+  }
+  if (!transformation->ParseFromString(record)) {
+    return false;
+  }
+  num_read_++;
+  return true;
+}
+
+bool ReadCompactTransformationSequence(
+    std::istream* in, uint32_t max_transformations,
+    protobufs::TransformationSequence* transformations) {
+  CompactTransformationSequenceReader reader(in);
+  if (!reader.HasValidHeader()) {
+    return false;
+  }
+  const uint32_t num_to_read =
+      std::min(max_transformations, reader.GetNumTransformations());
+  while (reader.GetNumTransformationsRead() < num_to_read) {
+    if (!reader.ReadNext(transformations->add_transformation())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace fuzz
+}  // namespace spvtools
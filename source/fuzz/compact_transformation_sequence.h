@@ -0,0 +1,96 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_FUZZ_COMPACT_TRANSFORMATION_SEQUENCE_H_
+#define SOURCE_FUZZ_COMPACT_TRANSFORMATION_SEQUENCE_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
+
+namespace spvtools {
+namespace fuzz {
+
+// The compact transformation sequence format stores a sequence of
+// transformations so that it can be read one transformation at a time, and so
+// that a prefix of the sequence can be read without deserializing the rest.
+//
+// All integers are 32-bit and little-endian.  The format consists of:
+// - the magic number kCompactTransformationSequenceMagic;
+// - the format version, kCompactTransformationSequenceVersion;
+// - the number of transformations, N;
+// - N records, each consisting of a byte count L followed by L bytes holding
+//   a serialized protobufs::Transformation message.
+const uint32_t kCompactTransformationSequenceMagic = 0x53544653;  // "SFTS"
+const uint32_t kCompactTransformationSequenceVersion = 1;
+
+// Writes |transformations| to |out| in the compact format.  Returns false if
+// a transformation could not be serialized or the stream could not be written.
+bool WriteCompactTransformationSequence(
+    const protobufs::TransformationSequence& transformations,
+    std::ostream* out);
+
+// Returns true if and only if |in| is positioned at the start of a sequence in
+// the compact format.  The position of |in| is left unchanged.
+bool IsCompactTransformationSequence(std::istream* in);
+
+// Reads transformations in the compact format from a stream, one at a time.
+class CompactTransformationSequenceReader {
+ public:
+  // Reads the header of a compact sequence from |in|, which must outlive this
+  // object.
+  explicit CompactTransformationSequenceReader(std::istream* in);
+
+  // Returns true if and only if a well-formed header was read.
+  bool HasValidHeader() const { return has_valid_header_; }
+
+  // Returns the number of transformations in the sequence, according to its
+  // header.  Requires HasValidHeader().
+  uint32_t GetNumTransformations() const;
+
+  // Returns the number of transformations read so far.
+  uint32_t GetNumTransformationsRead() const { return num_read_; }
+
+  // Reads the next transformation into |transformation|.  Returns false if all
+  // transformations have been read, or if the record is malformed.
+  bool ReadNext(protobufs::Transformation* transformation);
+
+ private:
+  std::istream* in_;
+
+  bool has_valid_header_;
+
+  uint32_t num_transformations_;
+
+  uint32_t num_read_;
+
+  // The number of bytes of |in_| that follow the records read so far, worked
+  // out once when the header is read, or -1 if |in_| cannot tell.
+  std::streamoff num_bytes_left_;
+};
+
+// Reads the first |max_transformations| transformations of the compact
+// sequence in |in| (or all of them, if there are fewer) into |transformations|,
+// leaving the remaining records unparsed.  Returns false if the header or a
+// record that is read is malformed.
+bool ReadCompactTransformationSequence(
+    std::istream* in, uint32_t max_transformations,
+    protobufs::TransformationSequence* transformations);
+
+}  // namespace fuzz
+}  // namespace spvtools
+
+#endif  // SOURCE_FUZZ_COMPACT_TRANSFORMATION_SEQUENCE_H_
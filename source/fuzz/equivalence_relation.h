@@ -19,7 +19,7 @@
 #include <cassert>
 #include <memory>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/util/make_unique.h"
@@ -34,20 +34,26 @@ namespace fuzz {
 // of type |T|.
 //
 // A disjoint-set (a.k.a. union-find or merge-find) data structure is used to
-// represent the equivalence relation.  Path compression is used.  Union by
-// rank/size is not used.
+// represent the equivalence relation.  Path compression and union by size are
+// used, so that the trees representing the sets stay shallow.
+//
+// Each value registered with the relation is assigned a dense integer handle:
+// its position in registration order.  The union-find structure is stored in
+// flat vectors indexed by handle.
 //
 // Each disjoint set is represented as a tree, rooted at the representative
 // of the set.
 //
-// Getting the representative of a value simply requires chasing parent pointers
+// Getting the representative of a value simply requires chasing parent handles
 // from the value until you reach the root.
 //
 // Checking equivalence of two elements requires checking that the
 // representatives are equal.
 //
-// Traversing the tree rooted at a value's representative visits the value's
-// equivalence class.
+// In addition to the trees, the members of each set are linked into a circular
+// list, so that a value's equivalence class can be enumerated in time
+// proportional to the size of the class.  Merging two sets splices their lists
+// together in constant time.
 //
 // |PointerHashT| and |PointerEqualsT| are used to define *equality* between
 // values, and otherwise are *not* used to define the equivalence relation
@@ -63,13 +69,33 @@ namespace fuzz {
 //
 // Each unique (up to equality) value added to the relation is copied into
 // |owned_values_|, so there is one canonical memory address per unique value.
-// Uniqueness is ensured by storing (and checking) a set of pointers to these
-// values in |value_set_|, which uses |PointerHashT| and |PointerEqualsT|.
+// Uniqueness is ensured by storing (and checking) a map from pointers to these
+// values to their handles in |value_to_handle_|, which uses |PointerHashT| and
+// |PointerEqualsT|.
 //
-// |parent_| and |children_| encode the equivalence relation, i.e., the trees.
+// |parent_|, |size_| and |next_| encode the equivalence relation, i.e., the
+// trees and the circular member lists.
 template <typename T, typename PointerHashT, typename PointerEqualsT>
 class EquivalenceRelation {
  public:
+  EquivalenceRelation() = default;
+
+  // Deep-copies |other|.  The copy owns fresh copies of all values, and
+  // preserves both the order in which values were registered (so that
+  // |GetAllKnownValues| returns corresponding values in corresponding
+  // positions) and the shape of the union-find trees.
+  EquivalenceRelation(const EquivalenceRelation& other)
+      : parent_(other.parent_), size_(other.size_), next_(other.next_) {
+    for (auto& value : other.owned_values_) {
+      auto unique_pointer_to_value = MakeUnique<T>(*value);
+      value_to_handle_[unique_pointer_to_value.get()] =
+          static_cast<uint32_t>(owned_values_.size());
+      owned_values_.push_back(std::move(unique_pointer_to_value));
+    }
+  }
+
+  EquivalenceRelation& operator=(const EquivalenceRelation&) = delete;
+
   // Requires that |value1| and |value2| are already registered in the
   // equivalence relation.  Merges the equivalence classes associated with
   // |value1| and |value2|.
@@ -79,26 +105,25 @@ class EquivalenceRelation {
     assert(Exists(value2) &&
            "Precondition: value2 must already be registered.");
 
-    // Look up canonical pointers to each of the values in the value pool.
-    const T* value1_ptr = *value_set_.find(&value1);
-    const T* value2_ptr = *value_set_.find(&value2);
-
-    // If the values turn out to be identical, they are already in the same
-    // equivalence class so there is nothing to do.
-    if (value1_ptr == value2_ptr) {
+    // Find the representative for each value's equivalence class.  If they
+    // are already in the same class there is nothing to do.
+    uint32_t representative1 = FindHandle(GetHandle(&value1));
+    uint32_t representative2 = FindHandle(GetHandle(&value2));
+    if (representative1 == representative2) {
       return;
     }
 
-    // Find the representative for each value's equivalence class, and if they
-    // are not already in the same class, make one the parent of the other.
-    const T* representative1 = Find(value1_ptr);
-    const T* representative2 = Find(value2_ptr);
-    assert(representative1 && "Representatives should never be null.");
-    assert(representative2 && "Representatives should never be null.");
-    if (representative1 != representative2) {
-      parent_[representative1] = representative2;
-      children_[representative2].push_back(representative1);
+    // Make the representative of the smaller class a child of the
+    // representative of the larger class.  When the classes have the same
+    // size, the representative of |value2|'s class is kept.
+    if (size_[representative1] > size_[representative2]) {
+      std::swap(representative1, representative2);
     }
+    parent_[representative1] = representative2;
+    size_[representative2] += size_[representative1];
+
+    // Splice the two circular member lists into one.
+    std::swap(next_[representative1], next_[representative2]);
   }
 
   // Requires that |value| is not known to the equivalence relation. Registers
@@ -110,14 +135,15 @@ class EquivalenceRelation {
     // This relies on T having a copy constructor.
     auto unique_pointer_to_value = MakeUnique<T>(value);
     auto pointer_to_value = unique_pointer_to_value.get();
+    auto handle = static_cast<uint32_t>(owned_values_.size());
     owned_values_.push_back(std::move(unique_pointer_to_value));
-    value_set_.insert(pointer_to_value);
+    value_to_handle_[pointer_to_value] = handle;
 
-    // Initially say that the value is its own parent and that it has no
-    // children.
-    assert(pointer_to_value && "Representatives should never be null.");
-    parent_[pointer_to_value] = pointer_to_value;
-    children_[pointer_to_value] = std::vector<const T*>();
+    // Initially say that the value is its own parent, and the only member of
+    // its class.
+    parent_.push_back(handle);
+    size_.push_back(1);
+    next_.push_back(handle);
 
     return pointer_to_value;
   }
@@ -125,47 +151,55 @@ class EquivalenceRelation {
   // Returns exactly one representative per equivalence class.
   std::vector<const T*> GetEquivalenceClassRepresentatives() const {
     std::vector<const T*> result;
-    for (auto& value : owned_values_) {
-      if (parent_[value.get()] == value.get()) {
-        result.push_back(value.get());
+    for (uint32_t handle = 0; handle < parent_.size(); handle++) {
+      if (parent_[handle] == handle) {
+        result.push_back(owned_values_[handle].get());
       }
     }
     return result;
   }
 
   // Returns pointers to all values in the equivalence class of |value|, which
-  // must already be part of the equivalence relation.
+  // must already be part of the equivalence relation.  The values come in the
+  // order of the member list, starting from the representative.  Fuzzer passes
+  // choose among synonyms in this order, so changing it changes what a given
+  // seed produces.
   std::vector<const T*> GetEquivalenceClass(const T& value) const {
     assert(Exists(value));
 
+    // Walk the circular member list, starting from the representative of the
+    // equivalence class to which |value| belongs.
+    const uint32_t representative = FindHandle(GetHandle(&value));
     std::vector<const T*> result;
-
-    // Traverse the tree of values rooted at the representative of the
-    // equivalence class to which |value| belongs, and collect up all the values
-    // that are encountered.  This constitutes the whole equivalence class.
-    std::vector<const T*> stack;
-    stack.push_back(Find(*value_set_.find(&value)));
-    while (!stack.empty()) {
-      const T* item = stack.back();
-      result.push_back(item);
-      stack.pop_back();
-      for (auto child : children_[item]) {
-        stack.push_back(child);
-      }
-    }
+    result.reserve(size_[representative]);
+    uint32_t handle = representative;
+    do {
+      result.push_back(owned_values_[handle].get());
+      handle = next_[handle];
+    } while (handle != representative);
+    assert(result.size() == size_[representative] &&
+           "The member list should contain every member of the class.");
     return result;
   }
 
+  // Returns the number of values in the equivalence class of |value|, which
+  // must already be part of the equivalence relation.
+  size_t GetEquivalenceClassSize(const T& value) const {
+    assert(Exists(value));
+    return size_[FindHandle(GetHandle(&value))];
+  }
+
   // Returns true if and only if |value1| and |value2| are in the same
   // equivalence class.  Both values must already be known to the equivalence
   // relation.
   bool IsEquivalent(const T& value1, const T& value2) const {
-    return Find(&value1) == Find(&value2);
+    return FindHandle(GetHandle(&value1)) == FindHandle(GetHandle(&value2));
   }
 
   // Returns all values known to be part of the equivalence relation.
   std::vector<const T*> GetAllKnownValues() const {
     std::vector<const T*> result;
+    result.reserve(owned_values_.size());
     for (auto& value : owned_values_) {
       result.push_back(value.get());
     }
@@ -175,7 +209,7 @@ class EquivalenceRelation {
   // Returns true if and only if |value| is known to be part of the equivalence
   // relation.
   bool Exists(const T& value) const {
-    return value_set_.find(&value) != value_set_.end();
+    return value_to_handle_.find(&value) != value_to_handle_.end();
   }
 
   // Returns the representative of the equivalence class of |value|, which must
@@ -183,61 +217,63 @@ class EquivalenceRelation {
   // in a classic union-find data structure.
   const T* Find(const T* value) const {
     assert(Exists(*value));
+    return owned_values_[FindHandle(GetHandle(value))].get();
+  }
 
-    // Get the canonical pointer to the value from the value pool.
-    const T* known_value = *value_set_.find(value);
-    assert(parent_[known_value] && "Every known value should have a parent.");
+ private:
+  // Returns the handle of |value|, which must already be known to the
+  // equivalence relation.
+  uint32_t GetHandle(const T* value) const {
+    auto entry = value_to_handle_.find(value);
+    assert(entry != value_to_handle_.end() &&
+           "The value should be known to the equivalence relation.");
+    return entry->second;
+  }
 
+  // Returns the handle of the representative of the equivalence class of the
+  // value with handle |handle|.
+  uint32_t FindHandle(uint32_t handle) const {
     // Compute the result by chasing parents until we find a value that is its
     // own parent.
-    const T* result = known_value;
+    uint32_t result = handle;
     while (parent_[result] != result) {
       result = parent_[result];
     }
-    assert(result && "Representatives should never be null.");
 
-    // At this point, |result| is the representative of the equivalence class.
     // Now perform the 'path compression' optimization by doing another pass up
-    // the parent chain, setting the parent of each node to be the
-    // representative, and rewriting children correspondingly.
-    const T* current = known_value;
-    while (parent_[current] != result) {
-      const T* next = parent_[current];
-      parent_[current] = result;
-      children_[result].push_back(current);
-      auto child_iterator =
-          std::find(children_[next].begin(), children_[next].end(), current);
-      assert(child_iterator != children_[next].end() &&
-             "'next' is the parent of 'current', so 'current' should be a "
-             "child of 'next'");
-      children_[next].erase(child_iterator);
-      current = next;
+    // the parent chain, setting the parent of each value to be the
+    // representative.  The member lists are unaffected.
+    while (parent_[handle] != result) {
+      const uint32_t next = parent_[handle];
+      parent_[handle] = result;
+      handle = next;
     }
     return result;
   }
 
- private:
-  // Maps every value to a parent.  The representative of an equivalence class
-  // is its own parent.  A value's representative can be found by walking its
-  // chain of ancestors.
+  // Maps the handle of every value to the handle of a parent.  The
+  // representative of an equivalence class is its own parent.  A value's
+  // representative can be found by walking its chain of ancestors.
   //
   // Mutable because the intuitively const method, 'Find', performs path
   // compression.
-  mutable std::unordered_map<const T*, const T*> parent_;
+  mutable std::vector<uint32_t> parent_;
 
-  // Stores the children of each value.  This allows the equivalence class of
-  // a value to be calculated by traversing all descendents of the class's
-  // representative.
-  //
-  // Mutable because the intuitively const method, 'Find', performs path
-  // compression.
-  mutable std::unordered_map<const T*, std::vector<const T*>> children_;
+  // For the handle of a representative, stores the size of its equivalence
+  // class.  Entries for other handles are stale.
+  std::vector<uint32_t> size_;
+
+  // Links the handles of the members of each equivalence class into a circular
+  // list.
+  std::vector<uint32_t> next_;
 
   // The values known to the equivalence relation are allocated in
-  // |owned_values_|, and |value_pool_| provides (via |PointerHashT| and
-  // |PointerEqualsT|) a means for mapping a value of interest to a pointer
-  // into an equivalent value in |owned_values_|.
-  std::unordered_set<const T*, PointerHashT, PointerEqualsT> value_set_;
+  // |owned_values_|, in registration order, so that a value's handle is its
+  // index.  |value_to_handle_| provides (via |PointerHashT| and
+  // |PointerEqualsT|) a means for mapping a value of interest to the handle of
+  // an equal value in |owned_values_|.
+  std::unordered_map<const T*, uint32_t, PointerHashT, PointerEqualsT>
+      value_to_handle_;
   std::vector<std::unique_ptr<T>> owned_values_;
 };
 
@@ -24,6 +24,11 @@ namespace fact_manager {
 ConstantUniformFacts::ConstantUniformFacts(opt::IRContext* ir_context)
     : ir_context_(ir_context) {}
 
+ConstantUniformFacts::ConstantUniformFacts(const ConstantUniformFacts& other,
+                                           opt::IRContext* ir_context)
+    : facts_and_type_ids_(other.facts_and_type_ids_),
+      ir_context_(ir_context) {}
+
 uint32_t ConstantUniformFacts::GetConstantId(
     const protobufs::FactConstantUniform& constant_uniform_fact,
     uint32_t type_id) const {
@@ -30,6 +30,11 @@ class ConstantUniformFacts {
  public:
   explicit ConstantUniformFacts(opt::IRContext* ir_context);
 
+  // Constructs a copy of |other| that refers to |ir_context|, which must be an
+  // identical copy of the module to which |other| refers.
+  ConstantUniformFacts(const ConstantUniformFacts& other,
+                       opt::IRContext* ir_context);
+
   // See method in FactManager which delegates to this method.
   bool MaybeAddFact(const protobufs::FactConstantUniform& fact);
 
@@ -14,6 +14,10 @@
 
 #include "source/fuzz/fact_manager/data_synonym_and_id_equation_facts.h"
 
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 #include "source/fuzz/fuzzer_util.h"
 
 namespace spvtools {
@@ -55,6 +59,38 @@ DataSynonymAndIdEquationFacts::DataSynonymAndIdEquationFacts(
     opt::IRContext* ir_context)
     : ir_context_(ir_context) {}
 
+DataSynonymAndIdEquationFacts::DataSynonymAndIdEquationFacts(
+    const DataSynonymAndIdEquationFacts& other, opt::IRContext* ir_context)
+    : synonymous_(other.synonymous_), ir_context_(ir_context) {
+  // Equations and changed classes refer to data descriptors via pointers into
+  // |synonymous_|, so they must be rewritten to point into the copied
+  // relation.  The copy preserves registration order, which gives the
+  // correspondence.
+  auto old_values = other.synonymous_.GetAllKnownValues();
+  auto new_values = synonymous_.GetAllKnownValues();
+  assert(old_values.size() == new_values.size() &&
+         "The copied relation should have the same values.");
+  std::unordered_map<const protobufs::DataDescriptor*,
+                     const protobufs::DataDescriptor*>
+      old_to_new;
+  for (size_t i = 0; i < old_values.size(); i++) {
+    old_to_new[old_values[i]] = new_values[i];
+  }
+  for (const auto& entry : other.id_equations_) {
+    auto& new_equations = id_equations_[old_to_new.at(entry.first)];
+    for (const auto& operation : entry.second) {
+      Operation new_operation = {operation.opcode, {}};
+      for (auto operand : operation.operands) {
+        new_operation.operands.push_back(old_to_new.at(operand));
+      }
+      new_equations.insert(new_operation);
+    }
+  }
+  for (auto dd : other.classes_changed_since_closure_) {
+    classes_changed_since_closure_.push_back(old_to_new.at(dd));
+  }
+}
+
 bool DataSynonymAndIdEquationFacts::MaybeAddFact(
     const protobufs::FactDataSynonym& fact,
     const DeadBlockFacts& dead_block_facts,
@@ -446,75 +482,49 @@ void DataSynonymAndIdEquationFacts::ComputeClosureOfFacts(
   // then we can conclude that:
   //   m[2] == v.
   //
-  // This method repeatedly searches the equivalence relation of data
-  // descriptors, deducing and adding such facts, until a pass over the
-  // relation leads to no further facts being deduced.
-
-  // The method relies on working with pairs of data descriptors, and in
-  // particular being able to hash and compare such pairs.
-
-  using DataDescriptorPair =
-      std::pair<protobufs::DataDescriptor, protobufs::DataDescriptor>;
-
-  struct DataDescriptorPairHash {
-    std::size_t operator()(const DataDescriptorPair& pair) const {
-      return DataDescriptorHash()(&pair.first) ^
-             DataDescriptorHash()(&pair.second);
-    }
-  };
-
-  struct DataDescriptorPairEquals {
-    bool operator()(const DataDescriptorPair& first,
-                    const DataDescriptorPair& second) const {
-      return (DataDescriptorEquals()(&first.first, &second.first) &&
-              DataDescriptorEquals()(&first.second, &second.second)) ||
-             (DataDescriptorEquals()(&first.first, &second.second) &&
-              DataDescriptorEquals()(&first.second, &second.first));
+  // Such a deduction can only become possible once the equivalence class of
+  // some obj_1[a_1, ..., a_m, i] has been merged with the class of
+  // obj_2[b_1, ..., b_n, i].  Each closure computation runs until no further
+  // facts can be deduced, so only classes that have been merged since the
+  // last closure computation - recorded in |classes_changed_since_closure_| -
+  // need to be searched.  When such a class contains a pair of data
+  // descriptors of the above form, the remaining components of their prefixes
+  // are looked up directly in the equivalence relation.
+  //
+  // This method repeatedly searches the changed classes, deducing and adding
+  // such facts, until no classes have changed since the last search.  Changed
+  // classes that could not be fully searched because of the size limit remain
+  // recorded as changed, so that a later closure computation with a larger
+  // limit searches them again.
+
+  std::vector<const protobufs::DataDescriptor*> classes_to_search_next_time;
+  while (!classes_changed_since_closure_.empty()) {
+    // Work out which classes to search during this pass.  Classes that change
+    // during the pass are searched during the next pass.
+    std::unordered_set<const protobufs::DataDescriptor*>
+        changed_representatives;
+    for (auto dd : classes_changed_since_closure_) {
+      changed_representatives.insert(synonymous_.Find(dd));
     }
-  };
+    classes_changed_since_closure_.clear();
 
-  // This map records, for a given pair of composite data descriptors of the
-  // same type, all the indices at which the data descriptors are known to be
-  // synonymous.  A pair is a key to this map only if we have observed that
-  // the pair are synonymous at *some* index, but not at *all* indices.
-  // Once we find that a pair of data descriptors are equivalent at all indices
-  // we record the fact that they are synonymous and remove them from the map.
-  //
-  // Using the m and v example from above, initially the pair (m[2], v) would
-  // not be a key to the map.  If we find that m[2, 2] == v[2] holds, we would
-  // add an entry:
-  //   (m[2], v) -> [false, false, true, false]
-  // to record that they are synonymous at index 2.  If we then find that
-  // m[2, 0] == v[0] holds, we would update this entry to:
-  //   (m[2], v) -> [true, false, true, false]
-  // If we then find that m[2, 3] == v[3] holds, we would update this entry to:
-  //   (m[2], v) -> [true, false, true, true]
-  // Finally, if we then find that m[2, 1] == v[1] holds, which would make the
-  // boolean vector true at every index, we would add the fact:
-  //   m[2] == v
-  // to the equivalence relation and remove (m[2], v) from the map.
-  std::unordered_map<DataDescriptorPair, std::vector<bool>,
-                     DataDescriptorPairHash, DataDescriptorPairEquals>
-      candidate_composite_synonyms;
-
-  // We keep looking for new facts until we perform a complete pass over the
-  // equivalence relation without finding any new facts.
-  while (closure_computation_required_) {
-    // We have not found any new facts yet during this pass; we set this to
-    // 'true' if we do find a new fact.
-    closure_computation_required_ = false;
-
-    // Consider each class in the equivalence relation.
+    // Consider each changed class, in the order in which the equivalence
+    // relation presents its representatives so that facts are deduced
+    // deterministically.
     for (auto representative :
          synonymous_.GetEquivalenceClassRepresentatives()) {
-      auto equivalence_class = synonymous_.GetEquivalenceClass(*representative);
-
-      if (equivalence_class.size() > maximum_equivalence_class_size) {
+      if (!changed_representatives.count(representative)) {
+        continue;
+      }
+      if (synonymous_.GetEquivalenceClassSize(*representative) >
+          maximum_equivalence_class_size) {
         // This equivalence class is larger than the maximum size we are willing
         // to consider, so we skip it.  This potentially leads to missed fact
         // deductions, but avoids excessive runtime for closure computation.
+        classes_to_search_next_time.push_back(representative);
         continue;
       }
+      auto equivalence_class = synonymous_.GetEquivalenceClass(*representative);
 
       // Consider every data descriptor in the equivalence class.
       for (auto dd1_it = equivalence_class.begin();
@@ -557,9 +567,9 @@ void DataSynonymAndIdEquationFacts::ComputeClosureOfFacts(
           //   obj_1[a_1, ..., a_m]
           // and
           //   obj_2[b_1, ..., b_n]
-          // These are the two data descriptors we might be getting closer to
-          // deducing as being synonymous, due to knowing that they are
-          // synonymous when extended by a particular index.
+          // These are the two data descriptors we might be able to deduce as
+          // being synonymous, due to knowing that they are synonymous when
+          // extended by a particular index.
           protobufs::DataDescriptor dd1_prefix;
           dd1_prefix.set_object(dd1->object());
           for (uint32_t i = 0; i < static_cast<uint32_t>(dd1->index_size() - 1);
@@ -648,41 +658,31 @@ void DataSynonymAndIdEquationFacts::ComputeClosureOfFacts(
                 composite_type->AsVector()->element_count();
           }
 
-          // We are one step closer to being able to say that |dd1_prefix| and
-          // |dd2_prefix| are synonymous.
-          DataDescriptorPair candidate_composite_synonym(dd1_prefix,
-                                                         dd2_prefix);
-
-          // We look up what we already know about this pair.
-          auto existing_entry =
-              candidate_composite_synonyms.find(candidate_composite_synonym);
-
-          if (existing_entry == candidate_composite_synonyms.end()) {
-            // If this is the first time we have seen the pair, we make a vector
-            // of size |num_components_in_composite| that is 'true' at the
-            // common final index associated with |dd1| and |dd2|, and 'false'
-            // everywhere else, and register this vector as being associated
-            // with the pair.
-            std::vector<bool> entry;
-            for (uint32_t i = 0; i < num_components_in_composite; i++) {
-              entry.push_back(i == common_final_index);
-            }
-            candidate_composite_synonyms[candidate_composite_synonym] = entry;
-            existing_entry =
-                candidate_composite_synonyms.find(candidate_composite_synonym);
-          } else {
-            // We have seen this pair of data descriptors before, and we now
-            // know that they are synonymous at one further index, so we
-            // update the entry to record that.
-            existing_entry->second[common_final_index] = true;
-          }
-          assert(existing_entry != candidate_composite_synonyms.end());
-
-          // Check whether |dd1_prefix| and |dd2_prefix| are now known to match
-          // at every sub-component.
+          // Check whether |dd1_prefix| and |dd2_prefix| are known to match at
+          // every sub-component, where each match must come from an
+          // equivalence class that is small enough to be considered.  We know
+          // that they match at |common_final_index|.
           bool all_components_match = true;
           for (uint32_t i = 0; i < num_components_in_composite; i++) {
-            if (!existing_entry->second[i]) {
+            if (i == common_final_index) {
+              continue;
+            }
+            protobufs::DataDescriptor dd1_component = dd1_prefix;
+            dd1_component.add_index(i);
+            protobufs::DataDescriptor dd2_component = dd2_prefix;
+            dd2_component.add_index(i);
+            if (!synonymous_.Exists(dd1_component) ||
+                !synonymous_.Exists(dd2_component) ||
+                !synonymous_.IsEquivalent(dd1_component, dd2_component)) {
+              all_components_match = false;
+              break;
+            }
+            if (synonymous_.GetEquivalenceClassSize(dd1_component) >
+                maximum_equivalence_class_size) {
+              // The match at this component comes from a class that is too
+              // large to be considered, so the deduction has to wait for a
+              // closure computation with a larger limit.
+              classes_to_search_next_time.push_back(representative);
               all_components_match = false;
               break;
             }
@@ -696,15 +696,12 @@ void DataSynonymAndIdEquationFacts::ComputeClosureOfFacts(
             assert(DataDescriptorsAreWellFormedAndComparable(dd1_prefix,
                                                              dd2_prefix));
             MakeEquivalent(dd1_prefix, dd2_prefix);
-            // Now that we know this pair of data descriptors are synonymous,
-            // there is no point recording how close they are to being
-            // synonymous.
-            candidate_composite_synonyms.erase(candidate_composite_synonym);
           }
         }
       }
     }
   }
+  classes_changed_since_closure_ = std::move(classes_to_search_next_time);
 }
 
 void DataSynonymAndIdEquationFacts::MakeEquivalent(
@@ -732,9 +729,9 @@ void DataSynonymAndIdEquationFacts::MakeEquivalent(
   // Make the data descriptors equivalent.
   synonymous_.MakeEquivalent(dd1, dd2);
   // As we have updated the equivalence relation, we might be able to deduce
-  // more facts by performing a closure computation, so we record that such a
-  // computation is required.
-  closure_computation_required_ = true;
+  // more facts by performing a closure computation, so we record that the
+  // merged class needs to be searched.
+  classes_changed_since_closure_.push_back(dd1_original_representative);
 
   // At this point, exactly one of |dd1_original_representative| and
   // |dd2_original_representative| will be the representative of the combined
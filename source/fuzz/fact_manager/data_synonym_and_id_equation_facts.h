@@ -38,6 +38,11 @@ class DataSynonymAndIdEquationFacts {
  public:
   explicit DataSynonymAndIdEquationFacts(opt::IRContext* ir_context);
 
+  // Constructs a copy of |other| that refers to |ir_context|, which must be an
+  // identical copy of the module to which |other| refers.
+  DataSynonymAndIdEquationFacts(const DataSynonymAndIdEquationFacts& other,
+                                opt::IRContext* ir_context);
+
   // See method in FactManager which delegates to this method. Returns true if
   // neither |fact.data1()| nor |fact.data2()| contain an
   // irrelevant id. Otherwise, returns false. |dead_block_facts| and
@@ -158,11 +163,14 @@ class DataSynonymAndIdEquationFacts {
 
   // When a new synonym fact is added, it may be possible to deduce further
   // synonym facts by computing a closure of all known facts.  However, this is
-  // an expensive operation, so it should be performed sparingly and only there
-  // is some chance of new facts being deduced.  This boolean tracks whether a
-  // closure computation is required - i.e., whether a new fact has been added
-  // since the last time such a computation was performed.
-  bool closure_computation_required_ = false;
+  // an expensive operation, so it should be performed sparingly and only on
+  // the equivalence classes where there is some chance of new facts being
+  // deduced.  This records a member of every class that has been merged with
+  // another class since the last time such a computation was performed, and
+  // of every class that the last computation could not fully search because
+  // of its size limit; a closure computation is required if and only if it is
+  // non-empty.
+  std::vector<const protobufs::DataDescriptor*> classes_changed_since_closure_;
 
   // Represents a set of equations on data descriptors as a map indexed by
   // left-hand-side, mapping a left-hand-side to a set of operations, each of
@@ -30,6 +30,10 @@ class DeadBlockFacts {
  public:
   explicit DeadBlockFacts(opt::IRContext* ir_context);
 
+  // Constructs a copy of |other| that refers to |ir_context|, which must be an
+  // identical copy of the module to which |other| refers.
+  DeadBlockFacts(const DeadBlockFacts& other, opt::IRContext* ir_context);
+
   // Marks |fact.block_id()| as being dead. Returns true if |fact.block_id()|
   // represents a result id of some OpLabel instruction in |ir_context_|.
   // Returns false otherwise.
@@ -94,6 +94,14 @@ FactManager::FactManager(opt::IRContext* ir_context)
       livesafe_function_facts_(ir_context),
       irrelevant_value_facts_(ir_context) {}
 
+FactManager::FactManager(const FactManager& other, opt::IRContext* ir_context)
+    : constant_uniform_facts_(other.constant_uniform_facts_, ir_context),
+      data_synonym_and_id_equation_facts_(
+          other.data_synonym_and_id_equation_facts_, ir_context),
+      dead_block_facts_(other.dead_block_facts_, ir_context),
+      livesafe_function_facts_(other.livesafe_function_facts_, ir_context),
+      irrelevant_value_facts_(other.irrelevant_value_facts_, ir_context) {}
+
 void FactManager::AddInitialFacts(const MessageConsumer& message_consumer,
                                   const protobufs::FactSequence& facts) {
   for (auto& fact : facts.fact()) {
@@ -44,6 +44,12 @@ class FactManager {
  public:
   explicit FactManager(opt::IRContext* ir_context);
 
+  // Constructs a copy of |other| that refers to |ir_context|, which must be an
+  // identical copy of the module to which |other| refers.  This allows the
+  // state of a fuzzing or replay process to be snapshotted together with a
+  // clone of its module.
+  FactManager(const FactManager& other, opt::IRContext* ir_context);
+
   // Adds all the facts from |facts|, checking them for validity with respect to
   // |ir_context_|. Warnings about invalid facts are communicated via
   // |message_consumer|; such facts are otherwise ignored.
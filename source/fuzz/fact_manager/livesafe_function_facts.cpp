@@ -23,6 +23,11 @@ namespace fact_manager {
 LivesafeFunctionFacts::LivesafeFunctionFacts(opt::IRContext* ir_context)
     : ir_context_(ir_context) {}
 
+LivesafeFunctionFacts::LivesafeFunctionFacts(const LivesafeFunctionFacts& other,
+                                             opt::IRContext* ir_context)
+    : livesafe_function_ids_(other.livesafe_function_ids_),
+      ir_context_(ir_context) {}
+
 bool LivesafeFunctionFacts::MaybeAddFact(
     const protobufs::FactFunctionIsLivesafe& fact) {
   if (!fuzzerutil::FindFunction(ir_context_, fact.function_id())) {
@@ -111,7 +111,8 @@ Fuzzer::Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
                RepeatedPassStrategy repeated_pass_strategy,
                bool validate_after_each_fuzzer_pass,
                spv_validator_options validator_options,
-               bool ignore_inapplicable_transformations /* = true */)
+               bool ignore_inapplicable_transformations /* = true */,
+               bool donors_are_valid /* = false */)
     : consumer_(std::move(consumer)),
       enable_all_passes_(enable_all_passes),
       validate_after_each_fuzzer_pass_(validate_after_each_fuzzer_pass),
@@ -174,8 +175,8 @@ Fuzzer::Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
         &pass_instances_);
     MaybeAddRepeatedPass<FuzzerPassConstructComposites>(&pass_instances_);
     MaybeAddRepeatedPass<FuzzerPassCopyObjects>(&pass_instances_);
-    MaybeAddRepeatedPass<FuzzerPassDonateModules>(&pass_instances_,
-                                                  donor_suppliers);
+    MaybeAddRepeatedPass<FuzzerPassDonateModules>(
+        &pass_instances_, donor_suppliers, donors_are_valid);
     MaybeAddRepeatedPass<FuzzerPassDuplicateRegionsWithSelections>(
         &pass_instances_);
     MaybeAddRepeatedPass<FuzzerPassExpandVectorReductions>(&pass_instances_);
@@ -227,7 +228,7 @@ Fuzzer::Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
       &pass_instances_, fuzzer_context_.get());
   repeated_pass_manager_ = RepeatedPassManager::Create(
       repeated_pass_strategy, fuzzer_context_.get(), &pass_instances_,
-      repeated_pass_recommender_.get());
+      repeated_pass_recommender_.get(), ir_context_.get());
 
   MaybeAddFinalPass<FuzzerPassAdjustBranchWeights>(&final_passes_);
   MaybeAddFinalPass<FuzzerPassAdjustFunctionControls>(&final_passes_);
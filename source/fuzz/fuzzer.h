@@ -55,6 +55,8 @@ class Fuzzer {
     bool is_changed;
   };
 
+  // If |donors_are_valid| holds, the modules provided by |donor_suppliers| are
+  // known to be valid, and are not validated again when they are supplied.
   Fuzzer(std::unique_ptr<opt::IRContext> ir_context,
          std::unique_ptr<TransformationContext> transformation_context,
          std::unique_ptr<FuzzerContext> fuzzer_context,
@@ -63,7 +65,8 @@ class Fuzzer {
          bool enable_all_passes, RepeatedPassStrategy repeated_pass_strategy,
          bool validate_after_each_fuzzer_pass,
          spv_validator_options validator_options,
-         bool ignore_inapplicable_transformations = true);
+         bool ignore_inapplicable_transformations = true,
+         bool donors_are_valid = false);
 
   // Disables copy/move constructor/assignment operations.
   Fuzzer(const Fuzzer&) = delete;
@@ -14,6 +14,7 @@
 
 #include "source/fuzz/fuzzer_pass_add_access_chains.h"
 
+#include "source/fuzz/available_instructions.h"
 #include "source/fuzz/fuzzer_util.h"
 #include "source/fuzz/transformation_access_chain.h"
 
@@ -29,10 +30,38 @@ FuzzerPassAddAccessChains::FuzzerPassAddAccessChains(
                  transformations, ignore_inapplicable_transformations) {}
 
 void FuzzerPassAddAccessChains::Apply() {
+  // Index the pointers that an access chain could be made from once, rather
+  // than searching for those available at each point where an access chain
+  // might be inserted.
+  AvailableInstructions available_pointers(
+      GetIRContext(),
+      [](opt::IRContext* context, opt::Instruction* instruction) -> bool {
+        if (!instruction->result_id() || !instruction->type_id()) {
+          // A pointer needs both a result and type id.
+          return false;
+        }
+        switch (instruction->opcode()) {
+          case SpvOpConstantNull:
+          case SpvOpUndef:
+            // Do not allow making an access chain from a null or undefined
+            // pointer.  (We can eliminate these cases before actually checking
+            // that the instruction is a pointer.)
+            return false;
+          default:
+            break;
+        }
+        // If the instruction has pointer type, we can legitimately make an
+        // access chain from it.
+        return context->get_def_use_mgr()
+                   ->GetDef(instruction->type_id())
+                   ->opcode() == SpvOpTypePointer;
+      });
+
   ForEachInstructionWithInstructionDescriptor(
-      [this](opt::Function* function, opt::BasicBlock* block,
-             opt::BasicBlock::iterator inst_it,
-             const protobufs::InstructionDescriptor& instruction_descriptor)
+      [this, &available_pointers](
+          opt::Function* /*unused*/, opt::BasicBlock* /*unused*/,
+          opt::BasicBlock::iterator inst_it,
+          const protobufs::InstructionDescriptor& instruction_descriptor)
           -> void {
         assert(inst_it->opcode() ==
                    instruction_descriptor.target_instruction_opcode() &&
@@ -54,32 +83,8 @@ void FuzzerPassAddAccessChains::Apply() {
 
         // Get all of the pointers that are currently in scope, excluding
         // explicitly null and undefined pointers.
-        std::vector<opt::Instruction*> relevant_pointer_instructions =
-            FindAvailableInstructions(
-                function, block, inst_it,
-                [](opt::IRContext* context,
-                   opt::Instruction* instruction) -> bool {
-                  if (!instruction->result_id() || !instruction->type_id()) {
-                    // A pointer needs both a result and type id.
-                    return false;
-                  }
-                  switch (instruction->opcode()) {
-                    case SpvOpConstantNull:
-                    case SpvOpUndef:
-                      // Do not allow making an access chain from a null or
-                      // undefined pointer.  (We can eliminate these cases
-                      // before actually checking that the instruction is a
-                      // pointer.)
-                      return false;
-                    default:
-                      break;
-                  }
-                  // If the instruction has pointer type, we can legitimately
-                  // make an access chain from it.
-                  return context->get_def_use_mgr()
-                             ->GetDef(instruction->type_id())
-                             ->opcode() == SpvOpTypePointer;
-                });
+        const auto relevant_pointer_instructions =
+            available_pointers.GetAvailableBeforeInstruction(&*inst_it);
 
         // At this point, |relevant_instructions| contains all the pointers
         // we might think of making an access chain from.
@@ -14,6 +14,7 @@
 
 #include "source/fuzz/fuzzer_pass_add_loads.h"
 
+#include "source/fuzz/available_instructions.h"
 #include "source/fuzz/fuzzer_util.h"
 #include "source/fuzz/transformation_load.h"
 
@@ -29,10 +30,34 @@ FuzzerPassAddLoads::FuzzerPassAddLoads(
                  transformations, ignore_inapplicable_transformations) {}
 
 void FuzzerPassAddLoads::Apply() {
+  // Index the pointers that could be loaded from once, rather than searching
+  // for those available at each point where a load might be inserted.
+  AvailableInstructions available_pointers(
+      GetIRContext(),
+      [](opt::IRContext* context, opt::Instruction* instruction) -> bool {
+        if (!instruction->result_id() || !instruction->type_id()) {
+          return false;
+        }
+        switch (instruction->opcode()) {
+          case SpvOpConstantNull:
+          case SpvOpUndef:
+            // Do not allow loading from a null or undefined pointer; this
+            // might be OK if the block is dead, but for now we conservatively
+            // avoid it.
+            return false;
+          default:
+            break;
+        }
+        return context->get_def_use_mgr()
+                   ->GetDef(instruction->type_id())
+                   ->opcode() == SpvOpTypePointer;
+      });
+
   ForEachInstructionWithInstructionDescriptor(
-      [this](opt::Function* function, opt::BasicBlock* block,
-             opt::BasicBlock::iterator inst_it,
-             const protobufs::InstructionDescriptor& instruction_descriptor)
+      [this, &available_pointers](
+          opt::Function* /*unused*/, opt::BasicBlock* /*unused*/,
+          opt::BasicBlock::iterator inst_it,
+          const protobufs::InstructionDescriptor& instruction_descriptor)
           -> void {
         assert(inst_it->opcode() ==
                    instruction_descriptor.target_instruction_opcode() &&
@@ -55,28 +80,8 @@ void FuzzerPassAddLoads::Apply() {
           return;
         }
 
-        std::vector<opt::Instruction*> relevant_instructions =
-            FindAvailableInstructions(
-                function, block, inst_it,
-                [](opt::IRContext* context,
-                   opt::Instruction* instruction) -> bool {
-                  if (!instruction->result_id() || !instruction->type_id()) {
-                    return false;
-                  }
-                  switch (instruction->opcode()) {
-                    case SpvOpConstantNull:
-                    case SpvOpUndef:
-                      // Do not allow loading from a null or undefined pointer;
-                      // this might be OK if the block is dead, but for now we
-                      // conservatively avoid it.
-                      return false;
-                    default:
-                      break;
-                  }
-                  return context->get_def_use_mgr()
-                             ->GetDef(instruction->type_id())
-                             ->opcode() == SpvOpTypePointer;
-                });
+        const auto relevant_instructions =
+            available_pointers.GetAvailableBeforeInstruction(&*inst_it);
 
         // At this point, |relevant_instructions| contains all the pointers
         // we might think of loading from.
@@ -14,6 +14,8 @@
 
 #include "source/fuzz/fuzzer_pass_apply_id_synonyms.h"
 
+#include <unordered_map>
+
 #include "source/fuzz/data_descriptor.h"
 #include "source/fuzz/fuzzer_util.h"
 #include "source/fuzz/id_use_descriptor.h"
@@ -40,9 +42,21 @@ void FuzzerPassApplyIdSynonyms::Apply() {
       GetFuzzerContext()
           ->GetMaximumEquivalenceClassSizeForDataSynonymFactClosure()));
 
+  // The type of each data descriptor considered so far.  The fact manager
+  // keeps the data descriptors it hands out alive, and their types cannot
+  // change, so each type is worked out once rather than for every use.
+  std::unordered_map<const protobufs::DataDescriptor*, uint32_t>
+      data_descriptor_types;
+
   for (auto id_with_known_synonyms : GetTransformationContext()
                                          ->GetFactManager()
                                          ->GetIdsForWhichSynonymsAreKnown()) {
+    const protobufs::DataDescriptor descriptor_for_this_id =
+        MakeDataDescriptor(id_with_known_synonyms, {});
+    const uint32_t type_of_this_id =
+        fuzzerutil::GetTypeId(GetIRContext(), id_with_known_synonyms);
+    assert(type_of_this_id && "Ids with known synonyms must have types.");
+
     // Gather up all uses of |id_with_known_synonym| as a regular id, and
     // subsequently iterate over these uses.  We use this separation because,
     // when considering a given use, we might apply a transformation that will
@@ -85,16 +99,21 @@ void FuzzerPassApplyIdSynonyms::Apply() {
       for (const auto* data_descriptor :
            GetTransformationContext()->GetFactManager()->GetSynonymsForId(
                id_with_known_synonyms)) {
-        protobufs::DataDescriptor descriptor_for_this_id =
-            MakeDataDescriptor(id_with_known_synonyms, {});
         if (DataDescriptorEquals()(data_descriptor, &descriptor_for_this_id)) {
           // Exclude the fact that the id is synonymous with itself.
           continue;
         }
 
-        if (DataDescriptorsHaveCompatibleTypes(
-                use_inst->opcode(), use_in_operand_index,
-                descriptor_for_this_id, *data_descriptor)) {
+        auto type_it = data_descriptor_types.find(data_descriptor);
+        if (type_it == data_descriptor_types.end()) {
+          type_it = data_descriptor_types
+                        .emplace(data_descriptor,
+                                 GetDataDescriptorType(*data_descriptor))
+                        .first;
+        }
+        if (fuzzerutil::TypesAreCompatible(GetIRContext(), use_inst->opcode(),
+                                           use_in_operand_index,
+                                           type_of_this_id, type_it->second)) {
           synonyms_to_try.push_back(data_descriptor);
         }
       }
@@ -181,25 +200,16 @@ void FuzzerPassApplyIdSynonyms::Apply() {
   }
 }
 
-bool FuzzerPassApplyIdSynonyms::DataDescriptorsHaveCompatibleTypes(
-    SpvOp opcode, uint32_t use_in_operand_index,
-    const protobufs::DataDescriptor& dd1,
-    const protobufs::DataDescriptor& dd2) {
-  auto base_object_type_id_1 =
-      fuzzerutil::GetTypeId(GetIRContext(), dd1.object());
-  auto base_object_type_id_2 =
-      fuzzerutil::GetTypeId(GetIRContext(), dd2.object());
-  assert(base_object_type_id_1 && base_object_type_id_2 &&
-         "Data descriptors are invalid");
-
-  auto type_id_1 = fuzzerutil::WalkCompositeTypeIndices(
-      GetIRContext(), base_object_type_id_1, dd1.index());
-  auto type_id_2 = fuzzerutil::WalkCompositeTypeIndices(
-      GetIRContext(), base_object_type_id_2, dd2.index());
-  assert(type_id_1 && type_id_2 && "Data descriptors have invalid types");
-
-  return fuzzerutil::TypesAreCompatible(
-      GetIRContext(), opcode, use_in_operand_index, type_id_1, type_id_2);
+uint32_t FuzzerPassApplyIdSynonyms::GetDataDescriptorType(
+    const protobufs::DataDescriptor& data_descriptor) {
+  auto base_object_type_id =
+      fuzzerutil::GetTypeId(GetIRContext(), data_descriptor.object());
+  assert(base_object_type_id && "Data descriptor is invalid");
+
+  auto type_id = fuzzerutil::WalkCompositeTypeIndices(
+      GetIRContext(), base_object_type_id, data_descriptor.index());
+  assert(type_id && "Data descriptor has an invalid type");
+  return type_id;
 }
 
 }  // namespace fuzz
@@ -34,14 +34,10 @@ class FuzzerPassApplyIdSynonyms : public FuzzerPass {
   void Apply() override;
 
  private:
-  // Returns true if uses of |dd1| can be replaced with |dd2| and vice-versa
-  // with respect to the type. Concretely, returns true if |dd1| and |dd2| have
-  // the same type or both |dd1| and |dd2| are either a numerical or a vector
-  // type of integral components with possibly different signedness.
-  bool DataDescriptorsHaveCompatibleTypes(SpvOp opcode,
-                                          uint32_t use_in_operand_index,
-                                          const protobufs::DataDescriptor& dd1,
-                                          const protobufs::DataDescriptor& dd2);
+  // Returns the id of the type of the object or sub-object that
+  // |data_descriptor| refers to.
+  uint32_t GetDataDescriptorType(
+      const protobufs::DataDescriptor& data_descriptor);
 };
 
 }  // namespace fuzz
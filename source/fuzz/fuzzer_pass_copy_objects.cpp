@@ -14,6 +14,7 @@
 
 #include "source/fuzz/fuzzer_pass_copy_objects.h"
 
+#include "source/fuzz/available_instructions.h"
 #include "source/fuzz/fuzzer_util.h"
 #include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
 #include "source/fuzz/transformation_add_synonym.h"
@@ -30,10 +31,22 @@ FuzzerPassCopyObjects::FuzzerPassCopyObjects(
                  transformations, ignore_inapplicable_transformations) {}
 
 void FuzzerPassCopyObjects::Apply() {
+  // Index the copyable instructions once, rather than searching for those
+  // available at each point where a copy might be inserted.  Copies added by
+  // this pass are not themselves candidates for copying.
+  AvailableInstructions copyable_instructions(
+      GetIRContext(),
+      [this](opt::IRContext* ir_context, opt::Instruction* inst) {
+        return TransformationAddSynonym::IsInstructionValid(
+            ir_context, *GetTransformationContext(), inst,
+            protobufs::TransformationAddSynonym::COPY_OBJECT);
+      });
+
   ForEachInstructionWithInstructionDescriptor(
-      [this](opt::Function* function, opt::BasicBlock* block,
-             opt::BasicBlock::iterator inst_it,
-             const protobufs::InstructionDescriptor& instruction_descriptor)
+      [this, &copyable_instructions](
+          opt::Function* /*unused*/, opt::BasicBlock* block,
+          opt::BasicBlock::iterator inst_it,
+          const protobufs::InstructionDescriptor& instruction_descriptor)
           -> void {
         assert(inst_it->opcode() ==
                    instruction_descriptor.target_instruction_opcode() &&
@@ -59,13 +72,8 @@ void FuzzerPassCopyObjects::Apply() {
           return;
         }
 
-        const auto relevant_instructions = FindAvailableInstructions(
-            function, block, inst_it,
-            [this](opt::IRContext* ir_context, opt::Instruction* inst) {
-              return TransformationAddSynonym::IsInstructionValid(
-                  ir_context, *GetTransformationContext(), inst,
-                  protobufs::TransformationAddSynonym::COPY_OBJECT);
-            });
+        const auto relevant_instructions =
+            copyable_instructions.GetAvailableBeforeInstruction(&*inst_it);
 
         // At this point, |relevant_instructions| contains all the instructions
         // we might think of copying.
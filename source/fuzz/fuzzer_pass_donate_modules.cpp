@@ -37,6 +37,7 @@
 #include "source/fuzz/transformation_add_type_pointer.h"
 #include "source/fuzz/transformation_add_type_struct.h"
 #include "source/fuzz/transformation_add_type_vector.h"
+#include "source/util/make_unique.h"
 
 namespace spvtools {
 namespace fuzz {
@@ -46,10 +47,13 @@ FuzzerPassDonateModules::FuzzerPassDonateModules(
     FuzzerContext* fuzzer_context,
     protobufs::TransformationSequence* transformations,
     bool ignore_inapplicable_transformations,
-    std::vector<fuzzerutil::ModuleSupplier> donor_suppliers)
+    std::vector<fuzzerutil::ModuleSupplier> donor_suppliers,
+    bool donors_are_valid)
     : FuzzerPass(ir_context, transformation_context, fuzzer_context,
                  transformations, ignore_inapplicable_transformations),
-      donor_suppliers_(std::move(donor_suppliers)) {}
+      donor_suppliers_(std::move(donor_suppliers)),
+      donor_modules_(donor_suppliers_.size()),
+      donors_are_valid_(donors_are_valid) {}
 
 void FuzzerPassDonateModules::Apply() {
   // If there are no donor suppliers, this fuzzer pass is a no-op.
@@ -61,14 +65,11 @@ void FuzzerPassDonateModules::Apply() {
   // donating modules.
   do {
     // Choose a donor supplier at random, and get the module that it provides.
-    std::unique_ptr<opt::IRContext> donor_ir_context = donor_suppliers_.at(
-        GetFuzzerContext()->RandomIndex(donor_suppliers_))();
-    assert(donor_ir_context != nullptr && "Supplying of donor failed");
-    assert(
-        fuzzerutil::IsValid(donor_ir_context.get(),
-                            GetTransformationContext()->GetValidatorOptions(),
-                            fuzzerutil::kSilentMessageConsumer) &&
-        "The donor module must be valid");
+    // Modules are supplied, validated and analysed only once, and then reused.
+    DonorModule* donor_module = GetDonorModule(
+        GetFuzzerContext()->RandomIndex(donor_suppliers_));
+    assert(donor_module != nullptr &&
+           "Supplying of donor failed, or the donor module is invalid");
     // Donate the supplied module.
     //
     // Randomly decide whether to make the module livesafe (see
@@ -77,13 +78,59 @@ void FuzzerPassDonateModules::Apply() {
     // functions cannot be transformed as if they were arbitrary dead code.
     bool make_livesafe = GetFuzzerContext()->ChoosePercentage(
         GetFuzzerContext()->ChanceOfMakingDonorLivesafe());
-    DonateSingleModule(donor_ir_context.get(), make_livesafe);
+    if (donor_module) {
+      DonateSingleModule(donor_module->ir_context.get(),
+                         donor_module->functions_in_topological_order,
+                         make_livesafe);
+    }
   } while (GetFuzzerContext()->ChoosePercentage(
       GetFuzzerContext()->GetChanceOfDonatingAdditionalModule()));
 }
 
+std::vector<opt::Function*>
+FuzzerPassDonateModules::GetFunctionsInTopologicalOrder(
+    opt::IRContext* donor_ir_context) {
+  std::vector<opt::Function*> result;
+  for (auto function_id :
+       CallGraph(donor_ir_context).GetFunctionsInTopologicalOrder()) {
+    auto function = fuzzerutil::FindFunction(donor_ir_context, function_id);
+    assert(function && "Function to be donated was not found.");
+    result.push_back(function);
+  }
+  return result;
+}
+
+FuzzerPassDonateModules::DonorModule* FuzzerPassDonateModules::GetDonorModule(
+    uint32_t index) {
+  auto& donor_module = donor_modules_.at(index);
+  if (!donor_module) {
+    donor_module = MakeUnique<DonorModule>();
+    donor_module->ir_context = donor_suppliers_.at(index)();
+    if (donor_module->ir_context && !donors_are_valid_ &&
+        !fuzzerutil::IsValid(donor_module->ir_context.get(),
+                             GetTransformationContext()->GetValidatorOptions(),
+                             fuzzerutil::kSilentMessageConsumer)) {
+      donor_module->ir_context = nullptr;
+    }
+    if (donor_module->ir_context) {
+      donor_module->functions_in_topological_order =
+          GetFunctionsInTopologicalOrder(donor_module->ir_context.get());
+    }
+  }
+  return donor_module->ir_context ? donor_module.get() : nullptr;
+}
+
 void FuzzerPassDonateModules::DonateSingleModule(
     opt::IRContext* donor_ir_context, bool make_livesafe) {
+  DonateSingleModule(donor_ir_context,
+                     GetFunctionsInTopologicalOrder(donor_ir_context),
+                     make_livesafe);
+}
+
+void FuzzerPassDonateModules::DonateSingleModule(
+    opt::IRContext* donor_ir_context,
+    const std::vector<opt::Function*>& functions_in_topological_order,
+    bool make_livesafe) {
   // Check that the donated module has capabilities, supported by the recipient
   // module.
   for (const auto& capability_inst : donor_ir_context->capabilities()) {
@@ -116,7 +163,8 @@ void FuzzerPassDonateModules::DonateSingleModule(
   HandleExternalInstructionImports(donor_ir_context,
                                    &original_id_to_donated_id);
   HandleTypesAndValues(donor_ir_context, &original_id_to_donated_id);
-  HandleFunctions(donor_ir_context, &original_id_to_donated_id, make_livesafe);
+  HandleFunctions(donor_ir_context, functions_in_topological_order,
+                  &original_id_to_donated_id, make_livesafe);
 
   // TODO(https://github.com/KhronosGroup/SPIRV-Tools/issues/3115) Handle some
   //  kinds of decoration.
@@ -593,29 +641,17 @@ void FuzzerPassDonateModules::HandleTypeOrValue(
 
 void FuzzerPassDonateModules::HandleFunctions(
     opt::IRContext* donor_ir_context,
+    const std::vector<opt::Function*>& functions_in_topological_order,
     std::map<uint32_t, uint32_t>* original_id_to_donated_id,
     bool make_livesafe) {
-  // Get the ids of functions in the donor module, topologically sorted
-  // according to the donor's call graph.
-  auto topological_order =
-      CallGraph(donor_ir_context).GetFunctionsInTopologicalOrder();
-
   // Donate the functions in reverse topological order.  This ensures that a
   // function gets donated before any function that depends on it.  This allows
   // donation of the functions to be separated into a number of transformations,
   // each adding one function, such that every prefix of transformations leaves
   // the module valid.
-  for (auto function_id = topological_order.rbegin();
-       function_id != topological_order.rend(); ++function_id) {
-    // Find the function to be donated.
-    opt::Function* function_to_donate = nullptr;
-    for (auto& function : *donor_ir_context->module()) {
-      if (function.result_id() == *function_id) {
-        function_to_donate = &function;
-        break;
-      }
-    }
-    assert(function_to_donate && "Function to be donated was not found.");
+  for (auto function = functions_in_topological_order.rbegin();
+       function != functions_in_topological_order.rend(); ++function) {
+    opt::Function* function_to_donate = *function;
 
     if (!original_id_to_donated_id->count(
             function_to_donate->DefInst().GetSingleWordInOperand(1))) {
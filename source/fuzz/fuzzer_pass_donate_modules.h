@@ -15,6 +15,7 @@
 #ifndef SOURCE_FUZZ_FUZZER_PASS_DONATE_MODULES_H_
 #define SOURCE_FUZZ_FUZZER_PASS_DONATE_MODULES_H_
 
+#include <memory>
 #include <vector>
 
 #include "source/fuzz/fuzzer_pass.h"
@@ -27,12 +28,16 @@ namespace fuzz {
 // being transformed.
 class FuzzerPassDonateModules : public FuzzerPass {
  public:
+  // If |donors_are_valid| holds, the modules provided by |donor_suppliers| are
+  // known to be valid, e.g. because they are built from binaries validated
+  // once and shared by several fuzzers, so they are not validated again.
   FuzzerPassDonateModules(
       opt::IRContext* ir_context, TransformationContext* transformation_context,
       FuzzerContext* fuzzer_context,
       protobufs::TransformationSequence* transformations,
       bool ignore_inapplicable_transformations,
-      std::vector<fuzzerutil::ModuleSupplier> donor_suppliers);
+      std::vector<fuzzerutil::ModuleSupplier> donor_suppliers,
+      bool donors_are_valid = false);
 
   void Apply() override;
 
@@ -43,6 +48,35 @@ class FuzzerPassDonateModules : public FuzzerPass {
   void DonateSingleModule(opt::IRContext* donor_ir_context, bool make_livesafe);
 
  private:
+  // A donor module, together with information about it that does not depend
+  // on the module into which it is donated.  Donation only reads the donor
+  // module, so one parsed, validated copy serves every donation.
+  struct DonorModule {
+    std::unique_ptr<opt::IRContext> ir_context;
+
+    // The donor's functions, topologically sorted according to its call
+    // graph.
+    std::vector<opt::Function*> functions_in_topological_order;
+  };
+
+  // Returns the functions of |donor_ir_context|, topologically sorted
+  // according to its call graph.
+  static std::vector<opt::Function*> GetFunctionsInTopologicalOrder(
+      opt::IRContext* donor_ir_context);
+
+  // Returns the donor module provided by the supplier at |index|.  The
+  // supplier is invoked, and the module it supplies is validated and analysed,
+  // the first time this happens; the result is cached for later donations.
+  // Returns nullptr if the supplier failed or supplied an invalid module.
+  DonorModule* GetDonorModule(uint32_t index);
+
+  // Helper for the public DonateSingleModule method, which additionally
+  // requires the functions of |donor_ir_context| in topological order.
+  void DonateSingleModule(
+      opt::IRContext* donor_ir_context,
+      const std::vector<opt::Function*>& functions_in_topological_order,
+      bool make_livesafe);
+
   // Adapts a storage class coming from a donor module so that it will work
   // in a recipient module, e.g. by changing Uniform to Private.
   static SpvStorageClass AdaptStorageClass(SpvStorageClass donor_storage_class);
@@ -77,9 +111,14 @@ class FuzzerPassDonateModules : public FuzzerPass {
   // remap ids.  The |make_livesafe| argument captures whether the functions in
   // the module are required to be made livesafe before being added to the
   // recipient.
-  void HandleFunctions(opt::IRContext* donor_ir_context,
-                       std::map<uint32_t, uint32_t>* original_id_to_donated_id,
-                       bool make_livesafe);
+  //
+  // |functions_in_topological_order| must contain the functions of
+  // |donor_ir_context| in topological order.
+  void HandleFunctions(
+      opt::IRContext* donor_ir_context,
+      const std::vector<opt::Function*>& functions_in_topological_order,
+      std::map<uint32_t, uint32_t>* original_id_to_donated_id,
+      bool make_livesafe);
 
   // During donation we will have to ignore some instructions, e.g. because they
   // use opcodes that we cannot support or because they reference the ids of
@@ -155,6 +194,15 @@ class FuzzerPassDonateModules : public FuzzerPass {
 
   // Functions that supply SPIR-V modules
   std::vector<fuzzerutil::ModuleSupplier> donor_suppliers_;
+
+  // Donor modules that have already been supplied, indexed like
+  // |donor_suppliers_|; an entry is null until the corresponding supplier has
+  // been invoked.  Entries whose supplier failed, or supplied an invalid
+  // module, have a null IR context.
+  std::vector<std::unique_ptr<DonorModule>> donor_modules_;
+
+  // True if the modules provided by |donor_suppliers_| need not be validated.
+  const bool donors_are_valid_;
 };
 
 }  // namespace fuzz
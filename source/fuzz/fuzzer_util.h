@@ -175,7 +175,8 @@ SpvMemorySemanticsMask GetMemorySemanticsForStorageClass(
 
 // Returns true if and only if |context| is valid, according to the validator
 // instantiated with |validator_options|.  |consumer| is used for error
-// reporting.
+// reporting.  The module is serialized to a binary, which the validator then
+// parses, so this costs as much as validating the binary.
 bool IsValid(const opt::IRContext* context,
              spv_validator_options validator_options, MessageConsumer consumer);
 
@@ -14,6 +14,7 @@
 
 #include "source/fuzz/pass_management/repeated_pass_manager.h"
 
+#include "source/fuzz/pass_management/repeated_pass_manager_coverage_guided.h"
 #include "source/fuzz/pass_management/repeated_pass_manager_looped_with_recommendations.h"
 #include "source/fuzz/pass_management/repeated_pass_manager_random_with_recommendations.h"
 #include "source/fuzz/pass_management/repeated_pass_manager_simple.h"
@@ -30,7 +31,7 @@ RepeatedPassManager::~RepeatedPassManager() = default;
 std::unique_ptr<RepeatedPassManager> RepeatedPassManager::Create(
     RepeatedPassStrategy strategy, FuzzerContext* fuzzer_context,
     RepeatedPassInstances* pass_instances,
-    RepeatedPassRecommender* pass_recommender) {
+    RepeatedPassRecommender* pass_recommender, opt::IRContext* ir_context) {
   switch (strategy) {
     case RepeatedPassStrategy::kSimple:
       return MakeUnique<RepeatedPassManagerSimple>(fuzzer_context,
@@ -41,6 +42,9 @@ std::unique_ptr<RepeatedPassManager> RepeatedPassManager::Create(
     case RepeatedPassStrategy::kRandomWithRecommendations:
       return MakeUnique<RepeatedPassManagerRandomWithRecommendations>(
           fuzzer_context, pass_instances, pass_recommender);
+    case RepeatedPassStrategy::kCoverageGuided:
+      return MakeUnique<RepeatedPassManagerCoverageGuided>(
+          fuzzer_context, pass_instances, ir_context);
   }
 
   assert(false && "Unreachable");
@@ -22,6 +22,12 @@
 #include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
 
 namespace spvtools {
+namespace opt {
+
+class IRContext;
+
+}  // namespace opt
+
 namespace fuzz {
 
 // Each field of this enum corresponds to an available repeated pass
@@ -30,7 +36,8 @@ namespace fuzz {
 enum class RepeatedPassStrategy {
   kSimple,
   kRandomWithRecommendations,
-  kLoopedWithRecommendations
+  kLoopedWithRecommendations,
+  kCoverageGuided
 };
 
 // An interface to encapsulate the manner in which the sequence of repeated
@@ -51,10 +58,12 @@ class RepeatedPassManager {
       const protobufs::TransformationSequence& applied_transformations) = 0;
 
   // Creates a corresponding RepeatedPassManager based on the |strategy|.
+  // |ir_context| is the module being fuzzed; it is only used by strategies
+  // that inspect the module itself.
   static std::unique_ptr<RepeatedPassManager> Create(
       RepeatedPassStrategy strategy, FuzzerContext* fuzzer_context,
       RepeatedPassInstances* pass_instances,
-      RepeatedPassRecommender* pass_recommender);
+      RepeatedPassRecommender* pass_recommender, opt::IRContext* ir_context);
 
  protected:
   FuzzerContext* GetFuzzerContext() { return fuzzer_context_; }
@@ -0,0 +1,136 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/fuzz/pass_management/repeated_pass_manager_coverage_guided.h"
+
+#include <algorithm>
+
+#include "source/opt/ir_context.h"
+#include "source/util/coverage_counters.h"
+#include "spirv-tools/libspirv.hpp"
+#include "spirv-tools/optimizer.hpp"
+
+namespace spvtools {
+namespace fuzz {
+namespace {
+
+// The credit of a pass is capped when weighting the choice of passes, so that
+// a single burst of new coverage does not make one pass dominate.
+const uint32_t kMaxCreditForWeighting = 15;
+
+}  // namespace
+
+RepeatedPassManagerCoverageGuided::RepeatedPassManagerCoverageGuided(
+    FuzzerContext* fuzzer_context, RepeatedPassInstances* pass_instances,
+    opt::IRContext* ir_context)
+    : RepeatedPassManager(fuzzer_context, pass_instances),
+      ir_context_(ir_context),
+      credits_(pass_instances->GetPasses().size(), 0),
+      num_transformations_applied_before_last_pass_choice_(0),
+      last_pass_choice_index_(0),
+      pass_chosen_(false) {}
+
+RepeatedPassManagerCoverageGuided::~RepeatedPassManagerCoverageGuided() =
+    default;
+
+FuzzerPass* RepeatedPassManagerCoverageGuided::ChoosePass(
+    const protobufs::TransformationSequence& applied_transformations) {
+  const auto num_transformations_applied =
+      static_cast<uint32_t>(applied_transformations.transformation_size());
+  assert(num_transformations_applied >=
+             num_transformations_applied_before_last_pass_choice_ &&
+         "The number of applied transformations should not decrease.");
+  if (!pass_chosen_) {
+    // Establish the coverage achieved by the original module, so that passes
+    // are only credited with coverage that they lead to.
+    MeasureNewCoverage();
+  } else if (num_transformations_applied >
+             num_transformations_applied_before_last_pass_choice_) {
+    // The last pass had some effect, so credit it with any new coverage.
+    credits_[last_pass_choice_index_] += MeasureNewCoverage();
+  }
+  num_transformations_applied_before_last_pass_choice_ =
+      num_transformations_applied;
+
+  auto& passes = GetPassInstances()->GetPasses();
+  uint32_t result;
+  if (GetFuzzerContext()->ChooseEven()) {
+    result = GetFuzzerContext()->RandomIndex(passes);
+  } else {
+    // Choose a pass with probability proportional to one plus its capped
+    // credit, by choosing uniformly from a sequence in which each pass index
+    // is repeated that many times.
+    std::vector<uint32_t> weighted_pass_indices;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(passes.size()); i++) {
+      const uint32_t weight =
+          1 + std::min(credits_[i], kMaxCreditForWeighting);
+      weighted_pass_indices.insert(weighted_pass_indices.end(), weight, i);
+    }
+    result = weighted_pass_indices[GetFuzzerContext()->RandomIndex(
+        weighted_pass_indices)];
+  }
+  last_pass_choice_index_ = result;
+  pass_chosen_ = true;
+  return passes[result].get();
+}
+
+uint32_t RepeatedPassManagerCoverageGuided::MeasureNewCoverage() {
+  if (!utils::CoverageCounters::Enabled()) {
+    // No coverage point can ever be hit, so there is no point in running the
+    // tools.
+    return 0;
+  }
+
+  // Only the coverage points hit by this thread while measuring are
+  // considered, so that the measurement does not depend on what other fuzzers
+  // in the process have covered.
+  utils::CoverageRecorder recorder;
+
+  std::vector<uint32_t> binary;
+  ir_context_->module()->ToBinary(&binary, false);
+  const auto target_env = ir_context_->grammar().target_env();
+  auto ignore_messages = [](spv_message_level_t, const char*,
+                            const spv_position_t&, const char*) {};
+
+  SpirvTools tools(target_env);
+  tools.SetMessageConsumer(ignore_messages);
+  if (tools.Validate(binary)) {
+    // The optimizer requires a valid module; it has just been validated, so
+    // the optimizer need not validate it again.
+    Optimizer optimizer(target_env);
+    optimizer.SetMessageConsumer(ignore_messages);
+    optimizer.RegisterPerformancePasses();
+    OptimizerOptions optimizer_options;
+    optimizer_options.set_run_validator(false);
+    std::vector<uint32_t> optimized_binary;
+    optimizer.Run(binary.data(), binary.size(), &optimized_binary,
+                  optimizer_options);
+  }
+
+  const uint32_t num_points = recorder.GetNumPoints();
+  if (covered_points_.size() < num_points) {
+    covered_points_.resize(num_points, false);
+  }
+  uint32_t result = 0;
+  for (uint32_t i = 0; i < num_points; i++) {
+    if (recorder.WasHit(i) && !covered_points_[i]) {
+      covered_points_[i] = true;
+      result++;
+    }
+  }
+  return result;
+}
+
+}  // namespace fuzz
+}  // namespace spvtools
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_FUZZ_REPEATED_PASS_MANAGER_COVERAGE_GUIDED_H_
+#define SOURCE_FUZZ_REPEATED_PASS_MANAGER_COVERAGE_GUIDED_H_
+
+#include <vector>
+
+#include "source/fuzz/pass_management/repeated_pass_manager.h"
+
+namespace spvtools {
+namespace opt {
+
+class IRContext;
+
+}  // namespace opt
+
+namespace fuzz {
+
+// This repeated pass manager biases the choice of passes towards those that
+// have led the optimizer and validator to exercise code they had not
+// exercised before.
+//
+// Each time a fuzzer pass is requested, if the previously-chosen pass applied
+// some transformations, the module being fuzzed is validated and optimized
+// in-process, and the number of coverage points (see
+// source/util/coverage_counters.h) that are hit for the first time is credited
+// to that pass.  The manager then either selects an enabled pass uniformly at
+// random, or selects a pass with probability proportional to one plus its
+// (capped) credit; the decision of which of these methods to use is made
+// randomly each time ChoosePass is called.
+//
+// Coverage points are only hit if SPIRV-Tools was built with
+// SPIRV_ENABLE_COVERAGE_COUNTERS; otherwise no pass gains credit and this
+// manager selects passes as RepeatedPassManagerSimple does.  Coverage is
+// recorded per measurement on the fuzzing thread, so the choices made for a
+// seed do not depend on the seeds fuzzed before it or alongside it in the same
+// process.
+class RepeatedPassManagerCoverageGuided : public RepeatedPassManager {
+ public:
+  RepeatedPassManagerCoverageGuided(FuzzerContext* fuzzer_context,
+                                    RepeatedPassInstances* pass_instances,
+                                    opt::IRContext* ir_context);
+
+  ~RepeatedPassManagerCoverageGuided() override;
+
+  FuzzerPass* ChoosePass(const protobufs::TransformationSequence&
+                             applied_transformations) override;
+
+ private:
+  // Runs the validator and the optimizer on |ir_context_|, and returns the
+  // number of coverage points they hit that none of the previous measurements
+  // of this manager hit.
+  uint32_t MeasureNewCoverage();
+
+  // The module being fuzzed.
+  opt::IRContext* ir_context_;
+
+  // For each coverage point, records whether this manager has seen it hit.
+  std::vector<bool> covered_points_;
+
+  // For each repeated pass, the number of coverage points first hit after the
+  // pass was run, indexed in the same way as the repeated pass instances.
+  std::vector<uint32_t> credits_;
+
+  // Used to detect when chosen passes have had no effect, so that coverage is
+  // not measured needlessly.
+  uint32_t num_transformations_applied_before_last_pass_choice_;
+
+  // The index of the pass returned last time ChoosePass() was called; only
+  // meaningful if |pass_chosen_| holds.
+  uint32_t last_pass_choice_index_;
+
+  // True if and only if ChoosePass() has been called.
+  bool pass_chosen_;
+};
+
+}  // namespace fuzz
+}  // namespace spvtools
+
+#endif  // SOURCE_FUZZ_REPEATED_PASS_MANAGER_COVERAGE_GUIDED_H_
@@ -20,22 +20,75 @@
 
 #include "source/fuzz/counter_overflow_id_source.h"
 #include "source/fuzz/fact_manager/fact_manager.h"
+#include "source/fuzz/fuzzer_util.h"
 #include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
 #include "source/fuzz/transformation.h"
 #include "source/fuzz/transformation_context.h"
 #include "source/opt/build_module.h"
+#include "source/spirv_constant.h"
 #include "source/util/make_unique.h"
 
 namespace spvtools {
 namespace fuzz {
 
+ReplayCheckpointCache::ReplayCheckpointCache(uint32_t interval)
+    : interval_(interval), num_transformations_skipped_(0) {
+  assert(interval_ > 0 && "The checkpoint interval must be positive.");
+}
+
+ReplayCheckpointCache::~ReplayCheckpointCache() = default;
+
+uint32_t ReplayCheckpointCache::GetNumCheckpoints() const {
+  return static_cast<uint32_t>(checkpoints_.size());
+}
+
+uint64_t ReplayCheckpointCache::GetNumTransformationsSkipped() const {
+  return num_transformations_skipped_;
+}
+
+void ReplayCheckpointCache::ResetIfInputsDiffer(
+    const std::vector<uint32_t>& binary_in,
+    const protobufs::FactSequence& initial_facts) {
+  std::string serialized_facts = initial_facts.SerializeAsString();
+  if (binary_in == binary_in_ && serialized_facts == initial_facts_) {
+    return;
+  }
+  binary_in_ = binary_in;
+  initial_facts_ = std::move(serialized_facts);
+  TruncateTo(0);
+}
+
+uint32_t ReplayCheckpointCache::GetCommonPrefixLength(
+    const protobufs::TransformationSequence& sequence, uint32_t limit) const {
+  limit = std::min(limit, static_cast<uint32_t>(transformations_.size()));
+  uint32_t result = 0;
+  while (result < limit &&
+         sequence.transformation(static_cast<int>(result))
+                 .SerializeAsString() == transformations_[result]) {
+    result++;
+  }
+  return result;
+}
+
+void ReplayCheckpointCache::TruncateTo(uint32_t prefix_length) {
+  while (!checkpoints_.empty() &&
+         checkpoints_.back().num_transformations_considered > prefix_length) {
+    checkpoints_.pop_back();
+  }
+  if (transformations_.size() > prefix_length) {
+    transformations_.resize(prefix_length);
+    applied_.resize(prefix_length);
+  }
+}
+
 Replayer::Replayer(
     spv_target_env target_env, MessageConsumer consumer,
     const std::vector<uint32_t>& binary_in,
     const protobufs::FactSequence& initial_facts,
     const protobufs::TransformationSequence& transformation_sequence_in,
     uint32_t num_transformations_to_apply, bool validate_during_replay,
-    spv_validator_options validator_options)
+    spv_validator_options validator_options,
+    ReplayCheckpointCache* checkpoint_cache)
     : target_env_(target_env),
       consumer_(std::move(consumer)),
       binary_in_(binary_in),
@@ -43,7 +96,8 @@ Replayer::Replayer(
       transformation_sequence_in_(transformation_sequence_in),
       num_transformations_to_apply_(num_transformations_to_apply),
       validate_during_replay_(validate_during_replay),
-      validator_options_(validator_options) {}
+      validator_options_(validator_options),
+      checkpoint_cache_(checkpoint_cache) {}
 
 Replayer::~Replayer() = default;
 
@@ -78,23 +132,11 @@ Replayer::ReplayerResult Replayer::Run() {
             nullptr, protobufs::TransformationSequence()};
   }
 
-  // Build the module from the input binary.
-  std::unique_ptr<opt::IRContext> ir_context =
-      BuildModule(target_env_, consumer_, binary_in_.data(), binary_in_.size());
-  assert(ir_context);
-
-  // For replay validation, we track the last valid SPIR-V binary that was
-  // observed. Initially this is the input binary.
-  std::vector<uint32_t> last_valid_binary;
-  if (validate_during_replay_) {
-    last_valid_binary = binary_in_;
-  }
-
   // We find the smallest id that is (a) not in use by the original module, and
   // (b) not used by any transformation in the sequence to be replayed.  This
   // serves as a starting id from which to issue overflow ids if they are
   // required during replay.
-  uint32_t first_overflow_id = ir_context->module()->id_bound();
+  uint32_t first_overflow_id = binary_in_[SPV_INDEX_BOUND];
   for (auto& transformation : transformation_sequence_in_.transformation()) {
     auto fresh_ids = Transformation::FromMessage(transformation)->GetFreshIds();
     if (!fresh_ids.empty()) {
@@ -104,33 +146,87 @@ Replayer::ReplayerResult Replayer::Run() {
     }
   }
 
-  std::unique_ptr<TransformationContext> transformation_context =
-      MakeUnique<TransformationContext>(
-          MakeUnique<FactManager>(ir_context.get()), validator_options_,
-          MakeUnique<CounterOverflowIdSource>(first_overflow_id));
-  transformation_context->GetFactManager()->AddInitialFacts(consumer_,
-                                                            initial_facts_);
-
-  // We track the largest id bound observed, to ensure that it only increases
-  // as transformations are applied.
-  uint32_t max_observed_id_bound = ir_context->module()->id_bound();
-  (void)(max_observed_id_bound);  // Keep release-mode compilers happy.
-
+  std::unique_ptr<opt::IRContext> ir_context;
+  std::unique_ptr<TransformationContext> transformation_context;
   protobufs::TransformationSequence transformation_sequence_out;
 
-  // Consider the transformation proto messages in turn.
+  // The number of transformations from the input sequence that have been
+  // considered for application so far.
   uint32_t counter = 0;
-  for (auto& message : transformation_sequence_in_.transformation()) {
-    if (counter >= num_transformations_to_apply_) {
+
+  if (checkpoint_cache_) {
+    checkpoint_cache_->ResetIfInputsDiffer(binary_in_, initial_facts_);
+    uint32_t prefix_length = checkpoint_cache_->GetCommonPrefixLength(
+        transformation_sequence_in_, num_transformations_to_apply_);
+    checkpoint_cache_->TruncateTo(prefix_length);
+
+    // Look for the latest snapshot that is compatible with the overflow ids
+    // that this replay will issue.
+    for (auto it = checkpoint_cache_->checkpoints_.rbegin();
+         it != checkpoint_cache_->checkpoints_.rend(); ++it) {
+      if (it->num_overflow_ids_issued > 0 &&
+          it->first_overflow_id != first_overflow_id) {
+        continue;
+      }
+      ir_context = fuzzerutil::CloneIRContext(it->ir_context.get());
+      auto overflow_id_source =
+          MakeUnique<CounterOverflowIdSource>(first_overflow_id);
+      for (uint32_t i = 0; i < it->num_overflow_ids_issued; i++) {
+        overflow_id_source->GetNextOverflowId();
+      }
+      transformation_context = MakeUnique<TransformationContext>(
+          MakeUnique<FactManager>(*it->fact_manager, ir_context.get()),
+          validator_options_, std::move(overflow_id_source));
+      counter = it->num_transformations_considered;
+      for (uint32_t i = 0; i < counter; i++) {
+        if (checkpoint_cache_->applied_[i]) {
+          *transformation_sequence_out.add_transformation() =
+              transformation_sequence_in_.transformation(static_cast<int>(i));
+        }
+      }
+      checkpoint_cache_->num_transformations_skipped_ += counter;
       break;
     }
-    counter++;
 
+    // Whatever is considered from this point on replaces what the cache knows
+    // about transformations after the resumption point.
+    checkpoint_cache_->TruncateTo(counter);
+  }
+
+  if (!ir_context) {
+    // Build the module from the input binary.
+    ir_context = BuildModule(target_env_, consumer_, binary_in_.data(),
+                             binary_in_.size());
+    assert(ir_context);
+    transformation_context = MakeUnique<TransformationContext>(
+        MakeUnique<FactManager>(ir_context.get()), validator_options_,
+        MakeUnique<CounterOverflowIdSource>(first_overflow_id));
+    transformation_context->GetFactManager()->AddInitialFacts(consumer_,
+                                                              initial_facts_);
+  }
+
+  // For replay validation, we track the last valid SPIR-V binary that was
+  // observed. Initially this is the binary from which replay starts.
+  std::vector<uint32_t> last_valid_binary;
+  if (validate_during_replay_) {
+    ir_context->module()->ToBinary(&last_valid_binary, false);
+  }
+
+  // We track the largest id bound observed, to ensure that it only increases
+  // as transformations are applied.
+  uint32_t max_observed_id_bound = ir_context->module()->id_bound();
+  (void)(max_observed_id_bound);  // Keep release-mode compilers happy.
+
+  // Consider the remaining transformation proto messages in turn.
+  for (; counter < num_transformations_to_apply_; counter++) {
+    const auto& message =
+        transformation_sequence_in_.transformation(static_cast<int>(counter));
     auto transformation = Transformation::FromMessage(message);
 
     // Check whether the transformation can be applied.
-    if (transformation->IsApplicable(ir_context.get(),
-                                     *transformation_context)) {
+    bool applicable =
+        transformation->IsApplicable(ir_context.get(), *transformation_context);
+    if (applicable) {
       // The transformation is applicable, so apply it, and copy it to the
       // sequence of transformations that were applied.
       transformation->Apply(ir_context.get(), transformation_context.get());
@@ -159,6 +255,23 @@ Replayer::ReplayerResult Replayer::Run() {
         last_valid_binary = std::move(binary_to_validate);
       }
     }
+
+    if (checkpoint_cache_) {
+      checkpoint_cache_->transformations_.push_back(
+          message.SerializeAsString());
+      checkpoint_cache_->applied_.push_back(applicable);
+      if ((counter + 1) % checkpoint_cache_->interval_ == 0) {
+        auto snapshot = fuzzerutil::CloneIRContext(ir_context.get());
+        auto fact_manager = MakeUnique<FactManager>(
+            *transformation_context->GetFactManager(), snapshot.get());
+        checkpoint_cache_->checkpoints_.push_back(
+            {counter + 1, std::move(snapshot), std::move(fact_manager),
+             first_overflow_id,
+             static_cast<uint32_t>(transformation_context->GetOverflowIdSource()
+                                       ->GetIssuedOverflowIds()
+                                       .size())});
+      }
+    }
   }
 
   return {Replayer::ReplayerResultStatus::kComplete, std::move(ir_context),
@@ -16,8 +16,10 @@
 #define SOURCE_FUZZ_REPLAYER_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "source/fuzz/fact_manager/fact_manager.h"
 #include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
 #include "source/fuzz/transformation_context.h"
 #include "source/opt/ir_context.h"
@@ -26,6 +28,87 @@
 namespace spvtools {
 namespace fuzz {
 
+// Holds snapshots of the state of a replay, taken at regular intervals, so
+// that a later replay of a transformation sequence that shares a prefix with
+// the previously-replayed sequence can resume from the latest snapshot lying
+// inside that prefix instead of starting from scratch.  This is what makes
+// repeated replays during shrinking cheap when only later transformations are
+// removed.
+//
+// A cache may be shared by any number of (non-concurrent) replays of the same
+// input binary with the same initial facts; if a replay uses a different
+// binary or different facts, the cache is cleared.
+class ReplayCheckpointCache {
+ public:
+  // |interval| is the number of transformations between consecutive
+  // snapshots, and must be positive.
+  explicit ReplayCheckpointCache(uint32_t interval);
+
+  // Disables copy/move constructor/assignment operations.
+  ReplayCheckpointCache(const ReplayCheckpointCache&) = delete;
+  ReplayCheckpointCache(ReplayCheckpointCache&&) = delete;
+  ReplayCheckpointCache& operator=(const ReplayCheckpointCache&) = delete;
+  ReplayCheckpointCache& operator=(ReplayCheckpointCache&&) = delete;
+
+  ~ReplayCheckpointCache();
+
+  // Returns the number of snapshots currently held.
+  uint32_t GetNumCheckpoints() const;
+
+  // Returns the total number of transformations that replays using this cache
+  // did not have to re-apply, thanks to resuming from a snapshot.
+  uint64_t GetNumTransformationsSkipped() const;
+
+ private:
+  friend class Replayer;
+
+  // The state of a replay after the first |num_transformations_considered|
+  // transformations of the input sequence were considered for application.
+  struct Checkpoint {
+    uint32_t num_transformations_considered;
+    std::unique_ptr<opt::IRContext> ir_context;
+    std::unique_ptr<FactManager> fact_manager;
+    // Overflow ids are issued sequentially from |first_overflow_id|, so the
+    // state of the overflow id source is captured by these two values.
+    uint32_t first_overflow_id;
+    uint32_t num_overflow_ids_issued;
+  };
+
+  // Discards all state if |binary_in| and |initial_facts| do not match those
+  // that the cache was populated from, and records them.
+  void ResetIfInputsDiffer(const std::vector<uint32_t>& binary_in,
+                           const protobufs::FactSequence& initial_facts);
+
+  // Returns the length of the longest common prefix of |sequence| and the
+  // sequence that was last replayed, not looking further than |limit|.
+  uint32_t GetCommonPrefixLength(
+      const protobufs::TransformationSequence& sequence, uint32_t limit) const;
+
+  // Discards all snapshots taken after more than |prefix_length|
+  // transformations had been considered, and forgets about transformations
+  // beyond |prefix_length|.
+  void TruncateTo(uint32_t prefix_length);
+
+  // The number of transformations between consecutive snapshots.
+  const uint32_t interval_;
+
+  // The input binary and (serialized) initial facts for which the cache is
+  // populated.
+  std::vector<uint32_t> binary_in_;
+  std::string initial_facts_;
+
+  // The prefix of the most recently replayed transformation sequence that was
+  // considered during replay, and for each of its transformations, whether it
+  // was applied.
+  std::vector<std::string> transformations_;
+  std::vector<bool> applied_;
+
+  // Snapshots, ordered by |num_transformations_considered|.
+  std::vector<Checkpoint> checkpoints_;
+
+  uint64_t num_transformations_skipped_;
+};
+
 // Transforms a SPIR-V module into a semantically equivalent SPIR-V module by
 // applying a series of pre-defined transformations.
 class Replayer {
@@ -51,7 +134,8 @@ class Replayer {
            const protobufs::FactSequence& initial_facts,
            const protobufs::TransformationSequence& transformation_sequence_in,
            uint32_t num_transformations_to_apply, bool validate_during_replay,
-           spv_validator_options validator_options);
+           spv_validator_options validator_options,
+           ReplayCheckpointCache* checkpoint_cache = nullptr);
 
   // Disables copy/move constructor/assignment operations.
   Replayer(const Replayer&) = delete;
@@ -71,6 +155,9 @@ class Replayer {
   // the transformation context that arises from applying these transformations.
   // Otherwise, returns an appropriate result status, an empty transformation
   // sequence, and null pointers for the IR context and transformation context.
+  //
+  // If a checkpoint cache was provided, replay resumes from the latest
+  // suitable snapshot in the cache, and new snapshots are added to it.
   ReplayerResult Run();
 
  private:
@@ -97,6 +184,9 @@ class Replayer {
 
   // Options to control validation
   spv_validator_options validator_options_;
+
+  // Optional cache of replay snapshots; may be null.
+  ReplayCheckpointCache* checkpoint_cache_;
 };
 
 }  // namespace fuzz
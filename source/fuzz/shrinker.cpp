@@ -14,7 +14,12 @@
 
 #include "source/fuzz/shrinker.h"
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "source/fuzz/added_function_reducer.h"
 #include "source/fuzz/pseudo_random_generator.h"
@@ -29,6 +34,13 @@ namespace fuzz {
 
 namespace {
 
+// Bounds on the spacing of the replay snapshots that are taken during
+// shrinking: snapshots are never taken more often than every
+// |kMinReplayCheckpointInterval| transformations, and there are at most (about)
+// |kMaxReplayCheckpoints| of them.
+const uint32_t kMinReplayCheckpointInterval = 16;
+const uint32_t kMaxReplayCheckpoints = 64;
+
 // A helper to get the size of a protobuf transformation sequence in a less
 // verbose manner.
 uint32_t NumRemainingTransformations(
@@ -78,10 +90,15 @@ Shrinker::Shrinker(
       interestingness_function_(interestingness_function),
       step_limit_(step_limit),
       validate_during_replay_(validate_during_replay),
-      validator_options_(validator_options) {}
+      validator_options_(validator_options),
+      num_threads_(1) {}
 
 Shrinker::~Shrinker() = default;
 
+void Shrinker::SetNumThreads(uint32_t num_threads) {
+  num_threads_ = std::max(num_threads, 1u);
+}
+
 Shrinker::ShrinkerResult Shrinker::Run() {
   // Check compatibility between the library version being linked with and the
   // header files being used.
@@ -103,6 +120,23 @@ Shrinker::ShrinkerResult Shrinker::Run() {
             std::vector<uint32_t>(), protobufs::TransformationSequence()};
   }
 
+  // Shrink attempts remove chunks of transformations, working from the end of
+  // the sequence towards its start, so successive replays tend to share long
+  // prefixes.  Replay snapshots are cached so that each replay can resume from
+  // the end of the shared prefix.  The interval between snapshots is chosen so
+  // that a bounded number of snapshots are held at any one time.
+  // There is one cache per concurrent shrink attempt, as caches are not
+  // thread-safe.
+  const uint32_t checkpoint_interval = std::max(
+      kMinReplayCheckpointInterval,
+      static_cast<uint32_t>(transformation_sequence_in_.transformation_size()) /
+          kMaxReplayCheckpoints);
+  std::vector<std::unique_ptr<ReplayCheckpointCache>> checkpoint_caches;
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    checkpoint_caches.push_back(
+        MakeUnique<ReplayCheckpointCache>(checkpoint_interval));
+  }
+
   // Run a replay of the initial transformation sequence to check that it
   // succeeds.
   auto initial_replay_result =
@@ -110,7 +144,8 @@ Shrinker::ShrinkerResult Shrinker::Run() {
                transformation_sequence_in_,
                static_cast<uint32_t>(
                    transformation_sequence_in_.transformation_size()),
-               validate_during_replay_, validator_options_)
+               validate_during_replay_, validator_options_,
+               checkpoint_caches[0].get())
           .Run();
   if (initial_replay_result.status !=
       Replayer::ReplayerResultStatus::kComplete) {
@@ -144,6 +179,8 @@ Shrinker::ShrinkerResult Shrinker::Run() {
                             // shrinker will try to remove in one go; starts
                             // high and decreases during the shrinking process.
 
+  const auto chunk_removal_start_time = std::chrono::steady_clock::now();
+
   // Keep shrinking until we:
   // - reach the step limit,
   // - run out of transformations to remove, or
@@ -176,55 +213,77 @@ Shrinker::ShrinkerResult Shrinker::Run() {
 
     // We go through the transformations in reverse, in chunks of size
     // |chunk_size|, using |chunk_index| to track which chunk to try removing
-    // next.  The loop exits early if we reach the shrinking step limit.
+    // next.  Up to |num_threads_| consecutive chunks are tried at once, each
+    // removed independently from the current best sequence.  The earliest
+    // successful attempt, in the order in which they would have been tried
+    // sequentially, is accepted, and the attempts after it are discarded, since
+    // they were made relative to a sequence that is no longer the best.  The
+    // loop exits early if we reach the shrinking step limit.
     for (int chunk_index = num_chunks - 1;
-         attempt < step_limit_ && chunk_index >= 0; chunk_index--) {
-      // Remove a chunk of transformations according to the current index and
-      // chunk size.
-      auto transformations_with_chunk_removed =
-          RemoveChunk(current_best_transformations,
-                      static_cast<uint32_t>(chunk_index), chunk_size);
-
-      // Replay the smaller sequence of transformations to get a next binary and
-      // transformation sequence. Note that the transformations arising from
-      // replay might be even smaller than the transformations with the chunk
-      // removed, because removing those transformations might make further
-      // transformations inapplicable.
-      auto replay_result =
-          Replayer(
-              target_env_, consumer_, binary_in_, initial_facts_,
-              transformations_with_chunk_removed,
-              static_cast<uint32_t>(
-                  transformations_with_chunk_removed.transformation_size()),
-              validate_during_replay_, validator_options_)
-              .Run();
-      if (replay_result.status != Replayer::ReplayerResultStatus::kComplete) {
-        // Replay should not fail; if it does, we need to abort shrinking.
-        return {ShrinkerResultStatus::kReplayFailed, std::vector<uint32_t>(),
-                protobufs::TransformationSequence()};
+         attempt < step_limit_ && chunk_index >= 0;) {
+      const uint32_t num_candidates =
+          std::min({num_threads_, step_limit_ - attempt,
+                    static_cast<uint32_t>(chunk_index) + 1});
+      std::vector<ChunkRemovalAttempt> candidates(num_candidates);
+      auto try_candidate = [this, &candidates, &checkpoint_caches,
+                            &current_best_transformations, &attempt,
+                            chunk_index, chunk_size](
+                               uint32_t candidate_index,
+                               const MessageConsumer& consumer) {
+        const uint32_t candidate_chunk_index =
+            static_cast<uint32_t>(chunk_index) - candidate_index;
+        candidates[candidate_index] = TryRemovingChunk(
+            current_best_transformations, candidate_chunk_index, chunk_size,
+            attempt + candidate_index, consumer,
+            checkpoint_caches[candidate_index].get());
+      };
+      if (num_candidates == 1) {
+        try_candidate(0, consumer_);
+      } else {
+        // The consumer may be invoked by several threads, so it is wrapped to
+        // serialize its invocations.
+        std::mutex consumer_mutex;
+        MessageConsumer locked_consumer =
+            [this, &consumer_mutex](spv_message_level_t level,
+                                    const char* source,
+                                    const spv_position_t& position,
+                                    const char* message) {
+              std::lock_guard<std::mutex> lock(consumer_mutex);
+              consumer_(level, source, position, message);
+            };
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < num_candidates; i++) {
+          threads.emplace_back(try_candidate, i, std::cref(locked_consumer));
+        }
+        for (auto& thread : threads) {
+          thread.join();
+        }
       }
 
-      assert(
-          NumRemainingTransformations(replay_result.applied_transformations) >=
-              chunk_index * chunk_size &&
-          "Removing this chunk of transformations should not have an effect "
-          "on earlier chunks.");
-
-      std::vector<uint32_t> transformed_binary;
-      replay_result.transformed_module->module()->ToBinary(&transformed_binary,
-                                                           false);
-      if (interestingness_function_(transformed_binary, attempt)) {
-        // If the binary arising from the smaller transformation sequence is
-        // interesting, this becomes our current best binary and transformation
-        // sequence.
-        current_best_binary = std::move(transformed_binary);
-        current_best_transformations =
-            std::move(replay_result.applied_transformations);
-        progress_this_round = true;
+      // All candidates count as shrink attempts, whether successful or not,
+      // and whether or not their results end up being used.
+      attempt += num_candidates;
+
+      uint32_t num_candidates_consumed = num_candidates;
+      for (uint32_t i = 0; i < num_candidates; i++) {
+        if (!candidates[i].replay_succeeded) {
+          // Replay should not fail; if it does, we need to abort shrinking.
+          return {ShrinkerResultStatus::kReplayFailed, std::vector<uint32_t>(),
+                  protobufs::TransformationSequence()};
+        }
+        if (candidates[i].interesting) {
+          // If the binary arising from the smaller transformation sequence is
+          // interesting, this becomes our current best binary and
+          // transformation sequence.
+          current_best_binary = std::move(candidates[i].binary);
+          current_best_transformations =
+              std::move(candidates[i].applied_transformations);
+          progress_this_round = true;
+          num_candidates_consumed = i + 1;
+          break;
+        }
       }
-      // Either way, this was a shrink attempt, so increment our count of shrink
-      // attempts.
-      attempt++;
+      chunk_index -= static_cast<int>(num_candidates_consumed);
     }
     if (!progress_this_round) {
       // If we didn't manage to remove any chunks at this chunk size, try a
@@ -239,6 +298,21 @@ Shrinker::ShrinkerResult Shrinker::Run() {
     }
   }
 
+  {
+    // Report the throughput of the chunk-removal phase.
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - chunk_removal_start_time;
+    std::stringstream strstream;
+    strstream << "Made " << attempt << " chunk removal attempts in "
+              << elapsed.count() << " seconds using " << num_threads_
+              << " thread(s)";
+    if (elapsed.count() > 0) {
+      strstream << " (" << attempt / elapsed.count() << " attempts/second)";
+    }
+    strstream << ".";
+    consumer_(SPV_MSG_INFO, nullptr, {}, strstream.str().c_str());
+  }
+
   // We now use spirv-reduce to minimise the functions associated with any
   // AddFunction transformations that remain.
   //
@@ -304,6 +378,49 @@ Shrinker::ShrinkerResult Shrinker::Run() {
           std::move(current_best_transformations)};
 }
 
+Shrinker::ChunkRemovalAttempt Shrinker::TryRemovingChunk(
+    const protobufs::TransformationSequence& transformations,
+    uint32_t chunk_index, uint32_t chunk_size, uint32_t attempt,
+    const MessageConsumer& consumer,
+    ReplayCheckpointCache* checkpoint_cache) const {
+  // Remove a chunk of transformations according to the given index and chunk
+  // size.
+  auto transformations_with_chunk_removed =
+      RemoveChunk(transformations, chunk_index, chunk_size);
+
+  // Replay the smaller sequence of transformations to get a next binary and
+  // transformation sequence. Note that the transformations arising from replay
+  // might be even smaller than the transformations with the chunk removed,
+  // because removing those transformations might make further transformations
+  // inapplicable.
+  auto replay_result =
+      Replayer(target_env_, consumer, binary_in_, initial_facts_,
+               transformations_with_chunk_removed,
+               static_cast<uint32_t>(
+                   transformations_with_chunk_removed.transformation_size()),
+               validate_during_replay_, validator_options_, checkpoint_cache)
+          .Run();
+
+  ChunkRemovalAttempt result;
+  result.replay_succeeded =
+      replay_result.status == Replayer::ReplayerResultStatus::kComplete;
+  result.interesting = false;
+  if (!result.replay_succeeded) {
+    return result;
+  }
+
+  assert(NumRemainingTransformations(replay_result.applied_transformations) >=
+             chunk_index * chunk_size &&
+         "Removing this chunk of transformations should not have an effect "
+         "on earlier chunks.");
+
+  replay_result.transformed_module->module()->ToBinary(&result.binary, false);
+  result.interesting = interestingness_function_(result.binary, attempt);
+  result.applied_transformations =
+      std::move(replay_result.applied_transformations);
+  return result;
+}
+
 uint32_t Shrinker::GetIdBound(const std::vector<uint32_t>& binary) const {
   // Build the module from the input binary.
   std::unique_ptr<opt::IRContext> ir_context =
@@ -24,6 +24,8 @@
 namespace spvtools {
 namespace fuzz {
 
+class ReplayCheckpointCache;
+
 // Shrinks a sequence of transformations that lead to an interesting SPIR-V
 // binary to yield a smaller sequence of transformations that still produce an
 // interesting binary.
@@ -87,7 +89,34 @@ class Shrinker {
   // returned together with an empty binary and empty transformation sequence.
   ShrinkerResult Run();
 
+  // Sets the number of chunk removal attempts that may be evaluated
+  // concurrently, each on its own thread; the default is 1.  When this is
+  // greater than 1, the interestingness function must be safe to call from
+  // several threads at once.  The result of shrinking does not depend on the
+  // number of threads, except via the step limit, since every attempt counts
+  // as a step even if its result is discarded.
+  void SetNumThreads(uint32_t num_threads);
+
  private:
+  // The outcome of an attempt to remove a chunk of transformations.
+  struct ChunkRemovalAttempt {
+    // False if replaying the smaller sequence of transformations failed.
+    bool replay_succeeded;
+    bool interesting;
+    std::vector<uint32_t> binary;
+    protobufs::TransformationSequence applied_transformations;
+  };
+
+  // Removes the chunk of size |chunk_size| at |chunk_index| from
+  // |transformations|, replays the result (via |checkpoint_cache|, reporting
+  // messages to |consumer|) and checks whether the resulting binary is
+  // interesting, passing |attempt| to the interestingness function.
+  ChunkRemovalAttempt TryRemovingChunk(
+      const protobufs::TransformationSequence& transformations,
+      uint32_t chunk_index, uint32_t chunk_size, uint32_t attempt,
+      const MessageConsumer& consumer,
+      ReplayCheckpointCache* checkpoint_cache) const;
+
   // Returns the id bound for the given SPIR-V binary, which is assumed to be
   // valid.
   uint32_t GetIdBound(const std::vector<uint32_t>& binary) const;
@@ -120,6 +149,9 @@ class Shrinker {
 
   // Options to control validation.
   spv_validator_options validator_options_;
+
+  // The maximum number of chunk removal attempts to evaluate concurrently.
+  uint32_t num_threads_;
 };
 
 }  // namespace fuzz
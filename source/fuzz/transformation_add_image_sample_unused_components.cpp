@@ -102,7 +102,12 @@ void TransformationAddImageSampleUnusedComponents::Apply(
       FindInstruction(message_.instruction_descriptor(), ir_context);
   image_sample_instruction->SetInOperand(
       1, {message_.coordinate_with_unused_components_id()});
-  ir_context->InvalidateAnalysesExceptFor(opt::IRContext::kAnalysisNone);
+  ir_context->get_def_use_mgr()->EraseUseRecordsOfOperandIds(
+      image_sample_instruction);
+  ir_context->get_def_use_mgr()->AnalyzeInstUse(image_sample_instruction);
+
+  // No other analyses need to be invalidated, since the transformation is
+  // local to a block, and the def-use analysis has been updated.
 }
 
 protobufs::Transformation
@@ -19,6 +19,21 @@
 
 namespace spvtools {
 namespace fuzz {
+namespace {
+
+// Inserts a copy of |inst| before |insert_before|, and informs the def-use
+// manager and the instruction to block mapping about the new instruction.
+void AddInstructionBefore(opt::IRContext* ir_context,
+                          opt::Instruction* insert_before,
+                          const opt::Instruction& inst) {
+  auto new_instruction =
+      insert_before->InsertBefore(MakeUnique<opt::Instruction>(inst));
+  ir_context->get_def_use_mgr()->AnalyzeInstDefUse(new_instruction);
+  ir_context->set_instr_block(new_instruction,
+                              ir_context->get_instr_block(insert_before));
+}
+
+}  // namespace
 
 TransformationExpandVectorReduction::TransformationExpandVectorReduction(
     protobufs::TransformationExpandVectorReduction message)
@@ -96,7 +111,7 @@ void TransformationExpandVectorReduction::Apply(
         ir_context, SpvOpCompositeExtract, instruction->type_id(), *fresh_id++,
         {{SPV_OPERAND_TYPE_ID, {vector->result_id()}},
          {SPV_OPERAND_TYPE_LITERAL_INTEGER, {i}}});
-    instruction->InsertBefore(MakeUnique<opt::Instruction>(vector_component));
+    AddInstructionBefore(ir_context, instruction, vector_component);
     fuzzerutil::UpdateModuleIdBound(ir_context, vector_component.result_id());
     vector_components.push_back(vector_component.result_id());
   }
@@ -108,7 +123,7 @@ void TransformationExpandVectorReduction::Apply(
       instruction->type_id(), *fresh_id++,
       {{SPV_OPERAND_TYPE_ID, {vector_components[0]}},
        {SPV_OPERAND_TYPE_ID, {vector_components[1]}}});
-  instruction->InsertBefore(MakeUnique<opt::Instruction>(logical_instruction));
+  AddInstructionBefore(ir_context, instruction, logical_instruction);
   fuzzerutil::UpdateModuleIdBound(ir_context, logical_instruction.result_id());
 
   // Evaluates the remaining components.
@@ -118,13 +133,14 @@ void TransformationExpandVectorReduction::Apply(
         *fresh_id++,
         {{SPV_OPERAND_TYPE_ID, {vector_components[i]}},
          {SPV_OPERAND_TYPE_ID, {logical_instruction.result_id()}}});
-    instruction->InsertBefore(
-        MakeUnique<opt::Instruction>(logical_instruction));
+    AddInstructionBefore(ir_context, instruction, logical_instruction);
     fuzzerutil::UpdateModuleIdBound(ir_context,
                                     logical_instruction.result_id());
   }
 
-  ir_context->InvalidateAnalysesExceptFor(opt::IRContext::kAnalysisNone);
+  // The def-use manager and instruction to block mapping have been kept up to
+  // date, and no other analyses need to be invalidated since the
+  // transformation is local to a block.
 
   // If it's possible to make a synonym of |instruction|, then add the fact that
   // the last |logical_instruction| is a synonym of |instruction|.
@@ -171,12 +171,17 @@ void TransformationFunctionCall::Apply(
     operands.push_back({SPV_OPERAND_TYPE_ID, {arg}});
   }
   // Insert the function call before the instruction specified in the message.
-  FindInstruction(message_.instruction_to_insert_before(), ir_context)
-      ->InsertBefore(MakeUnique<opt::Instruction>(
-          ir_context, SpvOpFunctionCall, return_type, message_.fresh_id(),
-          operands));
-  // Invalidate all analyses since we have changed the module.
-  ir_context->InvalidateAnalysesExceptFor(opt::IRContext::kAnalysisNone);
+  auto insert_before =
+      FindInstruction(message_.instruction_to_insert_before(), ir_context);
+  auto new_instruction = insert_before->InsertBefore(
+      MakeUnique<opt::Instruction>(ir_context, SpvOpFunctionCall, return_type,
+                                   message_.fresh_id(), operands));
+  // Inform the def-use manager about the new instruction and record its basic
+  // block.  No other analyses need to be invalidated, since the transformation
+  // is local to a block.
+  ir_context->get_def_use_mgr()->AnalyzeInstDefUse(new_instruction);
+  ir_context->set_instr_block(new_instruction,
+                              ir_context->get_instr_block(insert_before));
 }
 
 protobufs::Transformation TransformationFunctionCall::ToMessage() const {
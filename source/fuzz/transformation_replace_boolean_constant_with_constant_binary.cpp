@@ -306,8 +306,17 @@ TransformationReplaceBooleanConstantWithConstantBinary::ApplyWithResult(
       {message_.fresh_id_for_binary_operation()});
   fuzzerutil::UpdateModuleIdBound(ir_context,
                                   message_.fresh_id_for_binary_operation());
-  ir_context->InvalidateAnalysesExceptFor(
-      opt::IRContext::Analysis::kAnalysisNone);
+
+  // Inform the def-use manager about the new instruction and the changed use,
+  // and record the basic block of the new instruction.  No other analyses need
+  // to be invalidated, since the control flow of the module is unchanged.
+  ir_context->get_def_use_mgr()->AnalyzeInstDefUse(result);
+  ir_context->set_instr_block(
+      result, ir_context->get_instr_block(instruction_before_which_to_insert));
+  ir_context->get_def_use_mgr()->EraseUseRecordsOfOperandIds(
+      instruction_containing_constant_use);
+  ir_context->get_def_use_mgr()->AnalyzeInstUse(
+      instruction_containing_constant_use);
   return result;
 }
 
@@ -98,21 +98,30 @@ void TransformationReplaceCopyMemoryWithLoadStore::Apply(
   // First, insert the OpStore instruction before the OpCopyMemory instruction
   // and then insert the OpLoad instruction before the OpStore instruction.
   fuzzerutil::UpdateModuleIdBound(ir_context, message_.fresh_id());
-  FindInstruction(message_.copy_memory_instruction_descriptor(), ir_context)
-      ->InsertBefore(MakeUnique<opt::Instruction>(
+  auto store_instruction =
+      copy_memory_instruction->InsertBefore(MakeUnique<opt::Instruction>(
           ir_context, SpvOpStore, 0, 0,
           opt::Instruction::OperandList(
               {{SPV_OPERAND_TYPE_ID, {target->result_id()}},
-               {SPV_OPERAND_TYPE_ID, {message_.fresh_id()}}})))
-      ->InsertBefore(MakeUnique<opt::Instruction>(
+               {SPV_OPERAND_TYPE_ID, {message_.fresh_id()}}})));
+  auto load_instruction =
+      store_instruction->InsertBefore(MakeUnique<opt::Instruction>(
           ir_context, SpvOpLoad, target_pointee_type, message_.fresh_id(),
           opt::Instruction::OperandList(
               {{SPV_OPERAND_TYPE_ID, {source->result_id()}}})));
 
-  // Remove the OpCopyMemory instruction.
-  ir_context->KillInst(copy_memory_instruction);
+  // Inform the def-use manager about the new instructions and record their
+  // basic block.
+  auto block = ir_context->get_instr_block(copy_memory_instruction);
+  for (auto* new_instruction : {load_instruction, store_instruction}) {
+    ir_context->get_def_use_mgr()->AnalyzeInstDefUse(new_instruction);
+    ir_context->set_instr_block(new_instruction, block);
+  }
 
-  ir_context->InvalidateAnalysesExceptFor(opt::IRContext::kAnalysisNone);
+  // Remove the OpCopyMemory instruction.  This keeps the def-use manager and
+  // instruction to block mapping up to date, and since the transformation is
+  // local to a block no other analyses need to be invalidated.
+  ir_context->KillInst(copy_memory_instruction);
 }
 
 protobufs::Transformation
@@ -120,16 +120,23 @@ void TransformationReplaceLoadStoreWithCopyMemory::Apply(
       kOpStoreOperandIndexTargetVariable);
 
   // Insert the OpCopyMemory instruction before the OpStore instruction.
-  store_instruction->InsertBefore(MakeUnique<opt::Instruction>(
-      ir_context, SpvOpCopyMemory, 0, 0,
-      opt::Instruction::OperandList(
-          {{SPV_OPERAND_TYPE_ID, {target_variable_id}},
-           {SPV_OPERAND_TYPE_ID, {source_variable_id}}})));
-
-  // Remove the OpStore instruction.
+  auto copy_memory_instruction =
+      store_instruction->InsertBefore(MakeUnique<opt::Instruction>(
+          ir_context, SpvOpCopyMemory, 0, 0,
+          opt::Instruction::OperandList(
+              {{SPV_OPERAND_TYPE_ID, {target_variable_id}},
+               {SPV_OPERAND_TYPE_ID, {source_variable_id}}})));
+
+  // Inform the def-use manager about the new instruction and record its basic
+  // block.
+  ir_context->get_def_use_mgr()->AnalyzeInstDefUse(copy_memory_instruction);
+  ir_context->set_instr_block(copy_memory_instruction,
+                              ir_context->get_instr_block(store_instruction));
+
+  // Remove the OpStore instruction.  This keeps the def-use manager and
+  // instruction to block mapping up to date, and since the transformation is
+  // local to a block no other analyses need to be invalidated.
   ir_context->KillInst(store_instruction);
-
-  ir_context->InvalidateAnalysesExceptFor(opt::IRContext::kAnalysisNone);
 }
 
 bool TransformationReplaceLoadStoreWithCopyMemory::IsMemoryWritingOpCode(
@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "source/opt/const_folding_rules.h"
@@ -23,6 +24,7 @@
 #include "source/opt/folding_rules.h"
 #include "source/opt/ir_builder.h"
 #include "source/opt/ir_context.h"
+#include "source/util/coverage_counters.h"
 
 namespace spvtools {
 namespace opt {
@@ -242,9 +244,19 @@ bool InstructionFolder::FoldInstructionInternal(Instruction* inst) const {
   std::vector<const analysis::Constant*> constants =
       const_manager->GetOperandConstants(inst);
 
-  for (const FoldingRule& rule :
-       GetFoldingRules().GetRulesForInstruction(inst)) {
-    if (rule(context_, inst, constants)) {
+  const auto& rules = GetFoldingRules().GetRulesForInstruction(inst);
+  for (size_t i = 0; i < rules.size(); i++) {
+    // The points of the first 16 rules of the core opcodes are cached; the
+    // others are looked up by name.
+    SPIRV_COVERAGE_POINT_KEYED(
+        512, 16, inst->opcode(), i,
+        std::string("opt.fold.tried.") + spvOpcodeString(inst->opcode()) +
+            "." + std::to_string(i));
+    if (rules[i](context_, inst, constants)) {
+      SPIRV_COVERAGE_POINT_KEYED(
+          512, 16, inst->opcode(), i,
+          std::string("opt.fold.applied.") + spvOpcodeString(inst->opcode()) +
+              "." + std::to_string(i));
       return true;
     }
   }
@@ -647,9 +659,19 @@ Instruction* InstructionFolder::FoldInstructionToConstant(
   });
 
   const analysis::Constant* folded_const = nullptr;
-  for (auto rule : GetConstantFoldingRules().GetRulesForInstruction(inst)) {
-    folded_const = rule(context_, inst, constants);
+  const auto& constant_rules =
+      GetConstantFoldingRules().GetRulesForInstruction(inst);
+  for (size_t i = 0; i < constant_rules.size(); i++) {
+    SPIRV_COVERAGE_POINT_KEYED(512, 16, inst->opcode(), i,
+                               std::string("opt.fold_constant.tried.") +
+                                   spvOpcodeString(inst->opcode()) + "." +
+                                   std::to_string(i));
+    folded_const = constant_rules[i](context_, inst, constants);
     if (folded_const != nullptr) {
+      SPIRV_COVERAGE_POINT_KEYED(512, 16, inst->opcode(), i,
+                                 std::string("opt.fold_constant.applied.") +
+                                     spvOpcodeString(inst->opcode()) + "." +
+                                     std::to_string(i));
       Instruction* const_inst =
           const_mgr->GetDefiningInstruction(folded_const, inst->type_id());
       if (const_inst == nullptr) {
@@ -16,8 +16,11 @@
 
 #include "source/opt/pass.h"
 
+#include <string>
+
 #include "source/opt/ir_builder.h"
 #include "source/opt/iterator.h"
+#include "source/util/coverage_counters.h"
 
 namespace spvtools {
 namespace opt {
@@ -36,6 +39,8 @@ Pass::Status Pass::Run(IRContext* ctx) {
   }
   already_run_ = true;
 
+  SPIRV_COVERAGE_POINT_DYNAMIC(std::string("opt.pass.") + name());
+
   context_ = ctx;
   Pass::Status status = Process();
   context_ = nullptr;
@@ -15,10 +15,12 @@
 #include "source/opt/pass_manager.h"
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "source/opt/ir_context.h"
+#include "source/util/make_unique.h"
 #include "source/util/timer.h"
 #include "spirv-tools/libspirv.hpp"
 
@@ -51,6 +53,16 @@ Pass::Status PassManager::Run(IRContext* context) {
     }
   };
 
+  // When validating after every pass, the validator and the buffer the module
+  // is serialized into are shared by all passes rather than being recreated
+  // each time.
+  std::unique_ptr<SpirvTools> validator;
+  std::vector<uint32_t> validation_binary;
+  if (validate_after_all_) {
+    validator = MakeUnique<SpirvTools>(target_env_);
+    validator->SetMessageConsumer(consumer());
+  }
+
   SPIRV_TIMER_DESCRIPTION(time_report_stream_, /* measure_mem_usage = */ true);
   for (auto& pass : passes_) {
     print_disassembly("; IR before pass ", pass.get());
@@ -60,11 +72,10 @@ Pass::Status PassManager::Run(IRContext* context) {
     if (one_status == Pass::Status::SuccessWithChange) status = one_status;
 
     if (validate_after_all_) {
-      spvtools::SpirvTools tools(target_env_);
-      tools.SetMessageConsumer(consumer());
-      std::vector<uint32_t> binary;
-      context->module()->ToBinary(&binary, true);
-      if (!tools.Validate(binary.data(), binary.size(), val_options_)) {
+      validation_binary.clear();
+      context->module()->ToBinary(&validation_binary, true);
+      if (!validator->Validate(validation_binary.data(),
+                               validation_binary.size(), val_options_)) {
         std::string msg = "Validation failed after pass ";
         msg += pass->name();
         spv_position_t null_pos{0, 0, 0};
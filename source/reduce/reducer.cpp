@@ -14,9 +14,18 @@
 
 #include "source/reduce/reducer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
+#include "source/opt/build_module.h"
 #include "source/reduce/conditional_branch_to_simple_conditional_branch_opportunity_finder.h"
 #include "source/reduce/merge_blocks_reduction_opportunity_finder.h"
 #include "source/reduce/operand_to_const_reduction_opportunity_finder.h"
@@ -34,8 +43,62 @@
 
 namespace spvtools {
 namespace reduce {
+namespace {
 
-Reducer::Reducer(spv_target_env target_env) : target_env_(target_env) {}
+// Under the adaptive strategy, a pass whose chunks have failed to be
+// interesting this many times in a row is moved to a finer granularity before
+// it completes its current round.
+const uint32_t kAdaptiveMaxConsecutiveFailures = 8;
+
+// Identifies a reduction checkpoint ("SPRC"), and the version of its layout.
+const uint32_t kCheckpointMagicNumber = 0x53505243;
+const uint32_t kCheckpointVersion = 1;
+
+// Statistics that guide the scheduling of a pass under the adaptive strategy.
+struct AdaptivePassStatistics {
+  // The number of reduction steps the pass has made.
+  uint32_t attempts = 0;
+
+  // The total number of bytes removed by interesting reduction steps.
+  uint64_t bytes_removed = 0;
+
+  // The number of uninteresting reduction steps since the last interesting
+  // step, or since the pass last changed granularity.
+  uint32_t consecutive_failures = 0;
+
+  // True if the pass has completed a round at minimum granularity without
+  // making progress, at the point where the binary had version
+  // |exhausted_at_version|.
+  bool exhausted = false;
+  uint64_t exhausted_at_version = 0;
+};
+
+// Returns a score for the pass with statistics |statistics|; passes with
+// higher scores are run earlier in a round.  Untried passes come first, and a
+// pass that had no opportunities the last time it ran comes last.
+double AdaptiveScore(const AdaptivePassStatistics& statistics,
+                     const ReductionPass& pass) {
+  if (statistics.attempts == 0) {
+    return std::numeric_limits<double>::max();
+  }
+  if (pass.GetNumOpportunities() == 0) {
+    return 0.0;
+  }
+  // Add-one smoothing, so that a pass that has not yet succeeded still gets a
+  // non-zero score.
+  return (static_cast<double>(statistics.bytes_removed) + 1.0) /
+         (static_cast<double>(statistics.attempts) + 1.0);
+}
+
+}  // namespace
+
+Reducer::Reducer(spv_target_env target_env)
+    : target_env_(target_env),
+      reduction_strategy_(ReductionStrategy::kRoundRobin),
+      num_threads_(1),
+      checkpoint_interval_(0),
+      num_interestingness_tests_(0),
+      shared_step_count_(nullptr) {}
 
 Reducer::~Reducer() = default;
 
@@ -54,11 +117,26 @@ void Reducer::SetInterestingnessFunction(
   interestingness_function_ = std::move(interestingness_function);
 }
 
+void Reducer::SetReductionStrategy(ReductionStrategy reduction_strategy) {
+  reduction_strategy_ = reduction_strategy;
+}
+
+void Reducer::SetNumThreads(uint32_t num_threads) {
+  num_threads_ = std::max(num_threads, 1u);
+}
+
+void Reducer::SetCheckpointFunction(CheckpointFunction checkpoint_function,
+                                    uint32_t checkpoint_interval) {
+  checkpoint_function_ = std::move(checkpoint_function);
+  checkpoint_interval_ = checkpoint_interval;
+}
+
 Reducer::ReductionResultStatus Reducer::Run(
     const std::vector<uint32_t>& binary_in, std::vector<uint32_t>* binary_out,
     spv_const_reducer_options options,
     spv_validator_options validator_options) {
   std::vector<uint32_t> current_binary(binary_in);
+  PrepareForRun();
 
   spvtools::SpirvTools tools(target_env_);
   assert(tools.IsValid() && "Failed to create SPIRV-Tools interface");
@@ -76,6 +154,7 @@ Reducer::ReductionResultStatus Reducer::Run(
   }
 
   // Initial state should be interesting.
+  num_interestingness_tests_++;
   if (!interestingness_function_(current_binary, reductions_applied)) {
     consumer_(SPV_MSG_INFO, nullptr, {},
               "Initial state was not interesting; stopping.");
@@ -83,26 +162,173 @@ Reducer::ReductionResultStatus Reducer::Run(
   }
 
   Reducer::ReductionResultStatus result =
-      RunPasses(&passes_, options, validator_options, tools, &current_binary,
-                &reductions_applied);
+      Reducer::ReductionResultStatus::kComplete;
+
+  if (num_threads_ > 1 && options->target_function == 0) {
+    result = RunFunctionParallelReduction(options, validator_options, tools,
+                                          &current_binary, &reductions_applied);
+  }
+
+  return CompleteRun(result, false, binary_in.size(), options,
+                     validator_options, tools, &current_binary,
+                     &reductions_applied, binary_out);
+}
+
+Reducer::ReductionResultStatus Reducer::Resume(
+    const std::vector<uint32_t>& checkpoint, std::vector<uint32_t>* binary_out,
+    spv_const_reducer_options options,
+    spv_validator_options validator_options) {
+  PrepareForRun();
+
+  std::vector<uint32_t> current_binary;
+  uint32_t reductions_applied = 0;
+  bool running_cleanup_passes = false;
+  if (!RestoreCheckpoint(checkpoint, &current_binary, &reductions_applied,
+                         &running_cleanup_passes)) {
+    consumer_(SPV_MSG_INFO, nullptr, {},
+              "Checkpoint is malformed or does not match the reduction "
+              "passes; stopping.");
+    return Reducer::ReductionResultStatus::kCheckpointInvalid;
+  }
+
+  spvtools::SpirvTools tools(target_env_);
+  assert(tools.IsValid() && "Failed to create SPIRV-Tools interface");
+
+  // The binary in a checkpoint was valid and interesting when the checkpoint
+  // was taken, so it does not need to be checked again.
+  std::stringstream stringstream;
+  stringstream << "Resuming reduction after " << reductions_applied
+               << " reduction steps.";
+  consumer_(SPV_MSG_INFO, nullptr, {}, stringstream.str().c_str());
+
+  const size_t original_size = current_binary.size();
+  return CompleteRun(Reducer::ReductionResultStatus::kComplete,
+                     running_cleanup_passes, original_size, options,
+                     validator_options, tools, &current_binary,
+                     &reductions_applied, binary_out);
+}
+
+void Reducer::PrepareForRun() {
+  num_interestingness_tests_ = 0;
+
+  const bool binary_splitting =
+      reduction_strategy_ == ReductionStrategy::kAdaptive;
+  for (auto& pass : passes_) {
+    pass->SetBinarySplitting(binary_splitting);
+  }
+  for (auto& pass : cleanup_passes_) {
+    pass->SetBinarySplitting(binary_splitting);
+  }
+}
+
+Reducer::ReductionResultStatus Reducer::CompleteRun(
+    ReductionResultStatus status, bool skip_passes, size_t original_size,
+    spv_const_reducer_options options, spv_validator_options validator_options,
+    const SpirvTools& tools, std::vector<uint32_t>* current_binary,
+    uint32_t* reductions_applied, std::vector<uint32_t>* binary_out) {
+  Reducer::ReductionResultStatus result = status;
+
+  if (result == Reducer::ReductionResultStatus::kComplete && !skip_passes) {
+    result = RunPasses(&passes_, options, validator_options, tools,
+                       current_binary, reductions_applied);
+  }
 
   if (result == Reducer::ReductionResultStatus::kComplete) {
     // Cleanup passes.
     result = RunPasses(&cleanup_passes_, options, validator_options, tools,
-                       &current_binary, &reductions_applied);
+                       current_binary, reductions_applied);
   }
 
   if (result == Reducer::ReductionResultStatus::kComplete) {
     consumer_(SPV_MSG_INFO, nullptr, {}, "No more to reduce; stopping.");
   }
 
+  {
+    const size_t bytes_removed =
+        current_binary->size() < original_size
+            ? (original_size - current_binary->size()) * sizeof(uint32_t)
+            : 0;
+    std::stringstream stringstream;
+    stringstream << "Ran " << num_interestingness_tests_
+                 << " interestingness tests and removed " << bytes_removed
+                 << " bytes.";
+    consumer_(SPV_MSG_INFO, nullptr, {}, stringstream.str().c_str());
+  }
+
   // Even if the reduction has failed by this point (e.g. due to producing an
   // invalid binary), we still update the output binary for better debugging.
-  *binary_out = std::move(current_binary);
+  *binary_out = std::move(*current_binary);
 
   return result;
 }
 
+void Reducer::MaybeCheckpoint(
+    const std::vector<std::unique_ptr<ReductionPass>>* passes,
+    const std::vector<uint32_t>& current_binary,
+    uint32_t reductions_applied) const {
+  if (!checkpoint_function_ || checkpoint_interval_ == 0 ||
+      reductions_applied % checkpoint_interval_ != 0) {
+    return;
+  }
+  std::vector<uint32_t> checkpoint = {
+      kCheckpointMagicNumber, kCheckpointVersion,
+      passes == &cleanup_passes_ ? 1u : 0u, reductions_applied};
+  for (auto* pass_list : {&passes_, &cleanup_passes_}) {
+    checkpoint.push_back(static_cast<uint32_t>(pass_list->size()));
+    for (auto& pass : *pass_list) {
+      pass->SaveState(&checkpoint);
+    }
+  }
+  checkpoint.push_back(static_cast<uint32_t>(current_binary.size()));
+  checkpoint.insert(checkpoint.end(), current_binary.begin(),
+                    current_binary.end());
+  checkpoint_function_(checkpoint);
+}
+
+bool Reducer::RestoreCheckpoint(const std::vector<uint32_t>& checkpoint,
+                                std::vector<uint32_t>* binary,
+                                uint32_t* reductions_applied,
+                                bool* running_cleanup_passes) {
+  if (checkpoint.size() < 4 || checkpoint[0] != kCheckpointMagicNumber ||
+      checkpoint[1] != kCheckpointVersion || checkpoint[2] > 1) {
+    return false;
+  }
+  // The progress is restored into copies of the passes, which replace the
+  // passes only once the whole checkpoint has been read, so that a malformed
+  // checkpoint leaves every pass as it was.
+  size_t offset = 4;
+  std::vector<std::unique_ptr<ReductionPass>>* pass_lists[] = {
+      &passes_, &cleanup_passes_};
+  std::vector<std::unique_ptr<ReductionPass>> restored_pass_lists[2];
+  for (size_t list = 0; list < 2; list++) {
+    if (offset >= checkpoint.size() ||
+        checkpoint[offset] != pass_lists[list]->size()) {
+      return false;
+    }
+    offset++;
+    for (auto& pass : *pass_lists[list]) {
+      auto restored_pass = pass->CloneWithFreshState();
+      if (!restored_pass->RestoreState(checkpoint, &offset)) {
+        return false;
+      }
+      restored_pass_lists[list].push_back(std::move(restored_pass));
+    }
+  }
+  if (offset >= checkpoint.size() ||
+      checkpoint.size() - offset - 1 != checkpoint[offset] ||
+      checkpoint[offset] == 0) {
+    return false;
+  }
+  for (size_t list = 0; list < 2; list++) {
+    pass_lists[list]->swap(restored_pass_lists[list]);
+  }
+  *running_cleanup_passes = checkpoint[2] == 1;
+  *reductions_applied = checkpoint[3];
+  binary->assign(checkpoint.begin() + static_cast<std::ptrdiff_t>(offset + 1),
+                 checkpoint.end());
+  return true;
+}
+
 void Reducer::AddDefaultReductionPasses() {
   AddReductionPass(
       spvtools::MakeUnique<RemoveUnusedInstructionReductionOpportunityFinder>(
@@ -153,7 +379,10 @@ void Reducer::AddCleanupReductionPass(
 }
 
 bool Reducer::ReachedStepLimit(uint32_t current_step,
-                               spv_const_reducer_options options) {
+                               spv_const_reducer_options options) const {
+  if (shared_step_count_ != nullptr) {
+    return shared_step_count_->load() >= options->step_limit;
+  }
   return current_step >= options->step_limit;
 }
 
@@ -162,6 +391,35 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
     spv_const_reducer_options options, spv_validator_options validator_options,
     const SpirvTools& tools, std::vector<uint32_t>* current_binary,
     uint32_t* const reductions_applied) {
+  const Reducer::ReductionResultStatus result =
+      reduction_strategy_ == ReductionStrategy::kAdaptive
+          ? RunPassesAdaptively(passes, options, validator_options, tools,
+                                current_binary, reductions_applied)
+          : RunPassesRoundRobin(passes, options, validator_options, tools,
+                                current_binary, reductions_applied);
+  if (result != Reducer::ReductionResultStatus::kComplete &&
+      result != Reducer::ReductionResultStatus::kReachedStepLimit) {
+    return result;
+  }
+
+  // Report whether reduction completed, or bailed out early due to reaching
+  // the step limit.
+  if (result == Reducer::ReductionResultStatus::kReachedStepLimit ||
+      ReachedStepLimit(*reductions_applied, options)) {
+    consumer_(SPV_MSG_INFO, nullptr, {},
+              "Reached reduction step limit; stopping.");
+    return Reducer::ReductionResultStatus::kReachedStepLimit;
+  }
+
+  // The passes completed successfully, although we may still run more passes.
+  return Reducer::ReductionResultStatus::kComplete;
+}
+
+Reducer::ReductionResultStatus Reducer::RunPassesRoundRobin(
+    std::vector<std::unique_ptr<ReductionPass>>* passes,
+    spv_const_reducer_options options, spv_validator_options validator_options,
+    const SpirvTools& tools, std::vector<uint32_t>* current_binary,
+    uint32_t* const reductions_applied) {
   // Determines whether, on completing one round of reduction passes, it is
   // worthwhile trying a further round.
   bool another_round_worthwhile = true;
@@ -186,64 +444,407 @@ Reducer::ReductionResultStatus Reducer::RunPasses(
       consumer_(SPV_MSG_INFO, nullptr, {},
                 ("Trying pass " + pass->GetName() + ".").c_str());
       do {
-        auto maybe_result =
-            pass->TryApplyReduction(*current_binary, options->target_function);
-        if (maybe_result.empty()) {
+        auto outcome =
+            ApplyReductionStep(pass.get(), options, validator_options, tools,
+                               current_binary, reductions_applied);
+        if (outcome == ReductionStepOutcome::kReachedStepLimit) {
+          return Reducer::ReductionResultStatus::kReachedStepLimit;
+        }
+        if (outcome == ReductionStepOutcome::kNoMoreChunks) {
           // For this round, the pass has no more opportunities (chunks) to
           // apply, so move on to the next pass.
-          consumer_(
-              SPV_MSG_INFO, nullptr, {},
-              ("Pass " + pass->GetName() + " did not make a reduction step.")
-                  .c_str());
           break;
         }
-        bool interesting = false;
-        std::stringstream stringstream;
-        (*reductions_applied)++;
-        stringstream << "Pass " << pass->GetName() << " made reduction step "
-                     << *reductions_applied << ".";
-        consumer_(SPV_MSG_INFO, nullptr, {}, (stringstream.str().c_str()));
-        if (!tools.Validate(&maybe_result[0], maybe_result.size(),
-                            validator_options)) {
-          // The reduction step went wrong and an invalid binary was produced.
-          // By design, this shouldn't happen; this is a safeguard to stop an
-          // invalid binary from being regarded as interesting.
-          consumer_(SPV_MSG_INFO, nullptr, {},
-                    "Reduction step produced an invalid binary.");
-          if (options->fail_on_validation_error) {
-            // In this mode, we fail, so we update the current binary so it is
-            // output for debugging.
-            *current_binary = std::move(maybe_result);
-            return Reducer::ReductionResultStatus::kStateInvalid;
-          }
-        } else if (interestingness_function_(maybe_result,
-                                             *reductions_applied)) {
-          // Success!  The binary produced by this reduction step is
-          // interesting, so make it the binary of interest henceforth, and
-          // note that it's worth doing another round of reduction passes.
-          consumer_(SPV_MSG_INFO, nullptr, {}, "Reduction step succeeded.");
-          *current_binary = std::move(maybe_result);
-          interesting = true;
+        if (outcome == ReductionStepOutcome::kInvalid) {
+          return Reducer::ReductionResultStatus::kStateInvalid;
+        }
+        if (outcome == ReductionStepOutcome::kInteresting) {
+          // Note that it's worth doing another round of reduction passes.
           another_round_worthwhile = true;
         }
-        // We must call this before the next call to TryApplyReduction.
-        pass->NotifyInteresting(interesting);
+        MaybeCheckpoint(passes, *current_binary, *reductions_applied);
         // Bail out if the reduction step limit has been reached.
       } while (!ReachedStepLimit(*reductions_applied, options));
     }
   }
 
-  // Report whether reduction completed, or bailed out early due to reaching
-  // the step limit.
-  if (ReachedStepLimit(*reductions_applied, options)) {
+  return Reducer::ReductionResultStatus::kComplete;
+}
+
+Reducer::ReductionResultStatus Reducer::RunPassesAdaptively(
+    std::vector<std::unique_ptr<ReductionPass>>* passes,
+    spv_const_reducer_options options, spv_validator_options validator_options,
+    const SpirvTools& tools, std::vector<uint32_t>* current_binary,
+    uint32_t* const reductions_applied) {
+  std::vector<AdaptivePassStatistics> statistics(passes->size());
+
+  // Incremented every time the current binary changes, so that a pass can
+  // tell whether it could possibly make progress since it last tried.
+  uint64_t binary_version = 0;
+
+  bool another_round_worthwhile = true;
+  while (!ReachedStepLimit(*reductions_applied, options) &&
+         another_round_worthwhile) {
+    another_round_worthwhile = false;
+
+    // Order the passes for this round, most productive first.  The sort is
+    // stable so that ties are broken by the order in which passes were added.
+    std::vector<size_t> order(passes->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [passes, &statistics](size_t first, size_t second) {
+                       return AdaptiveScore(statistics[first],
+                                            *(*passes)[first]) >
+                              AdaptiveScore(statistics[second],
+                                            *(*passes)[second]);
+                     });
+
+    for (size_t pass_index : order) {
+      if (ReachedStepLimit(*reductions_applied, options)) {
+        break;
+      }
+      ReductionPass* pass = (*passes)[pass_index].get();
+      AdaptivePassStatistics& pass_statistics = statistics[pass_index];
+
+      if (pass_statistics.exhausted &&
+          pass_statistics.exhausted_at_version == binary_version) {
+        // The binary has not changed since this pass last failed to make
+        // progress at its minimum granularity, so it cannot make progress
+        // now.
+        continue;
+      }
+
+      const bool started_at_minimum_granularity =
+          pass->ReachedMinimumGranularity();
+      another_round_worthwhile |= !started_at_minimum_granularity;
+      bool made_progress = false;
+
+      consumer_(SPV_MSG_INFO, nullptr, {},
+                ("Trying pass " + pass->GetName() + ".").c_str());
+      while (!ReachedStepLimit(*reductions_applied, options)) {
+        const size_t size_before = current_binary->size();
+        auto outcome =
+            ApplyReductionStep(pass, options, validator_options, tools,
+                               current_binary, reductions_applied);
+        if (outcome == ReductionStepOutcome::kReachedStepLimit) {
+          // The step was refused, not tried, so the pass must not be
+          // recorded as exhausted.
+          return Reducer::ReductionResultStatus::kReachedStepLimit;
+        }
+        if (outcome == ReductionStepOutcome::kNoMoreChunks) {
+          if (started_at_minimum_granularity && !made_progress) {
+            pass_statistics.exhausted = true;
+            pass_statistics.exhausted_at_version = binary_version;
+          }
+          break;
+        }
+        if (outcome == ReductionStepOutcome::kInvalid) {
+          return Reducer::ReductionResultStatus::kStateInvalid;
+        }
+        pass_statistics.attempts++;
+        MaybeCheckpoint(passes, *current_binary, *reductions_applied);
+        if (outcome == ReductionStepOutcome::kInteresting) {
+          if (current_binary->size() < size_before) {
+            pass_statistics.bytes_removed +=
+                (size_before - current_binary->size()) * sizeof(uint32_t);
+          }
+          pass_statistics.consecutive_failures = 0;
+          binary_version++;
+          made_progress = true;
+          another_round_worthwhile = true;
+        } else if (++pass_statistics.consecutive_failures >=
+                       kAdaptiveMaxConsecutiveFailures &&
+                   !pass->ReachedMinimumGranularity()) {
+          // The chunks of this pass keep failing at the current granularity;
+          // rather than trying the rest of them, move on to a finer
+          // granularity in the next round.
+          consumer_(SPV_MSG_INFO, nullptr, {},
+                    ("Pass " + pass->GetName() +
+                     " keeps failing; lowering its granularity.")
+                        .c_str());
+          pass->SkipToNextGranularity();
+          pass_statistics.consecutive_failures = 0;
+          another_round_worthwhile = true;
+          break;
+        }
+      }
+    }
+  }
+
+  return Reducer::ReductionResultStatus::kComplete;
+}
+
+Reducer::ReductionResultStatus Reducer::RunFunctionParallelReduction(
+    spv_const_reducer_options options, spv_validator_options validator_options,
+    const SpirvTools& tools, std::vector<uint32_t>* current_binary,
+    uint32_t* const reductions_applied) {
+  std::vector<uint32_t> function_ids;
+  uint32_t ancestor_id_bound;
+  {
+    std::unique_ptr<opt::IRContext> context =
+        BuildModule(target_env_, consumer_, current_binary->data(),
+                    current_binary->size());
+    assert(context && "The current binary must be valid.");
+    ancestor_id_bound = context->module()->id_bound();
+    for (auto& function : *context->module()) {
+      function_ids.push_back(function.result_id());
+    }
+  }
+  if (function_ids.size() < 2) {
+    // There is nothing to be gained from reducing functions independently.
+    return Reducer::ReductionResultStatus::kComplete;
+  }
+
+  // Messages from the workers are serialized so that the consumer does not
+  // need to be thread-safe.
+  std::mutex consumer_mutex;
+  MessageConsumer worker_consumer =
+      [this, &consumer_mutex](spv_message_level_t level, const char* source,
+                              const spv_position_t& position,
+                              const char* message) {
+        std::lock_guard<std::mutex> lock(consumer_mutex);
+        if (consumer_) {
+          consumer_(level, source, position, message);
+        }
+      };
+
+  // The results of reducing each function: the status and binary of the
+  // reduction, and the number of reduction steps and interestingness tests it
+  // used.
+  std::vector<Reducer::ReductionResultStatus> statuses(
+      function_ids.size(), Reducer::ReductionResultStatus::kComplete);
+  std::vector<std::vector<uint32_t>> reduced_binaries(function_ids.size());
+  std::vector<uint32_t> steps(function_ids.size(), 0);
+  std::vector<uint32_t> tests(function_ids.size(), 0);
+
+  // The workers draw their reduction steps from what remains of the step
+  // limit.
+  std::atomic<uint32_t> shared_step_count(*reductions_applied);
+  std::atomic<size_t> next_function(0);
+  auto worker = [&]() {
+    SpirvTools worker_tools(target_env_);
+    for (size_t index = next_function++; index < function_ids.size();
+         index = next_function++) {
+      // Each function is reduced by a reducer of its own, with fresh passes
+      // that share the finders of this reducer's passes.
+      Reducer worker_reducer(target_env_);
+      worker_reducer.SetInterestingnessFunction(interestingness_function_);
+      worker_reducer.SetReductionStrategy(reduction_strategy_);
+      for (auto& pass : passes_) {
+        worker_reducer.passes_.push_back(pass->CloneWithFreshState());
+      }
+      worker_reducer.SetMessageConsumer(worker_consumer);
+      worker_reducer.shared_step_count_ = &shared_step_count;
+
+      spv_reducer_options_t worker_options = *options;
+      worker_options.target_function = function_ids[index];
+      std::vector<uint32_t> worker_binary(*current_binary);
+      uint32_t worker_reductions_applied = *reductions_applied;
+      statuses[index] = worker_reducer.RunPasses(
+          &worker_reducer.passes_, &worker_options, validator_options,
+          worker_tools, &worker_binary, &worker_reductions_applied);
+      steps[index] = worker_reductions_applied - *reductions_applied;
+      tests[index] = worker_reducer.num_interestingness_tests_;
+      if (worker_binary != *current_binary) {
+        reduced_binaries[index] = std::move(worker_binary);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0;
+       i < std::min(num_threads_, static_cast<uint32_t>(function_ids.size()));
+       i++) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<std::pair<uint32_t, const std::vector<uint32_t>*>>
+      reduced_functions;
+  for (size_t index = 0; index < function_ids.size(); index++) {
+    *reductions_applied += steps[index];
+    num_interestingness_tests_ += tests[index];
+    if (statuses[index] == Reducer::ReductionResultStatus::kStateInvalid) {
+      // Output the invalid binary for debugging, as the sequential reduction
+      // does.
+      *current_binary = std::move(reduced_binaries[index]);
+      return Reducer::ReductionResultStatus::kStateInvalid;
+    }
+    if (!reduced_binaries[index].empty()) {
+      reduced_functions.emplace_back(function_ids[index],
+                                     &reduced_binaries[index]);
+    }
+  }
+  if (reduced_functions.empty()) {
+    return Reducer::ReductionResultStatus::kComplete;
+  }
+
+  // Each reduced function was found to be interesting in the context of the
+  // original versions of the other functions, so the merged result needs to
+  // be checked again.
+  auto is_valid_and_interesting =
+      [this, &tools, validator_options,
+       reductions_applied](const std::vector<uint32_t>& binary) -> bool {
+    if (!tools.Validate(binary.data(), binary.size(), validator_options)) {
+      return false;
+    }
+    num_interestingness_tests_++;
+    return interestingness_function_(binary, *reductions_applied);
+  };
+
+  std::vector<uint32_t> merged = MergeReducedFunctions(
+      *current_binary, ancestor_id_bound, reduced_functions);
+  if (is_valid_and_interesting(merged)) {
     consumer_(SPV_MSG_INFO, nullptr, {},
-              "Reached reduction step limit; stopping.");
-    return Reducer::ReductionResultStatus::kReachedStepLimit;
+              "Merged the independently reduced functions.");
+    *current_binary = std::move(merged);
+    return Reducer::ReductionResultStatus::kComplete;
   }
 
-  // The passes completed successfully, although we may still run more passes.
+  // The reduced functions interfere with one another; merge them one at a
+  // time, keeping each only if the result remains interesting.
+  consumer_(SPV_MSG_INFO, nullptr, {},
+            "The merged functions were not interesting; merging one function "
+            "at a time.");
+  for (auto& reduced_function : reduced_functions) {
+    merged = MergeReducedFunctions(*current_binary, ancestor_id_bound,
+                                   {reduced_function});
+    if (is_valid_and_interesting(merged)) {
+      *current_binary = std::move(merged);
+    }
+  }
   return Reducer::ReductionResultStatus::kComplete;
 }
 
+std::vector<uint32_t> Reducer::MergeReducedFunctions(
+    const std::vector<uint32_t>& binary, uint32_t ancestor_id_bound,
+    const std::vector<std::pair<uint32_t, const std::vector<uint32_t>*>>&
+        reduced_functions) const {
+  std::unique_ptr<opt::IRContext> merged_context =
+      BuildModule(target_env_, consumer_, binary.data(), binary.size());
+  assert(merged_context && "The binary must be valid.");
+
+  for (auto& reduced_function : reduced_functions) {
+    const uint32_t function_id = reduced_function.first;
+    std::unique_ptr<opt::IRContext> reduced_context = BuildModule(
+        target_env_, consumer_, reduced_function.second->data(),
+        reduced_function.second->size());
+    assert(reduced_context && "The reduced binary must be valid.");
+
+    // Ids that the reduction of this function introduced are given fresh ids,
+    // as the reductions of other functions may have used the same ids.
+    std::unordered_map<uint32_t, uint32_t> fresh_ids;
+    auto remap_id = [ancestor_id_bound, &fresh_ids,
+                     &merged_context](uint32_t* id) {
+      if (*id < ancestor_id_bound) {
+        return;
+      }
+      auto iter = fresh_ids.find(*id);
+      if (iter == fresh_ids.end()) {
+        iter = fresh_ids.emplace(*id, merged_context->TakeNextId()).first;
+      }
+      *id = iter->second;
+    };
+
+    // Copy over the global values (variables and undefs) that were added in
+    // support of the reduced function.
+    for (auto& inst : reduced_context->module()->types_values()) {
+      if (inst.HasResultId() && inst.result_id() >= ancestor_id_bound) {
+        std::unique_ptr<opt::Instruction> clone(
+            inst.Clone(merged_context.get()));
+        clone->ForEachId(remap_id);
+        merged_context->module()->AddGlobalValue(std::move(clone));
+      }
+    }
+
+    // Replace the function with its reduced counterpart.
+    opt::Function* reduced = nullptr;
+    for (auto& function : *reduced_context->module()) {
+      if (function.result_id() == function_id) {
+        reduced = &function;
+        break;
+      }
+    }
+    assert(reduced && "Reduction must not remove the target function.");
+    std::unique_ptr<opt::Function> clone(reduced->Clone(merged_context.get()));
+    clone->ForEachInst(
+        [&remap_id](opt::Instruction* inst) { inst->ForEachId(remap_id); },
+        true, true);
+    for (auto iter = merged_context->module()->begin();
+         iter != merged_context->module()->end(); ++iter) {
+      if (iter->result_id() == function_id) {
+        iter = iter.Erase();
+        iter.InsertBefore(std::move(clone));
+        break;
+      }
+    }
+  }
+
+  std::vector<uint32_t> result;
+  merged_context->module()->ToBinary(&result, false);
+  return result;
+}
+
+Reducer::ReductionStepOutcome Reducer::ApplyReductionStep(
+    ReductionPass* pass, spv_const_reducer_options options,
+    spv_validator_options validator_options, const SpirvTools& tools,
+    std::vector<uint32_t>* current_binary, uint32_t* const reductions_applied) {
+  // A worker of a function-parallel reduction reserves its step before taking
+  // it, so that the workers cannot overshoot the step limit together.  A step
+  // that is reserved but not taken is given back; in the meantime other
+  // workers may stop early, but never late.
+  if (shared_step_count_ != nullptr &&
+      shared_step_count_->fetch_add(1) >= options->step_limit) {
+    shared_step_count_->fetch_sub(1);
+    return ReductionStepOutcome::kReachedStepLimit;
+  }
+  auto maybe_result =
+      pass->TryApplyReduction(*current_binary, options->target_function);
+  if (maybe_result.empty()) {
+    if (shared_step_count_ != nullptr) {
+      shared_step_count_->fetch_sub(1);
+    }
+    consumer_(SPV_MSG_INFO, nullptr, {},
+              ("Pass " + pass->GetName() + " did not make a reduction step.")
+                  .c_str());
+    return ReductionStepOutcome::kNoMoreChunks;
+  }
+  bool interesting = false;
+  std::stringstream stringstream;
+  (*reductions_applied)++;
+  stringstream << "Pass " << pass->GetName() << " made reduction step "
+               << *reductions_applied << ".";
+  consumer_(SPV_MSG_INFO, nullptr, {}, (stringstream.str().c_str()));
+  if (!tools.Validate(&maybe_result[0], maybe_result.size(),
+                      validator_options)) {
+    // The reduction step went wrong and an invalid binary was produced.
+    // By design, this shouldn't happen; this is a safeguard to stop an
+    // invalid binary from being regarded as interesting.
+    consumer_(SPV_MSG_INFO, nullptr, {},
+              "Reduction step produced an invalid binary.");
+    if (options->fail_on_validation_error) {
+      // In this mode, we fail, so we update the current binary so it is
+      // output for debugging.
+      *current_binary = std::move(maybe_result);
+      return ReductionStepOutcome::kInvalid;
+    }
+  } else {
+    num_interestingness_tests_++;
+    if (interestingness_function_(maybe_result, *reductions_applied)) {
+      // Success!  The binary produced by this reduction step is
+      // interesting, so make it the binary of interest henceforth.
+      consumer_(SPV_MSG_INFO, nullptr, {}, "Reduction step succeeded.");
+      *current_binary = std::move(maybe_result);
+      interesting = true;
+    }
+  }
+  // We must call this before the next call to TryApplyReduction.
+  pass->NotifyInteresting(interesting);
+  return interesting ? ReductionStepOutcome::kInteresting
+                     : ReductionStepOutcome::kNotInteresting;
+}
+
 }  // namespace reduce
 }  // namespace spvtools
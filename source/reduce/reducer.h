@@ -15,8 +15,11 @@
 #ifndef SOURCE_REDUCE_REDUCER_H_
 #define SOURCE_REDUCE_REDUCER_H_
 
+#include <atomic>
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "source/reduce/reduction_pass.h"
 #include "spirv-tools/libspirv.hpp"
@@ -38,6 +41,27 @@ class Reducer {
     // Returned when the fail-on-validation-error option is set and a
     // reduction step yields a state that fails validation.
     kStateInvalid,
+
+    // Returned when a reduction is resumed from a checkpoint that is
+    // malformed, or that does not match the reduction passes of the reducer.
+    kCheckpointInvalid,
+  };
+
+  // Strategies for scheduling the reduction passes.
+  enum class ReductionStrategy {
+    // Passes are run in a fixed order, round after round, until a round makes
+    // no progress.  Each pass lowers its granularity by halving it at the end
+    // of each round.
+    kRoundRobin,
+
+    // Each round, passes are run in order of how productive they have been
+    // so far (bytes removed per reduction step), and passes that have no
+    // opportunities are run last.  A pass whose chunks keep failing to be
+    // interesting is moved to a finer granularity without completing its
+    // round, a pass that cannot make progress because the binary has not
+    // changed since it last completed a round at minimum granularity is
+    // skipped, and uninteresting chunks are split using binary search.
+    kAdaptive,
   };
 
   // The type for a function that will take a binary and return true if and
@@ -50,6 +74,13 @@ class Reducer {
   using InterestingnessFunction =
       std::function<bool(const std::vector<uint32_t>&, uint32_t)>;
 
+  // The type for a function that will be given checkpoints during reduction.
+  // A checkpoint is an opaque sequence of words that captures the current
+  // binary, the number of reduction steps taken and the progress of each
+  // reduction pass; it can be passed to Resume to carry on with the
+  // reduction.
+  using CheckpointFunction = std::function<void(const std::vector<uint32_t>&)>;
+
   // Constructs an instance with the given target |target_env|, which is used to
   // decode the binary to be reduced later.
   //
@@ -79,6 +110,26 @@ class Reducer {
   void SetInterestingnessFunction(
       InterestingnessFunction interestingness_function);
 
+  // Sets the strategy used to schedule reduction passes.  The default is
+  // ReductionStrategy::kRoundRobin.
+  void SetReductionStrategy(ReductionStrategy reduction_strategy);
+
+  // Sets the number of worker threads used for function-parallel reduction.
+  // If |num_threads| is greater than 1 and no target function is set, Run
+  // first reduces each function of the module independently, with up to
+  // |num_threads| functions being reduced at once, merges the reduced
+  // functions and re-checks that the merged module is interesting, before
+  // reducing the module as a whole.  In this mode the interestingness
+  // function must be safe to call concurrently from multiple threads.  The
+  // default is 1, which disables function-parallel reduction.
+  void SetNumThreads(uint32_t num_threads);
+
+  // Sets the function that will be given a checkpoint of the reduction every
+  // |checkpoint_interval| reduction steps.  Checkpoints are not taken while
+  // functions are being reduced in parallel.
+  void SetCheckpointFunction(CheckpointFunction checkpoint_function,
+                             uint32_t checkpoint_interval);
+
   // Adds all default reduction passes.
   void AddDefaultReductionPasses();
 
@@ -99,9 +150,39 @@ class Reducer {
                             spv_const_reducer_options options,
                             spv_validator_options validator_options);
 
+  // Carries on with a reduction from |checkpoint|, which must have been
+  // produced by a reducer with the same reduction passes and strategy.  The
+  // round of reduction passes that was under way when the checkpoint was
+  // taken restarts from its first pass, with each pass picking up from where
+  // it left off.  The reduced binary ends up in |binary_out|.  A status is
+  // returned.
+  ReductionResultStatus Resume(const std::vector<uint32_t>& checkpoint,
+                               std::vector<uint32_t>* binary_out,
+                               spv_const_reducer_options options,
+                               spv_validator_options validator_options);
+
  private:
-  static bool ReachedStepLimit(uint32_t current_step,
-                               spv_const_reducer_options options);
+  // Possible outcomes of attempting a single reduction step.
+  enum class ReductionStepOutcome {
+    // The pass has no more chunks to apply at its current granularity.
+    kNoMoreChunks,
+    // No step was taken because the reduction has used up its step limit;
+    // this says nothing about whether the pass could make further progress.
+    kReachedStepLimit,
+    // The reduced binary was interesting and has become the current binary.
+    kInteresting,
+    // The reduced binary was invalid or not interesting, and was discarded.
+    kNotInteresting,
+    // The reduced binary was invalid and the fail-on-validation-error option
+    // is set; the invalid binary has become the current binary.
+    kInvalid,
+  };
+
+  // Returns true if and only if |current_step| reaches the step limit of
+  // |options|, or, for a worker of a function-parallel reduction, if the
+  // steps taken by all the workers do.
+  bool ReachedStepLimit(uint32_t current_step,
+                        spv_const_reducer_options options) const;
 
   ReductionResultStatus RunPasses(
       std::vector<std::unique_ptr<ReductionPass>>* passes,
@@ -109,9 +190,101 @@ class Reducer {
       spv_validator_options validator_options, const SpirvTools& tools,
       std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
 
+  // Runs |passes| using ReductionStrategy::kRoundRobin.  Returns kComplete
+  // unless a reduction step yields an invalid binary that leads to the
+  // reduction being abandoned.
+  ReductionResultStatus RunPassesRoundRobin(
+      std::vector<std::unique_ptr<ReductionPass>>* passes,
+      spv_const_reducer_options options,
+      spv_validator_options validator_options, const SpirvTools& tools,
+      std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
+
+  // Runs |passes| using ReductionStrategy::kAdaptive.  Returns kComplete
+  // unless a reduction step yields an invalid binary that leads to the
+  // reduction being abandoned.
+  ReductionResultStatus RunPassesAdaptively(
+      std::vector<std::unique_ptr<ReductionPass>>* passes,
+      spv_const_reducer_options options,
+      spv_validator_options validator_options, const SpirvTools& tools,
+      std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
+
+  // Resets per-run state before a reduction is run or resumed.
+  void PrepareForRun();
+
+  // Runs the reduction passes, unless |skip_passes| holds, and then the
+  // cleanup passes, on |current_binary|, provided |status| is kComplete.
+  // Reports on the reduction, relative to a binary of |original_size| words,
+  // moves the result into |binary_out| and returns the final status.
+  ReductionResultStatus CompleteRun(ReductionResultStatus status,
+                                    bool skip_passes, size_t original_size,
+                                    spv_const_reducer_options options,
+                                    spv_validator_options validator_options,
+                                    const SpirvTools& tools,
+                                    std::vector<uint32_t>* current_binary,
+                                    uint32_t* reductions_applied,
+                                    std::vector<uint32_t>* binary_out);
+
+  // Hands a checkpoint to |checkpoint_function_| if one is due, given that
+  // |passes| are being run.
+  void MaybeCheckpoint(
+      const std::vector<std::unique_ptr<ReductionPass>>* passes,
+      const std::vector<uint32_t>& current_binary,
+      uint32_t reductions_applied) const;
+
+  // Restores the progress of the reduction passes from |checkpoint|, and
+  // yields the binary, the number of reduction steps taken and whether the
+  // cleanup passes were being run.  Returns false if the checkpoint is
+  // malformed or does not match the reduction passes.
+  bool RestoreCheckpoint(const std::vector<uint32_t>& checkpoint,
+                         std::vector<uint32_t>* binary,
+                         uint32_t* reductions_applied,
+                         bool* running_cleanup_passes);
+
+  // Reduces each function of |current_binary| independently, using up to
+  // |num_threads_| worker threads, and merges the reduced functions into
+  // |current_binary| as long as the result remains interesting.
+  ReductionResultStatus RunFunctionParallelReduction(
+      spv_const_reducer_options options,
+      spv_validator_options validator_options, const SpirvTools& tools,
+      std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
+
+  // Returns the binary obtained from |binary| by replacing, for each pair in
+  // |reduced_functions|, the function whose id is the first component with the
+  // function of the same id in the binary that is the second component.  The
+  // reduced binaries must have been obtained from a common ancestor whose id
+  // bound was |ancestor_id_bound|, by reductions that only changed the
+  // function in question and added global values; ids at or above the bound
+  // are given fresh ids.
+  std::vector<uint32_t> MergeReducedFunctions(
+      const std::vector<uint32_t>& binary, uint32_t ancestor_id_bound,
+      const std::vector<std::pair<uint32_t, const std::vector<uint32_t>*>>&
+          reduced_functions) const;
+
+  // Asks |pass| for its next chunk of reductions, and checks whether the
+  // resulting binary is valid and interesting, updating |current_binary| and
+  // |reductions_applied| accordingly.
+  ReductionStepOutcome ApplyReductionStep(
+      ReductionPass* pass, spv_const_reducer_options options,
+      spv_validator_options validator_options, const SpirvTools& tools,
+      std::vector<uint32_t>* current_binary, uint32_t* reductions_applied);
+
   const spv_target_env target_env_;
   MessageConsumer consumer_;
   InterestingnessFunction interestingness_function_;
+  ReductionStrategy reduction_strategy_;
+  uint32_t num_threads_;
+  CheckpointFunction checkpoint_function_;
+  uint32_t checkpoint_interval_;
+
+  // The number of times |interestingness_function_| has been invoked during
+  // the current run; used to report the efficiency of the reduction.
+  uint32_t num_interestingness_tests_;
+
+  // For a worker of a function-parallel reduction, the number of reduction
+  // steps taken so far by the whole reduction, shared by all the workers so
+  // that together they respect the step limit; null otherwise.
+  std::atomic<uint32_t>* shared_step_count_;
+
   std::vector<std::unique_ptr<ReductionPass>> passes_;
   std::vector<std::unique_ptr<ReductionPass>> cleanup_passes_;
 };
@@ -15,12 +15,21 @@
 #include "source/reduce/reduction_pass.h"
 
 #include <algorithm>
+#include <cstddef>
 
 #include "source/opt/build_module.h"
 
 namespace spvtools {
 namespace reduce {
 
+std::unique_ptr<ReductionPass> ReductionPass::CloneWithFreshState() const {
+  std::unique_ptr<ReductionPass> result(
+      new ReductionPass(target_env_, finder_));
+  result->SetMessageConsumer(consumer_);
+  result->SetBinarySplitting(binary_splitting_);
+  return result;
+}
+
 std::vector<uint32_t> ReductionPass::TryApplyReduction(
     const std::vector<uint32_t>& binary, uint32_t target_function) {
   // We represent modules as binaries because (a) attempts at reduction need to
@@ -35,6 +44,7 @@ std::vector<uint32_t> ReductionPass::TryApplyReduction(
 
   std::vector<std::unique_ptr<ReductionOpportunity>> opportunities =
       finder_->GetAvailableOpportunities(context.get(), target_function);
+  num_opportunities_ = static_cast<uint32_t>(opportunities.size());
 
   // There is no point in having a granularity larger than the number of
   // opportunities, so reduce the granularity in this case.
@@ -49,13 +59,13 @@ std::vector<uint32_t> ReductionPass::TryApplyReduction(
     // the end of the round for this pass, so reset the index and decrease the
     // granularity for the next round. Return an empty vector to signal the end
     // of the round.
-    index_ = 0;
-    granularity_ = std::max((uint32_t)1, granularity_ / 2);
+    SkipToNextGranularity();
     return std::vector<uint32_t>();
   }
 
+  const uint32_t chunk_size = GetChunkSize();
   for (uint32_t i = index_;
-       i < std::min(index_ + granularity_, (uint32_t)opportunities.size());
+       i < std::min(index_ + chunk_size, (uint32_t)opportunities.size());
        ++i) {
     opportunities[i]->TryToApply();
   }
@@ -74,12 +84,89 @@ bool ReductionPass::ReachedMinimumGranularity() const {
   return granularity_ == 1;
 }
 
+void ReductionPass::SkipToNextGranularity() {
+  index_ = 0;
+  granularity_ = std::max((uint32_t)1, granularity_ / 2);
+  pending_chunk_sizes_.clear();
+}
+
+void ReductionPass::SaveState(std::vector<uint32_t>* words) const {
+  words->push_back(index_);
+  words->push_back(granularity_);
+  words->push_back(static_cast<uint32_t>(pending_chunk_sizes_.size()));
+  words->insert(words->end(), pending_chunk_sizes_.begin(),
+                pending_chunk_sizes_.end());
+}
+
+bool ReductionPass::RestoreState(const std::vector<uint32_t>& words,
+                                 size_t* offset) {
+  if (words.size() < *offset + 3) {
+    return false;
+  }
+  const uint32_t index = words[*offset];
+  const uint32_t granularity = words[*offset + 1];
+  const uint32_t num_pending_chunks = words[*offset + 2];
+  if (granularity == 0 ||
+      words.size() - (*offset + 3) < static_cast<size_t>(num_pending_chunks)) {
+    return false;
+  }
+  auto pending_begin = words.begin() + static_cast<std::ptrdiff_t>(*offset + 3);
+  auto pending_end = pending_begin + num_pending_chunks;
+  if (std::find(pending_begin, pending_end, 0u) != pending_end) {
+    return false;
+  }
+  index_ = index;
+  granularity_ = granularity;
+  // Chunks that were pending from a split are only meaningful if binary
+  // splitting is still in use.
+  if (binary_splitting_) {
+    pending_chunk_sizes_.assign(pending_begin, pending_end);
+  } else {
+    pending_chunk_sizes_.clear();
+  }
+  *offset += 3 + num_pending_chunks;
+  return true;
+}
+
+uint32_t ReductionPass::GetChunkSize() const {
+  return pending_chunk_sizes_.empty() ? granularity_
+                                      : pending_chunk_sizes_.back();
+}
+
 std::string ReductionPass::GetName() const { return finder_->GetName(); }
 
 void ReductionPass::NotifyInteresting(bool interesting) {
-  if (!interesting) {
-    index_ += granularity_;
+  if (!binary_splitting_) {
+    if (!interesting) {
+      index_ += granularity_;
+    }
+    return;
+  }
+
+  // The chunk that was just tried may have been cut short by the end of the
+  // available opportunities.
+  assert(index_ < num_opportunities_ && "No chunk was applied.");
+  const uint32_t chunk_size =
+      std::min(GetChunkSize(), num_opportunities_ - index_);
+  if (!pending_chunk_sizes_.empty()) {
+    pending_chunk_sizes_.pop_back();
   }
+
+  if (interesting) {
+    // The opportunities in the chunk have been used up, so the opportunities
+    // that followed the chunk are expected to now start at |index_|.
+    return;
+  }
+
+  if (chunk_size == 1) {
+    // A single opportunity cannot be split any further; move past it.
+    index_++;
+    return;
+  }
+
+  // Try the first half of the chunk next, followed by the second half.
+  pending_chunk_sizes_.push_back(chunk_size - chunk_size / 2);
+  pending_chunk_sizes_.push_back(chunk_size / 2);
 }
 
 }  // namespace reduce
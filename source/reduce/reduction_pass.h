@@ -16,6 +16,8 @@
 #define SOURCE_REDUCE_REDUCTION_PASS_H_
 
 #include <limits>
+#include <memory>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 #include "source/reduce/reduction_opportunity_finder.h"
@@ -31,6 +33,12 @@ namespace reduce {
 // opportunities at a given granularity.  When an iteration over available
 // opportunities completes, the granularity is reduced and iteration starts
 // again, until the minimum granularity is reached.
+//
+// Optionally, a pass can use binary-search splitting: when a chunk of
+// opportunities turns out not to be interesting, the chunk is split in half
+// and each half is tried in turn, recursively, before the pass moves past the
+// chunk.  This lets a pass zoom in on the removable parts of a large chunk
+// without having to wait for the granularity to be lowered for a whole round.
 class ReductionPass {
  public:
   // Constructs a reduction pass with a given target environment, |target_env|,
@@ -40,7 +48,14 @@ class ReductionPass {
       : target_env_(target_env),
         finder_(std::move(finder)),
         index_(0),
-        granularity_(std::numeric_limits<uint32_t>::max()) {}
+        granularity_(std::numeric_limits<uint32_t>::max()),
+        binary_splitting_(false),
+        num_opportunities_(0) {}
+
+  // Returns a new reduction pass that shares this pass's finder and binary
+  // splitting setting, but starts from the initial index and granularity.
+  // Finders are stateless, so the two passes can be used concurrently.
+  std::unique_ptr<ReductionPass> CloneWithFreshState() const;
 
   // Applies the reduction pass to the given binary by applying a "chunk" of
   // reduction opportunities. Returns the new binary if a chunk was applied; in
@@ -68,16 +83,65 @@ class ReductionPass {
   // applied has reached a minimum.
   bool ReachedMinimumGranularity() const;
 
+  // Returns the granularity with which reduction opportunities are currently
+  // being applied.
+  uint32_t GetGranularity() const { return granularity_; }
+
+  // Returns the number of reduction opportunities that were available the
+  // last time TryApplyReduction was invoked.
+  uint32_t GetNumOpportunities() const { return num_opportunities_; }
+
+  // Abandons the remaining chunks at the current granularity: the index is
+  // reset and the granularity lowered, exactly as if the end of the round had
+  // been reached.
+  void SkipToNextGranularity();
+
+  // Appends the progress of the pass -- its index, granularity and the chunks
+  // that remain to be tried for a chunk that is being split -- to |words|, so
+  // that it can later be restored with RestoreState.
+  void SaveState(std::vector<uint32_t>* words) const;
+
+  // Restores progress saved by SaveState from |words|, starting at
+  // |*offset|, and advances |*offset| past it.  Returns false, leaving the
+  // pass unchanged, if the words do not describe a valid state.
+  bool RestoreState(const std::vector<uint32_t>& words, size_t* offset);
+
+  // Enables or disables binary-search splitting of uninteresting chunks.
+  void SetBinarySplitting(bool binary_splitting) {
+    binary_splitting_ = binary_splitting;
+    pending_chunk_sizes_.clear();
+  }
+
   // Returns the name associated with this reduction pass (based on its
   // associated finder).
   std::string GetName() const;
 
  private:
+  // Constructs a reduction pass that shares |finder| with other passes.
+  ReductionPass(const spv_target_env target_env,
+                std::shared_ptr<const ReductionOpportunityFinder> finder)
+      : target_env_(target_env),
+        finder_(std::move(finder)),
+        index_(0),
+        granularity_(std::numeric_limits<uint32_t>::max()),
+        binary_splitting_(false),
+        num_opportunities_(0) {}
+
+  // Returns the number of opportunities that the next chunk should contain.
+  uint32_t GetChunkSize() const;
+
   const spv_target_env target_env_;
-  const std::unique_ptr<ReductionOpportunityFinder> finder_;
+  const std::shared_ptr<const ReductionOpportunityFinder> finder_;
   MessageConsumer consumer_;
   uint32_t index_;
   uint32_t granularity_;
+  bool binary_splitting_;
+  uint32_t num_opportunities_;
+
+  // When binary splitting is enabled, holds the sizes of the chunks that
+  // remain to be tried, starting at |index_|, for the chunk currently being
+  // split.  The back of the vector is the size of the next chunk to try.
+  std::vector<uint32_t> pending_chunk_sizes_;
 };
 
 }  // namespace reduce
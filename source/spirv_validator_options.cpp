@@ -48,6 +48,24 @@ bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* type) {
   return true;
 }
 
+bool spvParseWorkLimitsOptions(const char* s,
+                               spv_validator_work_limit* type) {
+  auto match = [s](const char* b) {
+    return s && (0 == strncmp(s, b, strlen(b)));
+  };
+  if (match("--max-cfg-edges")) {
+    *type = spv_validator_work_limit_max_cfg_edges;
+  } else if (match("--max-dominance-queries")) {
+    *type = spv_validator_work_limit_max_dominance_queries;
+  } else if (match("--max-type-traversal")) {
+    *type = spv_validator_work_limit_max_type_traversal;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
 spv_validator_options spvValidatorOptionsCreate(void) {
   return new spv_validator_options_t;
 }
@@ -125,3 +143,35 @@ void spvValidatorOptionsSetAllowLocalSizeId(spv_validator_options options,
                                             bool val) {
   options->allow_localsizeid = val;
 }
+
+void spvValidatorOptionsSetProfile(spv_validator_options options,
+                                   spv_validator_profile profile) {
+  options->profile = profile;
+}
+
+void spvValidatorOptionsSetStreaming(spv_validator_options options,
+                                     bool val) {
+  options->streaming = val;
+}
+
+void spvValidatorOptionsSetWorkLimit(spv_validator_options options,
+                                     spv_validator_work_limit limit_type,
+                                     uint32_t limit) {
+  assert(options && "Validator options object may not be Null");
+  switch (limit_type) {
+    case spv_validator_work_limit_max_cfg_edges:
+      options->work_limits_.max_cfg_edges = limit;
+      break;
+    case spv_validator_work_limit_max_dominance_queries:
+      options->work_limits_.max_dominance_queries = limit;
+      break;
+    case spv_validator_work_limit_max_type_traversal:
+      options->work_limits_.max_type_traversal = limit;
+      break;
+  }
+}
+
+void spvValidatorOptionsSetCollectStats(spv_validator_options options,
+                                        bool val) {
+  options->collect_stats = val;
+}
@@ -21,6 +21,10 @@
 // returns the Enum for option in this case). Returns false otherwise.
 bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* limit);
 
+// Return true if the command line option for the validator work limit is valid
+// (Also returns the Enum for option in this case). Returns false otherwise.
+bool spvParseWorkLimitsOptions(const char* s, spv_validator_work_limit* limit);
+
 // Default initialization of this structure is to the default Universal Limits
 // described in the SPIR-V Spec.
 struct validator_universal_limits_t {
@@ -35,11 +39,20 @@ struct validator_universal_limits_t {
   uint32_t max_id_bound{0x3FFFFF};
 };
 
+// Default initialization of this structure does not bound the work of the
+// validator.  A limit of 0 is no limit.
+struct validator_work_limits_t {
+  uint32_t max_cfg_edges{0};
+  uint32_t max_dominance_queries{0};
+  uint32_t max_type_traversal{0};
+};
+
 // Manages command line options passed to the SPIR-V Validator. New struct
 // members may be added for any new option.
 struct spv_validator_options_t {
   spv_validator_options_t()
       : universal_limits_(),
+        work_limits_(),
         relax_struct_store(false),
         relax_logical_pointer(false),
         relax_block_layout(false),
@@ -48,9 +61,13 @@ struct spv_validator_options_t {
         workgroup_scalar_block_layout(false),
         skip_block_layout(false),
         allow_localsizeid(false),
-        before_hlsl_legalization(false) {}
+        before_hlsl_legalization(false),
+        collect_stats(false),
+        profile(SPV_VAL_PROFILE_FULL),
+        streaming(false) {}
 
   validator_universal_limits_t universal_limits_;
+  validator_work_limits_t work_limits_;
   bool relax_struct_store;
   bool relax_logical_pointer;
   bool relax_block_layout;
@@ -60,6 +77,9 @@ struct spv_validator_options_t {
   bool skip_block_layout;
   bool allow_localsizeid;
   bool before_hlsl_legalization;
+  bool collect_stats;
+  spv_validator_profile profile;
+  bool streaming;
 };
 
 #endif  // SOURCE_SPIRV_VALIDATOR_OPTIONS_H_
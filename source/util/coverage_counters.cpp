@@ -0,0 +1,137 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/coverage_counters.h"
+
+#include <cassert>
+
+namespace spvtools {
+namespace utils {
+
+thread_local CoverageRecorder* CoverageRecorder::current_ = nullptr;
+
+CoverageRecorder::CoverageRecorder() : previous_(current_) { current_ = this; }
+
+CoverageRecorder::~CoverageRecorder() {
+  assert(current_ == this && "Coverage recorders must be destroyed in order.");
+  current_ = previous_;
+}
+
+const uint32_t CoverageCounters::kMaxCoveragePoints;
+const uint32_t CoverageCounters::kCountsPerChunk;
+const uint32_t CoverageCounters::kNumChunks;
+
+CoverageCounters::CoverageCounters() {
+  for (uint32_t i = 0; i < kNumChunks; i++) {
+    count_chunks_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+std::atomic<uint64_t>* CoverageCounters::GetOrAllocateChunk(
+    uint32_t chunk_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::atomic<uint64_t>* chunk =
+      count_chunks_[chunk_index].load(std::memory_order_relaxed);
+  if (chunk == nullptr) {
+    chunk = new std::atomic<uint64_t>[kCountsPerChunk];
+    for (uint32_t i = 0; i < kCountsPerChunk; i++) {
+      chunk[i].store(0, std::memory_order_relaxed);
+    }
+    count_chunks_[chunk_index].store(chunk, std::memory_order_release);
+  }
+  return chunk;
+}
+
+CoverageCounters& CoverageCounters::Get() {
+  // Deliberately leaked, so that coverage points hit during static destruction
+  // remain safe.
+  static CoverageCounters* counters = new CoverageCounters();
+  return *counters;
+}
+
+bool CoverageCounters::Enabled() {
+#if defined(SPIRV_COVERAGE_COUNTERS_ENABLED)
+  return true;
+#else
+  return false;
+#endif
+}
+
+uint32_t CoverageCounters::Register(const std::string& name) {
+  uint32_t index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = index_for_name_.find(name);
+    if (existing != index_for_name_.end()) {
+      return existing->second;
+    }
+    index = static_cast<uint32_t>(names_.size());
+    names_.push_back(name);
+    index_for_name_[name] = index;
+  }
+  // Allocate the count of the new point before it can be hit.
+  if (index < kMaxCoveragePoints) {
+    GetOrAllocateChunk(index / kCountsPerChunk);
+  }
+  return index;
+}
+
+uint32_t CoverageCounters::GetNumPoints() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<uint32_t>(names_.size());
+}
+
+std::string CoverageCounters::GetName(uint32_t index) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  assert(index < names_.size() && "Unknown coverage point.");
+  return names_[index];
+}
+
+std::vector<uint64_t> CoverageCounters::GetCounts() const {
+  const uint32_t num_points = GetNumPoints();
+  std::vector<uint64_t> result;
+  result.reserve(num_points);
+  for (uint32_t i = 0; i < num_points; i++) {
+    result.push_back(GetCount(i));
+  }
+  return result;
+}
+
+void CoverageCounters::Reset() {
+  for (uint32_t i = 0; i < kNumChunks; i++) {
+    std::atomic<uint64_t>* chunk =
+        count_chunks_[i].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (uint32_t j = 0; j < kCountsPerChunk; j++) {
+      chunk[j].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+const uint32_t CoveragePointFamily::kNotCached;
+
+CoveragePointFamily::CoveragePointFamily(uint32_t num_keys,
+                                         uint32_t num_subkeys)
+    : num_keys_(num_keys),
+      num_subkeys_(num_subkeys),
+      indices_(new std::atomic<uint32_t>[num_keys * num_subkeys]) {
+  for (uint32_t i = 0; i < num_keys * num_subkeys; i++) {
+    indices_[i].store(kNotCached, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace utils
+}  // namespace spvtools
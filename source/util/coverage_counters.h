@@ -0,0 +1,289 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Contains lightweight counters recording which parts of the optimizer and
+// validator have been exercised, for use by coverage-guided fuzzing.
+
+#ifndef SOURCE_UTIL_COVERAGE_COUNTERS_H_
+#define SOURCE_UTIL_COVERAGE_COUNTERS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(SPIRV_COVERAGE_COUNTERS_ENABLED)
+
+// Records a hit of the coverage point named by the string literal |name|.
+// The point is registered the first time control reaches the macro while
+// coverage is recorded, after which a hit costs a single relaxed atomic
+// increment.
+#define SPIRV_COVERAGE_POINT(name)                                            \
+  do {                                                                        \
+    if (spvtools::utils::CoverageRecorder::Current() != nullptr) {            \
+      static const uint32_t spirv_coverage_point_index =                      \
+          spvtools::utils::CoverageCounters::Get().Register(name);            \
+      spvtools::utils::CoverageCounters::Get().Hit(                           \
+          spirv_coverage_point_index);                                        \
+    }                                                                         \
+  } while (false)
+
+// Records a hit of the coverage point named by the std::string |name|, which
+// may vary between executions of the macro.  This requires a look-up of the
+// name on every hit, so it should only be used where hits are rare; see
+// SPIRV_COVERAGE_POINT_KEYED otherwise.  |name| is only evaluated while
+// coverage is recorded.
+#define SPIRV_COVERAGE_POINT_DYNAMIC(name)                             \
+  do {                                                                 \
+    if (spvtools::utils::CoverageRecorder::Current() != nullptr) {     \
+      spvtools::utils::CoverageCounters::Get().Hit(                    \
+          spvtools::utils::CoverageCounters::Get().Register(name));    \
+    }                                                                  \
+  } while (false)
+
+// Records a hit of the coverage point identified by |key| and |subkey| among
+// the points of this macro invocation, caching the index of the points whose
+// key is less than |num_keys| and whose subkey is less than |num_subkeys|.
+// |name| is the std::string naming the point; it is only evaluated when the
+// point is registered or lies outside the cached range.
+#define SPIRV_COVERAGE_POINT_KEYED(num_keys, num_subkeys, key, subkey, name) \
+  do {                                                                       \
+    if (spvtools::utils::CoverageRecorder::Current() != nullptr) {           \
+      static spvtools::utils::CoveragePointFamily spirv_coverage_family(     \
+          num_keys, num_subkeys);                                            \
+      spirv_coverage_family.Hit(static_cast<uint32_t>(key),                  \
+                                static_cast<uint32_t>(subkey),               \
+                                [&]() -> std::string { return name; });      \
+    }                                                                        \
+  } while (false)
+
+#else  // defined(SPIRV_COVERAGE_COUNTERS_ENABLED)
+
+#define SPIRV_COVERAGE_POINT(name) \
+  do {                             \
+  } while (false)
+#define SPIRV_COVERAGE_POINT_DYNAMIC(name) \
+  do {                                     \
+  } while (false)
+#define SPIRV_COVERAGE_POINT_KEYED(num_keys, num_subkeys, key, subkey, name) \
+  do {                                                                       \
+  } while (false)
+
+#endif  // defined(SPIRV_COVERAGE_COUNTERS_ENABLED)
+
+namespace spvtools {
+namespace utils {
+
+// Records which coverage points the current thread hits while the recorder is
+// alive.  The coverage point macros do nothing unless a recorder is alive on
+// the current thread, so that instrumented code only pays for a thread-local
+// load when nobody is measuring coverage, and so that clients measuring
+// coverage on several threads only see the points hit by their own work.
+// Recorders may be nested, in which case hits are recorded by the innermost
+// one only.
+class CoverageRecorder {
+ public:
+  // Installs this recorder as the recorder of the current thread.
+  CoverageRecorder();
+
+  // Restores the recorder that was installed when this one was created.  Must
+  // be called on the thread that created this recorder.
+  ~CoverageRecorder();
+
+  CoverageRecorder(const CoverageRecorder&) = delete;
+  CoverageRecorder& operator=(const CoverageRecorder&) = delete;
+
+  // Returns the recorder of the current thread, or nullptr if there is none.
+  static CoverageRecorder* Current() { return current_; }
+
+  // Records a hit of the coverage point with index |index|.
+  void Record(uint32_t index) {
+    if (index >= hit_points_.size()) {
+      hit_points_.resize(index + 1, false);
+    }
+    hit_points_[index] = true;
+  }
+
+  // Returns true if and only if the coverage point with index |index| has
+  // been recorded.
+  bool WasHit(uint32_t index) const {
+    return index < hit_points_.size() && hit_points_[index];
+  }
+
+  // Returns a bound on the indices of the recorded coverage points.
+  uint32_t GetNumPoints() const {
+    return static_cast<uint32_t>(hit_points_.size());
+  }
+
+ private:
+  // The recorder of each thread.
+  static thread_local CoverageRecorder* current_;
+
+  // The recorder that was installed when this one was created.
+  CoverageRecorder* const previous_;
+
+  // For each coverage point, records whether it has been hit.
+  std::vector<bool> hit_points_;
+};
+
+// A process-wide registry of named coverage points, each with a hit counter.
+// Coverage points are placed in the code with the SPIRV_COVERAGE_POINT*
+// macros, which do nothing unless SPIRV_COVERAGE_COUNTERS_ENABLED is defined,
+// so that the counters cost nothing in regular builds, and which only hit
+// their point while a CoverageRecorder is alive on the current thread.  The
+// registry itself is always available, so that clients can query it
+// regardless of how the library was built; without instrumentation, the macros
+// never hit any point.
+//
+// All methods are thread-safe.
+class CoverageCounters {
+ public:
+  // The maximum number of distinct coverage points.  Hits of points registered
+  // beyond this limit are not recorded.
+  static const uint32_t kMaxCoveragePoints = 1 << 16;
+
+  // Returns the process-wide registry.
+  static CoverageCounters& Get();
+
+  // Returns true if and only if the library was built with its coverage points
+  // enabled.
+  static bool Enabled();
+
+  // Returns the index of the coverage point named |name|, registering it if it
+  // has not been seen before.
+  uint32_t Register(const std::string& name);
+
+  // Records a hit of the coverage point with index |index|, both in the hit
+  // counts and in the recorder of the current thread, if any.
+  void Hit(uint32_t index) {
+    if (index < kMaxCoveragePoints) {
+      std::atomic<uint64_t>* chunk =
+          count_chunks_[index / kCountsPerChunk].load(
+              std::memory_order_acquire);
+      if (chunk == nullptr) {
+        chunk = GetOrAllocateChunk(index / kCountsPerChunk);
+      }
+      chunk[index % kCountsPerChunk].fetch_add(1, std::memory_order_relaxed);
+      if (CoverageRecorder* recorder = CoverageRecorder::Current()) {
+        recorder->Record(index);
+      }
+    }
+  }
+
+  // Returns the number of coverage points that have been registered.
+  uint32_t GetNumPoints() const;
+
+  // Returns the name of the coverage point with index |index|, which must have
+  // been registered.
+  std::string GetName(uint32_t index) const;
+
+  // Returns the number of times the coverage point with index |index| has been
+  // hit.
+  uint64_t GetCount(uint32_t index) const {
+    if (index >= kMaxCoveragePoints) {
+      return 0;
+    }
+    const std::atomic<uint64_t>* chunk =
+        count_chunks_[index / kCountsPerChunk].load(std::memory_order_acquire);
+    return chunk == nullptr
+               ? 0
+               : chunk[index % kCountsPerChunk].load(std::memory_order_relaxed);
+  }
+
+  // Returns the hit counts of all registered coverage points, indexed by
+  // coverage point.
+  std::vector<uint64_t> GetCounts() const;
+
+  // Resets the hit counts of all coverage points to zero.  Registered points
+  // remain registered.
+  void Reset();
+
+ private:
+  // The hit counts are allocated in chunks of this many counts, as points are
+  // registered, so that a process that never registers a point does not pay
+  // for the counts of all possible points.
+  static const uint32_t kCountsPerChunk = 1 << 10;
+  static const uint32_t kNumChunks = kMaxCoveragePoints / kCountsPerChunk;
+
+  CoverageCounters();
+
+  // Returns the chunk of hit counts with index |chunk_index|, allocating it if
+  // this has not been done yet.
+  std::atomic<uint64_t>* GetOrAllocateChunk(uint32_t chunk_index);
+
+  // Guards |names_|, |index_for_name_| and the allocation of chunks of hit
+  // counts.
+  mutable std::mutex mutex_;
+
+  // The names of the registered coverage points, indexed by coverage point.
+  std::vector<std::string> names_;
+
+  // Maps each registered name to its index.
+  std::unordered_map<std::string, uint32_t> index_for_name_;
+
+  // The hit counts, one per possible coverage point, in chunks that are null
+  // until allocated.  A chunk is never freed once allocated, so that hits
+  // never race with its release; the registry itself is never destroyed.
+  std::atomic<std::atomic<uint64_t>*> count_chunks_[kNumChunks];
+};
+
+// A family of coverage points identified by a pair of small integers, such as
+// an opcode and the index of a rule applying to it.  The index of each point
+// is cached when it is first hit, so that later hits need no look-up of its
+// name.  Points whose key or subkey lie outside the cached range are looked
+// up by name on every hit.
+class CoveragePointFamily {
+ public:
+  // Creates a family caching the points whose key is less than |num_keys| and
+  // whose subkey is less than |num_subkeys|.
+  CoveragePointFamily(uint32_t num_keys, uint32_t num_subkeys);
+
+  // Records a hit of the point for |key| and |subkey|.  |get_name| returns the
+  // name of the point; it is only called if the index of the point is not
+  // cached.
+  template <typename NameFunction>
+  void Hit(uint32_t key, uint32_t subkey, NameFunction get_name) {
+    CoverageCounters& counters = CoverageCounters::Get();
+    if (key >= num_keys_ || subkey >= num_subkeys_) {
+      counters.Hit(counters.Register(get_name()));
+      return;
+    }
+    std::atomic<uint32_t>& cached = indices_[key * num_subkeys_ + subkey];
+    uint32_t index = cached.load(std::memory_order_relaxed);
+    if (index == kNotCached) {
+      // Threads racing to register the point get the same index.
+      index = counters.Register(get_name());
+      cached.store(index, std::memory_order_relaxed);
+    }
+    counters.Hit(index);
+  }
+
+ private:
+  // Marks the points whose index is not cached yet.
+  static const uint32_t kNotCached = UINT32_MAX;
+
+  const uint32_t num_keys_;
+  const uint32_t num_subkeys_;
+
+  // The cached index of each point, indexed by key then subkey.
+  std::unique_ptr<std::atomic<uint32_t>[]> indices_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_COVERAGE_COUNTERS_H_
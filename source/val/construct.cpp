@@ -136,7 +136,7 @@ bool Construct::IsStructuredExit(ValidationState_t& _, BasicBlock* dest) const {
   if (type() == ConstructType::kLoop) {
     auto header = entry_block();
     auto terminator = header->terminator();
-    auto index = terminator - &_.ordered_instructions()[0];
+    auto index = terminator->LineNum() - 1;
     auto merge_inst = &_.ordered_instructions()[index - 1];
     auto merge_block_id = merge_inst->GetOperandAs<uint32_t>(0u);
     auto continue_block_id = merge_inst->GetOperandAs<uint32_t>(1u);
@@ -147,7 +147,7 @@ bool Construct::IsStructuredExit(ValidationState_t& _, BasicBlock* dest) const {
     auto loop_construct = corresponding_constructs()[0];
     auto header = loop_construct->entry_block();
     auto terminator = header->terminator();
-    auto index = terminator - &_.ordered_instructions()[0];
+    auto index = terminator->LineNum() - 1;
     auto merge_inst = &_.ordered_instructions()[index - 1];
     auto merge_block_id = merge_inst->GetOperandAs<uint32_t>(0u);
     if (dest == header || dest->id() == merge_block_id) {
@@ -179,7 +179,7 @@ bool Construct::IsStructuredExit(ValidationState_t& _, BasicBlock* dest) const {
     auto block = NextBlock(header);
     while (block) {
       auto terminator = block->terminator();
-      auto index = terminator - &_.ordered_instructions()[0];
+      auto index = terminator->LineNum() - 1;
       auto merge_inst = &_.ordered_instructions()[index - 1];
       if (merge_inst->opcode() == SpvOpLoopMerge ||
           (header->terminator()->opcode() != SpvOpSwitch &&
@@ -32,6 +32,40 @@ namespace val {
 // Universal Limit of ResultID + 1
 static const uint32_t kInvalidId = 0x400000;
 
+uint32_t ExecutionModelMask(SpvExecutionModel model) {
+  switch (model) {
+    case SpvExecutionModelVertex:
+    case SpvExecutionModelTessellationControl:
+    case SpvExecutionModelTessellationEvaluation:
+    case SpvExecutionModelGeometry:
+    case SpvExecutionModelFragment:
+    case SpvExecutionModelGLCompute:
+    case SpvExecutionModelKernel:
+      return 1u << model;
+    case SpvExecutionModelTaskNV:
+      return 1u << 7;
+    case SpvExecutionModelMeshNV:
+      return 1u << 8;
+    case SpvExecutionModelRayGenerationKHR:
+    case SpvExecutionModelIntersectionKHR:
+    case SpvExecutionModelAnyHitKHR:
+    case SpvExecutionModelClosestHitKHR:
+    case SpvExecutionModelMissKHR:
+    case SpvExecutionModelCallableKHR:
+      return 1u << (9 + (model - SpvExecutionModelRayGenerationKHR));
+    default:
+      return 1u << 31;
+  }
+}
+
+uint32_t ExecutionModelMask(std::initializer_list<SpvExecutionModel> models) {
+  uint32_t mask = 0;
+  for (const auto model : models) {
+    mask |= ExecutionModelMask(model);
+  }
+  return mask;
+}
+
 Function::Function(uint32_t function_id, uint32_t result_type_id,
                    SpvFunctionControlMask function_control,
                    uint32_t function_type_id)
@@ -373,23 +407,48 @@ int Function::GetBlockDepth(BasicBlock* bb) {
 
 void Function::RegisterExecutionModelLimitation(SpvExecutionModel model,
                                                 const std::string& message) {
-  execution_model_limitations_.push_back(
-      [model, message](SpvExecutionModel in_model, std::string* out_message) {
-        if (model != in_model) {
-          if (out_message) {
-            *out_message = message;
-          }
-          return false;
-        }
-        return true;
-      });
+  RegisterExecutionModelLimitation(ExecutionModelMask(model), message, "");
+}
+
+void Function::RegisterExecutionModelLimitation(uint32_t allowed_models,
+                                                std::string prefix,
+                                                const char* message,
+                                                const char* detail) {
+  // Instructions with the same limitation tend to be used many times in a
+  // function, so only keep the first registration.
+  for (const auto& limitation : execution_model_mask_limitations_) {
+    if (limitation.allowed_models == allowed_models &&
+        limitation.message == message && limitation.detail == detail &&
+        limitation.prefix == prefix) {
+      return;
+    }
+  }
+  allowed_execution_models_ &= allowed_models;
+  execution_model_mask_limitations_.push_back(
+      {allowed_models, std::move(prefix), message, detail});
 }
 
 bool Function::IsCompatibleWithExecutionModel(SpvExecutionModel model,
                                               std::string* reason) const {
-  bool return_value = true;
+  const uint32_t model_mask = ExecutionModelMask(model);
+  const bool is_allowed = (allowed_execution_models_ & model_mask) != 0;
+  if (is_allowed && execution_model_limitations_.empty()) return true;
+  if (!is_allowed && !reason) return false;
+
+  bool return_value = is_allowed;
   std::stringstream ss_reason;
 
+  if (!is_allowed) {
+    for (const auto& limitation : execution_model_mask_limitations_) {
+      if (limitation.allowed_models & model_mask) continue;
+      const std::string message = limitation.prefix + limitation.message +
+                                  (limitation.detail ? limitation.detail : "");
+      if (!message.empty()) {
+        ss_reason << message << "\n";
+      }
+    }
+  }
+
   for (const auto& is_compatible : execution_model_limitations_) {
     std::string message;
     if (!is_compatible(model, &message)) {
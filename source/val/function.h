@@ -16,6 +16,7 @@
 #define SOURCE_VAL_FUNCTION_H_
 
 #include <functional>
+#include <initializer_list>
 #include <list>
 #include <map>
 #include <set>
@@ -43,6 +44,14 @@ struct bb_constr_type_pair_hash {
   }
 };
 
+/// Returns the bit that represents |model| in execution model masks.
+/// Execution models that have no bit of their own share the most significant
+/// bit.
+uint32_t ExecutionModelMask(SpvExecutionModel model);
+
+/// Returns the execution model mask of the given execution models.
+uint32_t ExecutionModelMask(std::initializer_list<SpvExecutionModel> models);
+
 enum class FunctionDecl {
   kFunctionDeclUnknown,      /// < Unknown function declaration
   kFunctionDeclDeclaration,  /// < Function declaration
@@ -208,6 +217,18 @@ class Function {
   void RegisterExecutionModelLimitation(SpvExecutionModel model,
                                         const std::string& message);
 
+  /// Registers execution model limitation such as "Feature X is only available
+  /// with Execution Models Y and Z", where |allowed_models| is an execution
+  /// model mask. The reason for incompatibility is only put together when the
+  /// limitation is violated: it is |prefix|, followed by |message| and by
+  /// |detail| if it is not null. |message| and |detail| must outlive the
+  /// function, as string literals and opcode names do. Registering the same
+  /// limitation twice has no effect.
+  void RegisterExecutionModelLimitation(uint32_t allowed_models,
+                                        std::string prefix,
+                                        const char* message,
+                                        const char* detail = nullptr);
+
   /// Registers execution model limitation with an |is_compatible| functor.
   void RegisterExecutionModelLimitation(
       std::function<bool(SpvExecutionModel, std::string*)> is_compatible) {
@@ -377,10 +398,28 @@ class Function {
   /// Stores the control flow nesting depth of a given basic block
   std::unordered_map<BasicBlock*, int> block_depth_;
 
-  /// Stores execution model limitations imposed by instructions used within the
-  /// function. The functor stored in the list return true if execution model
-  /// is compatible, false otherwise. If the functor returns false, it can also
-  /// optionally fill the string parameter with the reason for incompatibility.
+  /// An execution model limitation given by the mask of the execution models
+  /// it allows. See RegisterExecutionModelLimitation for the other fields.
+  struct ExecutionModelMaskLimitation {
+    uint32_t allowed_models;
+    std::string prefix;
+    const char* message;
+    const char* detail;
+  };
+
+  /// Stores the execution model limitations imposed by instructions used
+  /// within the function that only allow a set of execution models.
+  std::vector<ExecutionModelMaskLimitation> execution_model_mask_limitations_;
+
+  /// The execution models allowed by all of
+  /// |execution_model_mask_limitations_|.
+  uint32_t allowed_execution_models_ = ~0u;
+
+  /// Stores the other execution model limitations imposed by instructions used
+  /// within the function. The functor stored in the list return true if
+  /// execution model is compatible, false otherwise. If the functor returns
+  /// false, it can also optionally fill the string parameter with the reason
+  /// for incompatibility.
   std::list<std::function<bool(SpvExecutionModel, std::string*)>>
       execution_model_limitations_;
 
@@ -23,14 +23,11 @@ namespace spvtools {
 namespace val {
 
 Instruction::Instruction(const spv_parsed_instruction_t* inst)
-    : words_(inst->words, inst->words + inst->num_words),
-      operands_(inst->operands, inst->operands + inst->num_operands),
-      inst_({words_.data(), inst->num_words, inst->opcode, inst->ext_inst_type,
-             inst->type_id, inst->result_id, operands_.data(),
-             inst->num_operands}) {}
+    : inst_(*inst) {}
 
 void Instruction::RegisterUse(const Instruction* inst, uint32_t index) {
-  uses_.push_back(std::make_pair(inst, index));
+  assert(uses_ && "The storage of the uses must be set first.");
+  uses_[num_uses_++] = std::make_pair(inst, index);
 }
 
 bool operator<(const Instruction& lhs, const Instruction& rhs) {
@@ -46,9 +43,10 @@ bool operator==(const Instruction& lhs, uint32_t rhs) {
 
 template <>
 std::string Instruction::GetOperandAs<std::string>(size_t index) const {
-  const spv_parsed_operand_t& o = operands_.at(index);
+  assert(index < inst_.num_operands);
+  const spv_parsed_operand_t& o = operand(index);
   assert(o.offset + o.num_words <= inst_.num_words);
-  return spvtools::utils::MakeString(words_.data() + o.offset, o.num_words);
+  return spvtools::utils::MakeString(inst_.words + o.offset, o.num_words);
 }
 
 }  // namespace val
@@ -23,6 +23,7 @@
 
 #include "source/ext_inst.h"
 #include "source/table.h"
+#include "source/util/span.h"
 #include "spirv-tools/libspirv.h"
 
 namespace spvtools {
@@ -32,11 +33,32 @@ class BasicBlock;
 class Function;
 
 /// Wraps the spv_parsed_instruction struct along with use and definition of the
-/// instruction's result id
+/// instruction's result id.  The instruction does not own its words, operands
+/// or uses: they are views into storage owned by the validation state.
 class Instruction {
  public:
+  /// A use of a result id: the instruction in which the id is referenced and
+  /// the index of the word of that instruction where it appears.
+  using Use = std::pair<const Instruction*, uint32_t>;
+
+  /// Creates an instruction which refers to the words and operands of \p inst.
+  /// They must outlive the instruction.
   explicit Instruction(const spv_parsed_instruction_t* inst);
 
+  /// Counts one more use of the Instruction.  All uses are counted before any
+  /// storage for them is set.
+  void CountUse() { ++num_uses_; }
+
+  /// Returns the number of uses counted or registered so far.
+  uint32_t num_uses() const { return num_uses_; }
+
+  /// Sets the storage of the uses of the Instruction, which must have room
+  /// for all counted uses, and starts registering uses into it.
+  void SetUseStorage(Use* uses) {
+    uses_ = uses;
+    num_uses_ = 0;
+  }
+
   /// Registers the use of the Instruction in instruction \p inst at \p index
   void RegisterUse(const Instruction* inst, uint32_t index);
 
@@ -54,28 +76,29 @@ class Instruction {
   const BasicBlock* block() const { return block_; }
   void set_block(BasicBlock* b) { block_ = b; }
 
-  /// Returns a vector of pairs of all references to this instruction's result
-  /// id. The first element is the instruction in which this result id was
-  /// referenced and the second is the index of the word in that instruction
-  /// where this result id appeared
-  const std::vector<std::pair<const Instruction*, uint32_t>>& uses() const {
-    return uses_;
-  }
+  /// Returns all references to this instruction's result id. The first element
+  /// of each pair is the instruction in which this result id was referenced
+  /// and the second is the index of the word in that instruction where this
+  /// result id appeared
+  utils::Span<Use> uses() const { return utils::Span<Use>(uses_, num_uses_); }
 
   /// The word used to define the Instruction
-  uint32_t word(size_t index) const { return words_[index]; }
+  uint32_t word(size_t index) const { return inst_.words[index]; }
 
   /// The words used to define the Instruction
-  const std::vector<uint32_t>& words() const { return words_; }
+  utils::Span<uint32_t> words() const {
+    return utils::Span<uint32_t>(inst_.words, inst_.num_words);
+  }
 
   /// Returns the operand at |idx|.
   const spv_parsed_operand_t& operand(size_t idx) const {
-    return operands_[idx];
+    return inst_.operands[idx];
   }
 
   /// The operands of the Instruction
-  const std::vector<spv_parsed_operand_t>& operands() const {
-    return operands_;
+  utils::Span<spv_parsed_operand_t> operands() const {
+    return utils::Span<spv_parsed_operand_t>(inst_.operands,
+                                             inst_.num_operands);
   }
 
   /// Provides direct access to the stored C instruction object.
@@ -100,18 +123,17 @@ class Instruction {
   // Casts the words belonging to the operand under |index| to |T| and returns.
   template <typename T>
   T GetOperandAs(size_t index) const {
-    const spv_parsed_operand_t& o = operands_.at(index);
+    assert(index < inst_.num_operands);
+    const spv_parsed_operand_t& o = operand(index);
     assert(o.num_words * 4 >= sizeof(T));
     assert(o.offset + o.num_words <= inst_.num_words);
-    return *reinterpret_cast<const T*>(&words_[o.offset]);
+    return *reinterpret_cast<const T*>(&inst_.words[o.offset]);
   }
 
   size_t LineNum() const { return line_num_; }
   void SetLineNum(size_t pos) { line_num_ = pos; }
 
  private:
-  const std::vector<uint32_t> words_;
-  const std::vector<spv_parsed_operand_t> operands_;
   spv_parsed_instruction_t inst_;
   size_t line_num_ = 0;
 
@@ -121,11 +143,11 @@ class Instruction {
   /// The basic block in which this instruction was declared
   BasicBlock* block_ = nullptr;
 
-  /// This is a vector of pairs of all references to this instruction's result
-  /// id. The first element is the instruction in which this result id was
-  /// referenced and the second is the index of the word in the referencing
-  /// instruction where this instruction appeared
-  std::vector<std::pair<const Instruction*, uint32_t>> uses_;
+  /// All references to this instruction's result id, in the order of the
+  /// referencing instructions.  Points into the uses of all ids, which the
+  /// validation state stores contiguously.
+  Use* uses_ = nullptr;
+  uint32_t num_uses_ = 0;
 };
 
 bool operator<(const Instruction& lhs, const Instruction& rhs);
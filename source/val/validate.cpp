@@ -35,10 +35,12 @@
 #include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/coverage_counters.h"
 #include "source/val/construct.h"
 #include "source/val/function.h"
 #include "source/val/instruction.h"
 #include "source/val/validation_state.h"
+#include "source/val/validation_stats.h"
 #include "spirv-tools/libspirv.h"
 
 namespace {
@@ -51,39 +53,6 @@ namespace spvtools {
 namespace val {
 namespace {
 
-// Parses OpExtension instruction and registers extension.
-void RegisterExtension(ValidationState_t& _,
-                       const spv_parsed_instruction_t* inst) {
-  const std::string extension_str = spvtools::GetExtensionString(inst);
-  Extension extension;
-  if (!GetExtensionFromString(extension_str.c_str(), &extension)) {
-    // The error will be logged in the ProcessInstruction pass.
-    return;
-  }
-
-  _.RegisterExtension(extension);
-}
-
-// Parses the beginning of the module searching for OpExtension instructions.
-// Registers extensions if recognized. Returns SPV_REQUESTED_TERMINATION
-// once an instruction which is not SpvOpCapability and SpvOpExtension is
-// encountered. According to the SPIR-V spec extensions are declared after
-// capabilities and before everything else.
-spv_result_t ProcessExtensions(void* user_data,
-                               const spv_parsed_instruction_t* inst) {
-  const SpvOp opcode = static_cast<SpvOp>(inst->opcode);
-  if (opcode == SpvOpCapability) return SPV_SUCCESS;
-
-  if (opcode == SpvOpExtension) {
-    ValidationState_t& _ = *(reinterpret_cast<ValidationState_t*>(user_data));
-    RegisterExtension(_, inst);
-    return SPV_SUCCESS;
-  }
-
-  // OpExtension block is finished, requesting termination.
-  return SPV_REQUESTED_TERMINATION;
-}
-
 spv_result_t ProcessInstruction(void* user_data,
                                 const spv_parsed_instruction_t* inst) {
   ValidationState_t& _ = *(reinterpret_cast<ValidationState_t*>(user_data));
@@ -152,9 +121,180 @@ spv_result_t ValidateEntryPoints(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
-spv_result_t ValidateBinaryUsingContextAndValidationState(
-    const spv_context_t& context, const uint32_t* words, const size_t num_words,
-    spv_diagnostic* pDiagnostic, ValidationState_t* vstate) {
+using Stats = ValidationStats;
+
+// A check run on each instruction of the module.
+using InstructionCheck = spv_result_t (*)(ValidationState_t&,
+                                          const Instruction*);
+
+// A check run once on the whole module.
+using ModuleCheck = spv_result_t (*)(ValidationState_t&);
+
+// Returns |error|, the result of checking |inst|, unless a work limit was
+// exceeded meanwhile.  The type queries give up once their limit is exceeded,
+// so the checks relying on them cannot be trusted and the exceeded limit is
+// reported instead.
+spv_result_t ReportWorkLimit(ValidationState_t& vstate, const Instruction* inst,
+                             spv_result_t error) {
+  if (vstate.work_limit_exceeded() && error != SPV_ERROR_WORK_LIMIT) {
+    return vstate.WorkLimitError(inst);
+  }
+  return error;
+}
+
+// Runs the checks of |inst| which only depend on the instructions preceding it
+// in the module, then registers |inst| in |vstate|.  |visited_entry_points|
+// holds the entry points seen so far.
+spv_result_t CheckInstructionInOrder(
+    ValidationState_t* vstate, Instruction* inst,
+    std::vector<Instruction*>* visited_entry_points, Stats* stats) {
+  // Runs |check| on |inst|, charging its cost to |family|.
+  const auto timed = [stats, vstate, inst](Stats::Family family,
+                                           InstructionCheck check) {
+    Stats::ScopedTimer timer(stats, family, 1);
+    const spv_result_t result = check(*vstate, inst);
+    SPIRV_COVERAGE_POINT_KEYED(
+        Stats::kNumFamilies, 2, family, result != SPV_SUCCESS,
+        std::string("val.check.") + Stats::FamilyName(family) +
+            (result != SPV_SUCCESS ? ".rejected" : ".accepted"));
+    return result;
+  };
+
+  {
+    Stats::ScopedTimer timer(stats, Stats::kId, 1);
+    if (inst->opcode() == SpvOpEntryPoint) {
+      const auto entry_point = inst->GetOperandAs<uint32_t>(1);
+      const auto execution_model = inst->GetOperandAs<SpvExecutionModel>(0);
+      const std::string desc_name = inst->GetOperandAs<std::string>(2);
+
+      ValidationState_t::EntryPointDescription desc;
+      desc.name = desc_name;
+
+      std::vector<uint32_t> interfaces;
+      for (size_t j = 3; j < inst->operands().size(); ++j)
+        desc.interfaces.push_back(inst->word(inst->operand(j).offset));
+
+      vstate->RegisterEntryPoint(entry_point, execution_model,
+                                 std::move(desc));
+
+      if (visited_entry_points->size() > 0) {
+        for (const Instruction* check_inst : *visited_entry_points) {
+          const auto check_execution_model =
+              check_inst->GetOperandAs<SpvExecutionModel>(0);
+          const std::string check_name =
+              check_inst->GetOperandAs<std::string>(2);
+
+          if (desc_name == check_name &&
+              execution_model == check_execution_model) {
+            return vstate->diag(SPV_ERROR_INVALID_DATA, inst)
+                   << "2 Entry points cannot share the same name and "
+                      "ExecutionMode.";
+          }
+        }
+      }
+      visited_entry_points->push_back(inst);
+    }
+    if (inst->opcode() == SpvOpFunctionCall) {
+      if (!vstate->in_function_body()) {
+        return vstate->diag(SPV_ERROR_INVALID_LAYOUT, inst)
+               << "A FunctionCall must happen within a function body.";
+      }
+
+      const auto called_id = inst->GetOperandAs<uint32_t>(2);
+      vstate->AddFunctionCallTarget(called_id);
+    }
+
+    if (vstate->in_function_body()) {
+      inst->set_function(&(vstate->current_function()));
+      inst->set_block(vstate->current_function().current_block());
+
+      if (vstate->in_block() && spvOpcodeIsBlockTerminator(inst->opcode())) {
+        vstate->current_function().current_block()->set_terminator(inst);
+      }
+    }
+
+    if (auto error = IdPass(*vstate, inst)) return error;
+  }
+
+  if (auto error = timed(Stats::kCapability, CapabilityPass)) return error;
+  if (auto error = timed(Stats::kModuleLayout, ModuleLayoutPass))
+    return error;
+  if (auto error = timed(Stats::kCfg, CfgPass)) return error;
+  if (auto error = timed(Stats::kInstruction, InstructionPass)) return error;
+
+  // Now that all of the checks are done, update the state.
+  vstate->RegisterInstruction(inst);
+  if (inst->opcode() == SpvOpTypeForwardPointer) {
+    vstate->RegisterForwardPointer(inst->GetOperandAs<uint32_t>(0));
+  }
+
+  return SPV_SUCCESS;
+}
+
+// The state of a streaming validation, while the module is parsed.
+struct StreamingState {
+  ValidationState_t* vstate;
+  Stats* stats;
+  std::vector<Instruction*> visited_entry_points;
+  // The number of instructions whose in-order checks have run.
+  size_t num_checked;
+  // True until the first instruction which is neither OpCapability nor
+  // OpExtension has been parsed.
+  bool in_capability_and_extension_block;
+};
+
+// Runs the in-order checks of the parsed instructions which were not checked
+// yet.
+spv_result_t CheckPendingInstructions(StreamingState* state) {
+  const auto& instructions = state->vstate->ordered_instructions();
+  for (; state->num_checked < instructions.size(); ++state->num_checked) {
+    Instruction* inst =
+        const_cast<Instruction*>(&instructions[state->num_checked]);
+    if (auto error = CheckInstructionInOrder(
+            state->vstate, inst, &state->visited_entry_points, state->stats))
+      return error;
+  }
+  return SPV_SUCCESS;
+}
+
+// Adds |inst| to the validation state and checks it right away, so that the
+// parse stops at the first error.  A capability may be enabled by an
+// extension declared after it, so the leading OpCapability and OpExtension
+// instructions are only checked once all of the extensions are registered.
+spv_result_t ProcessAndCheckInstruction(void* user_data,
+                                        const spv_parsed_instruction_t* inst) {
+  StreamingState& state = *(reinterpret_cast<StreamingState*>(user_data));
+  auto* instruction = state.vstate->AddOrderedInstruction(inst);
+  state.vstate->RegisterDebugInstruction(instruction);
+  if (state.in_capability_and_extension_block) {
+    if (inst->opcode == SpvOpExtension) {
+      state.vstate->RegisterExtension(inst);
+      return SPV_SUCCESS;
+    }
+    if (inst->opcode == SpvOpCapability) return SPV_SUCCESS;
+    state.in_capability_and_extension_block = false;
+  }
+  return CheckPendingInstructions(&state);
+}
+
+// Validates the module, charging the cost of each family of checks to |stats|
+// unless it is null.
+spv_result_t ValidateModule(const spv_context_t& context, const uint32_t* words,
+                            const size_t num_words, spv_diagnostic* pDiagnostic,
+                            ValidationState_t* vstate, Stats* stats) {
+  // Runs |check| on the whole module, charging its cost to |family|.
+  const auto timed_module = [stats, vstate](Stats::Family family,
+                                            ModuleCheck check) {
+    Stats::ScopedTimer timer(stats, family);
+    const spv_result_t result =
+        ReportWorkLimit(*vstate, nullptr, check(*vstate));
+    SPIRV_COVERAGE_POINT_KEYED(
+        Stats::kNumFamilies, 2, family, result != SPV_SUCCESS,
+        std::string("val.check.") + Stats::FamilyName(family) +
+            (result != SPV_SUCCESS ? ".rejected" : ".accepted"));
+    return result;
+  };
+
   auto binary = std::unique_ptr<spv_const_binary_t>(
       new spv_const_binary_t{words, num_words});
 
@@ -190,98 +330,48 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
            << vstate->options()->universal_limits_.max_id_bound << ".";
   }
 
-  // Look for OpExtension instructions and register extensions.
-  // This parse should not produce any error messages. Hijack the context and
-  // replace the message consumer so that we do not pollute any state in input
-  // consumer.
-  spv_context_t hijacked_context = context;
-  hijacked_context.consumer = [](spv_message_level_t, const char*,
-                                 const spv_position_t&, const char*) {};
-  spvBinaryParse(&hijacked_context, vstate, words, num_words,
-                 /* parsed_header = */ nullptr, ProcessExtensions,
-                 /* diagnostic = */ nullptr);
-
   // Parse the module and perform inline validation checks. These checks do
-  // not require the knowledge of the whole module.
-  if (auto error = spvBinaryParse(&context, vstate, words, num_words,
-                                  /*parsed_header =*/nullptr,
-                                  ProcessInstruction, pDiagnostic)) {
-    return error;
+  // not require the knowledge of the whole module. Extensions were already
+  // registered when |vstate| pre-parsed the module on construction.
+  // In streaming mode, there is no pre-parse: the extensions are registered
+  // as they are parsed, and the checks of each instruction which only depend
+  // on the instructions preceding it run as soon as it is parsed, so that the
+  // parse stops at the first error they find.
+  const bool streaming = vstate->options()->streaming;
+  StreamingState streaming_state = {vstate, stats, {}, 0, true};
+  {
+    // The time spent in the checks run from the parse is charged to their
+    // own families only, so this only measures the parse itself.
+    Stats::ScopedTimer timer(stats, Stats::kParse);
+    // The instructions refer to the words they are parsed from, so parse the
+    // host endian words kept by |vstate|.
+    if (auto error = spvBinaryParse(
+            &context,
+            streaming ? static_cast<void*>(&streaming_state) : vstate,
+            vstate->words(), vstate->num_words(),
+            /*parsed_header =*/nullptr,
+            streaming ? ProcessAndCheckInstruction : ProcessInstruction,
+            pDiagnostic)) {
+      return error;
+    }
+  }
+  if (stats) {
+    stats->AddInstructions(Stats::kParse,
+                           vstate->ordered_instructions().size());
   }
 
-  std::vector<Instruction*> visited_entry_points;
-  for (auto& instruction : vstate->ordered_instructions()) {
-    {
+  if (streaming) {
+    // A module made only of capabilities and extensions is not checked yet.
+    if (auto error = CheckPendingInstructions(&streaming_state)) return error;
+  } else {
+    std::vector<Instruction*> visited_entry_points;
+    for (auto& instruction : vstate->ordered_instructions()) {
       // In order to do this work outside of Process Instruction we need to be
       // able to, briefly, de-const the instruction.
       Instruction* inst = const_cast<Instruction*>(&instruction);
-
-      if (inst->opcode() == SpvOpEntryPoint) {
-        const auto entry_point = inst->GetOperandAs<uint32_t>(1);
-        const auto execution_model = inst->GetOperandAs<SpvExecutionModel>(0);
-        const std::string desc_name = inst->GetOperandAs<std::string>(2);
-
-        ValidationState_t::EntryPointDescription desc;
-        desc.name = desc_name;
-
-        std::vector<uint32_t> interfaces;
-        for (size_t j = 3; j < inst->operands().size(); ++j)
-          desc.interfaces.push_back(inst->word(inst->operand(j).offset));
-
-        vstate->RegisterEntryPoint(entry_point, execution_model,
-                                   std::move(desc));
-
-        if (visited_entry_points.size() > 0) {
-          for (const Instruction* check_inst : visited_entry_points) {
-            const auto check_execution_model =
-                check_inst->GetOperandAs<SpvExecutionModel>(0);
-            const std::string check_name =
-                check_inst->GetOperandAs<std::string>(2);
-
-            if (desc_name == check_name &&
-                execution_model == check_execution_model) {
-              return vstate->diag(SPV_ERROR_INVALID_DATA, inst)
-                     << "2 Entry points cannot share the same name and "
-                        "ExecutionMode.";
-            }
-          }
-        }
-        visited_entry_points.push_back(inst);
-      }
-      if (inst->opcode() == SpvOpFunctionCall) {
-        if (!vstate->in_function_body()) {
-          return vstate->diag(SPV_ERROR_INVALID_LAYOUT, &instruction)
-                 << "A FunctionCall must happen within a function body.";
-        }
-
-        const auto called_id = inst->GetOperandAs<uint32_t>(2);
-        vstate->AddFunctionCallTarget(called_id);
-      }
-
-      if (vstate->in_function_body()) {
-        inst->set_function(&(vstate->current_function()));
-        inst->set_block(vstate->current_function().current_block());
-
-        if (vstate->in_block() && spvOpcodeIsBlockTerminator(inst->opcode())) {
-          vstate->current_function().current_block()->set_terminator(inst);
-        }
-      }
-
-      if (auto error = IdPass(*vstate, inst)) return error;
-    }
-
-    if (auto error = CapabilityPass(*vstate, &instruction)) return error;
-    if (auto error = ModuleLayoutPass(*vstate, &instruction)) return error;
-    if (auto error = CfgPass(*vstate, &instruction)) return error;
-    if (auto error = InstructionPass(*vstate, &instruction)) return error;
-
-    // Now that all of the checks are done, update the state.
-    {
-      Instruction* inst = const_cast<Instruction*>(&instruction);
-      vstate->RegisterInstruction(inst);
-      if (inst->opcode() == SpvOpTypeForwardPointer) {
-        vstate->RegisterForwardPointer(inst->GetOperandAs<uint32_t>(0));
-      }
+      if (auto error = CheckInstructionInOrder(vstate, inst,
+                                               &visited_entry_points, stats))
+        return error;
     }
   }
 
@@ -299,11 +389,15 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
            << "Missing required OpSamplerImageAddressingModeNV instruction.";
 
   // Catch undefined forward references before performing further checks.
-  if (auto error = ValidateForwardDecls(*vstate)) return error;
+  if (auto error = timed_module(Stats::kForwardDecls, ValidateForwardDecls))
+    return error;
 
   // Calculate reachability after all the blocks are parsed, but early that it
   // can be relied on in subsequent pases.
-  ReachabilityPass(*vstate);
+  {
+    Stats::ScopedTimer timer(stats, Stats::kReachability);
+    ReachabilityPass(*vstate);
+  }
 
   // ID usage needs be handled in its own iteration of the instructions,
   // between the two others. It depends on the first loop to have been
@@ -313,71 +407,179 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
   // It should also live after the forward declaration check, since it will
   // have problems with missing forward declarations, but give less useful error
   // messages.
+  // The uses are counted first so that they can be stored contiguously.
+  for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
+    auto& instruction = vstate->ordered_instructions()[i];
+    Stats::ScopedTimer timer(stats, Stats::kIdUse, 1);
+    if (auto error = CountIdUses(*vstate, &instruction)) return error;
+  }
+  {
+    Stats::ScopedTimer timer(stats, Stats::kIdUse);
+    vstate->AllocateIdUses();
+  }
   for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
     auto& instruction = vstate->ordered_instructions()[i];
+    Stats::ScopedTimer timer(stats, Stats::kIdUse);
     if (auto error = UpdateIdUse(*vstate, &instruction)) return error;
   }
 
+  // The structural profile only runs the checks that downstream consumers rely
+  // on to walk the module safely.  See spv_validator_profile.
+  const bool structural_only =
+      vstate->options()->profile == SPV_VAL_PROFILE_STRUCTURAL;
+
   // Validate individual opcodes.
   for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
     auto& instruction = vstate->ordered_instructions()[i];
+    // Runs |check| on |instruction|, charging its cost to |family|.
+    const auto timed = [stats, vstate, &instruction](Stats::Family family,
+                                                     InstructionCheck check) {
+      Stats::ScopedTimer timer(stats, family, 1);
+      const spv_result_t result = ReportWorkLimit(
+          *vstate, &instruction, check(*vstate, &instruction));
+      SPIRV_COVERAGE_POINT_KEYED(
+          Stats::kNumFamilies, 2, family, result != SPV_SUCCESS,
+          std::string("val.check.") + Stats::FamilyName(family) +
+              (result != SPV_SUCCESS ? ".rejected" : ".accepted"));
+      return result;
+    };
+
+    if (structural_only) {
+      // Group decorations must still be registered, since the uses of
+      // decorations are resolved through them.
+      if (auto error = timed(Stats::kAnnotation, AnnotationPass)) return error;
+      // Entry points and execution modes must target functions.
+      if (auto error = timed(Stats::kModeSetting, ModeSettingPass))
+        return error;
+      if (auto error = timed(Stats::kType, TypePass)) return error;
+      if (auto error = timed(Stats::kConstant, ConstantPass)) return error;
+      // Consumers follow pointers and composite indices without checking
+      // them again.
+      if (auto error = timed(Stats::kMemory, MemoryPass)) return error;
+      if (auto error = timed(Stats::kFunction, FunctionPass)) return error;
+      if (auto error = timed(Stats::kComposites, CompositesPass)) return error;
+      if (auto error = timed(Stats::kControlFlow, ControlFlowPass))
+        return error;
+      continue;
+    }
 
     // Keep these passes in the order they appear in the SPIR-V specification
     // sections to maintain test consistency.
-    if (auto error = MiscPass(*vstate, &instruction)) return error;
-    if (auto error = DebugPass(*vstate, &instruction)) return error;
-    if (auto error = AnnotationPass(*vstate, &instruction)) return error;
-    if (auto error = ExtensionPass(*vstate, &instruction)) return error;
-    if (auto error = ModeSettingPass(*vstate, &instruction)) return error;
-    if (auto error = TypePass(*vstate, &instruction)) return error;
-    if (auto error = ConstantPass(*vstate, &instruction)) return error;
-    if (auto error = MemoryPass(*vstate, &instruction)) return error;
-    if (auto error = FunctionPass(*vstate, &instruction)) return error;
-    if (auto error = ImagePass(*vstate, &instruction)) return error;
-    if (auto error = ConversionPass(*vstate, &instruction)) return error;
-    if (auto error = CompositesPass(*vstate, &instruction)) return error;
-    if (auto error = ArithmeticsPass(*vstate, &instruction)) return error;
-    if (auto error = BitwisePass(*vstate, &instruction)) return error;
-    if (auto error = LogicalsPass(*vstate, &instruction)) return error;
-    if (auto error = ControlFlowPass(*vstate, &instruction)) return error;
-    if (auto error = DerivativesPass(*vstate, &instruction)) return error;
-    if (auto error = AtomicsPass(*vstate, &instruction)) return error;
-    if (auto error = PrimitivesPass(*vstate, &instruction)) return error;
-    if (auto error = BarriersPass(*vstate, &instruction)) return error;
+    if (auto error = timed(Stats::kMisc, MiscPass)) return error;
+    if (auto error = timed(Stats::kDebug, DebugPass)) return error;
+    if (auto error = timed(Stats::kAnnotation, AnnotationPass)) return error;
+    if (auto error = timed(Stats::kExtension, ExtensionPass)) return error;
+    if (auto error = timed(Stats::kModeSetting, ModeSettingPass)) return error;
+    if (auto error = timed(Stats::kType, TypePass)) return error;
+    if (auto error = timed(Stats::kConstant, ConstantPass)) return error;
+    if (auto error = timed(Stats::kMemory, MemoryPass)) return error;
+    if (auto error = timed(Stats::kFunction, FunctionPass)) return error;
+    if (auto error = timed(Stats::kImage, ImagePass)) return error;
+    if (auto error = timed(Stats::kConversion, ConversionPass)) return error;
+    if (auto error = timed(Stats::kComposites, CompositesPass)) return error;
+    if (auto error = timed(Stats::kArithmetics, ArithmeticsPass)) return error;
+    if (auto error = timed(Stats::kBitwise, BitwisePass)) return error;
+    if (auto error = timed(Stats::kLogicals, LogicalsPass)) return error;
+    if (auto error = timed(Stats::kControlFlow, ControlFlowPass)) return error;
+    if (auto error = timed(Stats::kDerivatives, DerivativesPass)) return error;
+    if (auto error = timed(Stats::kAtomics, AtomicsPass)) return error;
+    if (auto error = timed(Stats::kPrimitives, PrimitivesPass)) return error;
+    if (auto error = timed(Stats::kBarriers, BarriersPass)) return error;
     // Group
     // Device-Side Enqueue
     // Pipe
-    if (auto error = NonUniformPass(*vstate, &instruction)) return error;
+    if (auto error = timed(Stats::kNonUniform, NonUniformPass)) return error;
 
-    if (auto error = LiteralsPass(*vstate, &instruction)) return error;
-    if (auto error = RayQueryPass(*vstate, &instruction)) return error;
-    if (auto error = RayTracingPass(*vstate, &instruction)) return error;
+    if (auto error = timed(Stats::kLiterals, LiteralsPass)) return error;
+    if (auto error = timed(Stats::kRayQuery, RayQueryPass)) return error;
+    if (auto error = timed(Stats::kRayTracing, RayTracingPass)) return error;
   }
 
   // Validate the preconditions involving adjacent instructions. e.g. SpvOpPhi
   // must only be preceded by SpvOpLabel, SpvOpPhi, or SpvOpLine.
-  if (auto error = ValidateAdjacency(*vstate)) return error;
+  if (auto error = timed_module(Stats::kAdjacency, ValidateAdjacency))
+    return error;
 
-  if (auto error = ValidateEntryPoints(*vstate)) return error;
+  if (auto error = timed_module(Stats::kEntryPoints, ValidateEntryPoints))
+    return error;
   // CFG checks are performed after the binary has been parsed
   // and the CFGPass has collected information about the control flow
-  if (auto error = PerformCfgChecks(*vstate)) return error;
-  if (auto error = CheckIdDefinitionDominateUse(*vstate)) return error;
-  if (auto error = ValidateDecorations(*vstate)) return error;
-  if (auto error = ValidateInterfaces(*vstate)) return error;
-  // TODO(dsinclair): Restructure ValidateBuiltins so we can move into the
-  // for() above as it loops over all ordered_instructions internally.
-  if (auto error = ValidateBuiltIns(*vstate)) return error;
-  // These checks must be performed after individual opcode checks because
-  // those checks register the limitation checked here.
-  for (const auto& inst : vstate->ordered_instructions()) {
-    if (auto error = ValidateExecutionLimitations(*vstate, &inst)) return error;
-    if (auto error = ValidateSmallTypeUses(*vstate, &inst)) return error;
+  if (auto error = timed_module(Stats::kCfgChecks, PerformCfgChecks))
+    return error;
+  if (auto error =
+          timed_module(Stats::kIdDominance, CheckIdDefinitionDominateUse))
+    return error;
+  if (structural_only) return SPV_SUCCESS;
+  if (auto error = timed_module(Stats::kDecorations, ValidateDecorations))
+    return error;
+  if (auto error = timed_module(Stats::kInterfaces, ValidateInterfaces))
+    return error;
+  // The execution limitation checks must be performed after individual opcode
+  // checks because those checks register the limitation checked here.  They
+  // are run in the same traversal of the module as the built-in checks, which
+  // need all decorations and interfaces to have been validated.
+  const auto limitation_checks = [vstate, stats](
+                                     const Instruction* inst) -> spv_result_t {
+    {
+      Stats::ScopedTimer timer(stats, Stats::kExecutionLimitations, 1);
+      if (auto error = ValidateExecutionLimitations(*vstate, inst))
+        return error;
+    }
+    Stats::ScopedTimer timer(stats, Stats::kSmallTypeUses, 1);
+    return ValidateSmallTypeUses(*vstate, inst);
+  };
+  {
+    Stats::ScopedTimer timer(stats, Stats::kBuiltIns);
+    if (auto error = ReportWorkLimit(
+            *vstate, nullptr, ValidateBuiltIns(*vstate, limitation_checks)))
+      return error;
   }
 
   return SPV_SUCCESS;
 }
 
+// Records the sizes of the main data structures of |vstate| in |stats|.
+void RecordSizes(ValidationState_t& vstate, Stats* stats) {
+  size_t num_decorations = 0;
+  for (const auto& id_decorations : vstate.id_decorations()) {
+    num_decorations += id_decorations.second.size();
+  }
+  stats->SetSize("Id bound", vstate.getIdBound());
+  stats->SetSize("Instructions", vstate.ordered_instructions().size());
+  stats->SetSize("Operands", vstate.num_operands());
+  stats->SetSize("Id uses", vstate.num_id_uses());
+  stats->SetSize("Instruction bytes", vstate.instruction_storage_bytes());
+  stats->SetSize("Definitions", vstate.all_definitions().size());
+  stats->SetSize("Functions", vstate.functions().size());
+  stats->SetSize("Entry points", vstate.entry_points().size());
+  stats->SetSize("Decorated ids", vstate.id_decorations().size());
+  stats->SetSize("Decorations", num_decorations);
+  stats->SetSize("Global variables", vstate.num_global_vars());
+  stats->SetSize("Local variables", vstate.num_local_vars());
+}
+
+spv_result_t ValidateBinaryUsingContextAndValidationState(
+    const spv_context_t& context, const uint32_t* words, const size_t num_words,
+    spv_diagnostic* pDiagnostic, ValidationState_t* vstate) {
+  if (!vstate->options()->collect_stats) {
+    return ValidateModule(context, words, num_words, pDiagnostic, vstate,
+                          nullptr);
+  }
+
+  Stats stats;
+  const auto start = Stats::Clock::now();
+  const auto result =
+      ValidateModule(context, words, num_words, pDiagnostic, vstate, &stats);
+  stats.SetTotalTime(Stats::Clock::now() - start);
+  RecordSizes(*vstate, &stats);
+  // Reporting the statistics through a requested diagnostic would replace the
+  // validation result.
+  if (!pDiagnostic && context.consumer) {
+    context.consumer(SPV_MSG_INFO, "", {0, 0, 0}, stats.Report().c_str());
+  }
+  return result;
+}
+
 }  // namespace
 
 spv_result_t ValidateBinaryAndKeepValidationState(
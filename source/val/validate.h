@@ -43,10 +43,20 @@ using get_blocks_func =
 /// @return SPV_SUCCESS if no errors are found. SPV_ERROR_INVALID_CFG otherwise
 spv_result_t PerformCfgChecks(ValidationState_t& _);
 
-/// @brief Updates the use vectors of all instructions that can be referenced
+/// @brief Counts the uses of the ids referenced by an instruction
 ///
-/// This function will update the vector which define where an instruction was
-/// referenced in the binary.
+/// The uses of all ids are stored contiguously, so they are counted for every
+/// instruction before ValidationState_t::AllocateIdUses allocates them.
+///
+/// @param[in] _ the validation state of the module
+///
+/// @return SPV_SUCCESS if no errors are found.
+spv_result_t CountIdUses(ValidationState_t& _, const Instruction* inst);
+
+/// @brief Updates the uses of all instructions that can be referenced
+///
+/// This function will register where the ids referenced by an instruction
+/// were used in the binary.  The storage of the uses must have been allocated.
 ///
 /// @param[in] _ the validation state of the module
 ///
@@ -130,8 +140,13 @@ spv_result_t InstructionPass(ValidationState_t& _, const Instruction* inst);
 /// has been propagated down to the group members.
 spv_result_t ValidateDecorations(ValidationState_t& _);
 
-/// Performs validation of built-in variables.
-spv_result_t ValidateBuiltIns(ValidationState_t& _);
+/// Performs validation of built-in variables.  So that the module is only
+/// traversed once, |per_instruction_checks| is run on every instruction after
+/// the built-in checks for that instruction.
+spv_result_t ValidateBuiltIns(
+    ValidationState_t& _,
+    const std::function<spv_result_t(const Instruction*)>&
+        per_instruction_checks);
 
 /// Validates type instructions.
 spv_result_t TypePass(ValidationState_t& _, const Instruction* inst);
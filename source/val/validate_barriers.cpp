@@ -40,22 +40,14 @@ spv_result_t BarriersPass(ValidationState_t& _, const Instruction* inst) {
       if (_.version() < SPV_SPIRV_VERSION_WORD(1, 3)) {
         _.function(inst->function()->id())
             ->RegisterExecutionModelLimitation(
-                [](SpvExecutionModel model, std::string* message) {
-                  if (model != SpvExecutionModelTessellationControl &&
-                      model != SpvExecutionModelGLCompute &&
-                      model != SpvExecutionModelKernel &&
-                      model != SpvExecutionModelTaskNV &&
-                      model != SpvExecutionModelMeshNV) {
-                    if (message) {
-                      *message =
-                          "OpControlBarrier requires one of the following "
-                          "Execution "
-                          "Models: TessellationControl, GLCompute or Kernel";
-                    }
-                    return false;
-                  }
-                  return true;
-                });
+                ExecutionModelMask({SpvExecutionModelTessellationControl,
+                                    SpvExecutionModelGLCompute,
+                                    SpvExecutionModelKernel,
+                                    SpvExecutionModelTaskNV,
+                                    SpvExecutionModelMeshNV}),
+                "",
+                "OpControlBarrier requires one of the following Execution "
+                "Models: TessellationControl, GLCompute or Kernel");
       }
 
       const uint32_t execution_scope = inst->word(1);
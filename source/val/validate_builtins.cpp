@@ -16,6 +16,7 @@
 
 // Validates correctness of built-in variables.
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <list>
@@ -247,10 +248,13 @@ bool IsExecutionModelValidForRtBuiltIn(SpvBuiltIn builtin,
 // ValidationState_t to be made available to other users.
 class BuiltInsValidator {
  public:
-  BuiltInsValidator(ValidationState_t& vstate) : _(vstate) {}
+  BuiltInsValidator(ValidationState_t& vstate)
+      : _(vstate), has_at_reference_checks_(vstate.getIdBound(), false) {}
 
-  // Run validation.
-  spv_result_t Run();
+  // Run validation.  |per_instruction_checks| is run on every instruction of
+  // the module after the built-in checks for that instruction.
+  spv_result_t Run(const std::function<spv_result_t(const Instruction*)>&
+                       per_instruction_checks);
 
  private:
   // Goes through all decorations in the module, if decoration is BuiltIn
@@ -652,6 +656,14 @@ class BuiltInsValidator {
   // instruction.
   void Update(const Instruction& inst);
 
+  // Runs the checks associated with every id referenced by |inst|.
+  spv_result_t ValidateAtReferences(const Instruction& inst);
+
+  // Returns the list of rules which validate instructions referencing |id|,
+  // and records that |id| has such rules.
+  std::list<std::function<spv_result_t(const Instruction&)>>& AtReferenceChecks(
+      uint32_t id);
+
   ValidationState_t& _;
 
   // Mapping id -> list of rules which validate instruction referencing the
@@ -661,6 +673,14 @@ class BuiltInsValidator {
   std::map<uint32_t, std::list<std::function<spv_result_t(const Instruction&)>>>
       id_to_at_reference_checks_;
 
+  // Indexed by id; true if and only if id_to_at_reference_checks_ has rules for
+  // the id.  Most ids have none, and this spares a map lookup for them.
+  std::vector<bool> has_at_reference_checks_;
+
+  // Ids with rules that the current instruction has already been checked
+  // against.  Reused across instructions to avoid allocating.
+  std::vector<uint32_t> checked_ids_;
+
   // Id of the function we are currently inside. 0 if not inside a function.
   uint32_t function_id_ = 0;
 
@@ -1129,7 +1149,7 @@ spv_result_t BuiltInsValidator::ValidateNotCalledWithExecutionModel(
     }
   } else {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel, this,
                   vuid, comment, execution_model, decoration, built_in_inst,
                   referenced_from_inst, std::placeholders::_1));
@@ -1168,14 +1188,14 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInClipDistance) ? 4188 : 4197;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Input storage class if execution model is "
           "Vertex.",
           SpvExecutionModelVertex, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Input storage class if execution model is "
@@ -1187,7 +1207,7 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInClipDistance) ? 4189 : 4198;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Output storage class if execution model is "
@@ -1291,7 +1311,7 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateClipOrCullDistanceAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -1354,7 +1374,7 @@ spv_result_t BuiltInsValidator::ValidateFragCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragCoordAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1430,7 +1450,7 @@ spv_result_t BuiltInsValidator::ValidateFragDepthAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragDepthAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1491,7 +1511,7 @@ spv_result_t BuiltInsValidator::ValidateFrontFacingAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFrontFacingAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1550,7 +1570,7 @@ spv_result_t BuiltInsValidator::ValidateHelperInvocationAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateHelperInvocationAtReference, this,
                   decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -1611,7 +1631,7 @@ spv_result_t BuiltInsValidator::ValidateInvocationIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateInvocationIdAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1672,7 +1692,7 @@ spv_result_t BuiltInsValidator::ValidateInstanceIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateInstanceIndexAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1733,7 +1753,7 @@ spv_result_t BuiltInsValidator::ValidatePatchVerticesAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidatePatchVerticesAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1793,7 +1813,7 @@ spv_result_t BuiltInsValidator::ValidatePointCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidatePointCoordAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1827,7 +1847,7 @@ spv_result_t BuiltInsValidator::ValidatePointSizeAtReference(
 
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4315,
           "Vulkan spec doesn't allow BuiltIn PointSize to be used for "
           "variables with Input storage class if execution model is "
@@ -1910,7 +1930,7 @@ spv_result_t BuiltInsValidator::ValidatePointSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidatePointSizeAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -1943,14 +1963,14 @@ spv_result_t BuiltInsValidator::ValidatePositionAtReference(
 
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4319,
           "Vulkan spec doesn't allow BuiltIn Position to be used "
           "for variables "
           "with Input storage class if execution model is Vertex.",
           SpvExecutionModelVertex, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4319,
           "Vulkan spec doesn't allow BuiltIn Position to be used "
           "for variables "
@@ -2036,7 +2056,7 @@ spv_result_t BuiltInsValidator::ValidatePositionAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidatePositionAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2100,42 +2120,42 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveIdAtReference(
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "TessellationControl.",
           SpvExecutionModelTessellationControl, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "TessellationEvaluation.",
           SpvExecutionModelTessellationEvaluation, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "Fragment.",
           SpvExecutionModelFragment, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "IntersectionKHR.",
           SpvExecutionModelIntersectionKHR, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "AnyHitKHR.",
           SpvExecutionModelAnyHitKHR, decoration, built_in_inst,
           referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
@@ -2175,7 +2195,7 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidatePrimitiveIdAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2234,7 +2254,7 @@ spv_result_t BuiltInsValidator::ValidateSampleIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateSampleIdAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2295,7 +2315,7 @@ spv_result_t BuiltInsValidator::ValidateSampleMaskAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateSampleMaskAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2357,7 +2377,7 @@ spv_result_t BuiltInsValidator::ValidateSamplePositionAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateSamplePositionAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2417,7 +2437,7 @@ spv_result_t BuiltInsValidator::ValidateTessCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateTessCoordAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2491,7 +2511,7 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInTessLevelOuter) ? 4391 : 4395;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
           "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be "
           "used "
@@ -2504,7 +2524,7 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInTessLevelOuter) ? 4392 : 4396;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
           &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
           "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be "
           "used "
@@ -2539,7 +2559,7 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateTessLevelAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2592,7 +2612,7 @@ spv_result_t BuiltInsValidator::ValidateLocalInvocationIndexAtReference(
     const Instruction& referenced_from_inst) {
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateLocalInvocationIndexAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -2633,7 +2653,7 @@ spv_result_t BuiltInsValidator::ValidateVertexIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateVertexIndexAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -2714,7 +2734,7 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
       for (const auto em :
            {SpvExecutionModelVertex, SpvExecutionModelTessellationEvaluation,
             SpvExecutionModelGeometry, SpvExecutionModelMeshNV}) {
-        id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+        AtReferenceChecks(referenced_from_inst.id()).push_back(
             std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel,
                       this, ((operand == SpvBuiltInLayer) ? 4274 : 4406),
                       "Vulkan spec doesn't allow BuiltIn Layer and "
@@ -2729,7 +2749,7 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+      AtReferenceChecks(referenced_from_inst.id()).push_back(
           std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel,
                     this, ((operand == SpvBuiltInLayer) ? 4275 : 4407),
                     "Vulkan spec doesn't allow BuiltIn Layer and "
@@ -2792,7 +2812,7 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateLayerOrViewportIndexAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -2866,7 +2886,7 @@ spv_result_t BuiltInsValidator::ValidateFragmentShaderF32Vec3InputAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragmentShaderF32Vec3InputAtReference, this,
         decoration, built_in_inst, referenced_from_inst,
         std::placeholders::_1));
@@ -2942,7 +2962,7 @@ spv_result_t BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference, this,
         decoration, built_in_inst, referenced_from_inst,
         std::placeholders::_1));
@@ -3024,7 +3044,7 @@ spv_result_t BuiltInsValidator::ValidateComputeI32InputAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateComputeI32InputAtReference, this,
                   decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -3175,7 +3195,7 @@ spv_result_t BuiltInsValidator::ValidateWorkgroupSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateWorkgroupSizeAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3244,7 +3264,7 @@ spv_result_t BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -3312,7 +3332,7 @@ spv_result_t BuiltInsValidator::ValidateDrawIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateDrawIndexAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3376,7 +3396,7 @@ spv_result_t BuiltInsValidator::ValidateViewIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateViewIndexAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3428,7 +3448,7 @@ spv_result_t BuiltInsValidator::ValidateDeviceIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateDeviceIndexAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3499,7 +3519,7 @@ spv_result_t BuiltInsValidator::ValidateFragInvocationCountAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragInvocationCountAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3569,7 +3589,7 @@ spv_result_t BuiltInsValidator::ValidateFragSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragSizeAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3639,7 +3659,7 @@ spv_result_t BuiltInsValidator::ValidateFragStencilRefAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFragStencilRefAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3709,7 +3729,7 @@ spv_result_t BuiltInsValidator::ValidateFullyCoveredAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateFullyCoveredAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3764,7 +3784,7 @@ spv_result_t BuiltInsValidator::ValidateSMBuiltinsAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateSMBuiltinsAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -3835,7 +3855,7 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveShadingRateAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidatePrimitiveShadingRateAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -3900,7 +3920,7 @@ spv_result_t BuiltInsValidator::ValidateShadingRateAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(std::bind(
         &BuiltInsValidator::ValidateShadingRateAtReference, this, decoration,
         built_in_inst, referenced_from_inst, std::placeholders::_1));
   }
@@ -4068,7 +4088,7 @@ spv_result_t BuiltInsValidator::ValidateRayTracingBuiltinsAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
+    AtReferenceChecks(referenced_from_inst.id()).push_back(
         std::bind(&BuiltInsValidator::ValidateRayTracingBuiltinsAtReference,
                   this, decoration, built_in_inst, referenced_from_inst,
                   std::placeholders::_1));
@@ -4315,54 +4335,80 @@ spv_result_t BuiltInsValidator::ValidateBuiltInsAtDefinition() {
   return SPV_SUCCESS;
 }
 
-spv_result_t BuiltInsValidator::Run() {
-  // First pass: validate all built-ins at definition and seed
-  // id_to_at_reference_checks_ with built-ins.
-  if (auto error = ValidateBuiltInsAtDefinition()) {
-    return error;
+std::list<std::function<spv_result_t(const Instruction&)>>&
+BuiltInsValidator::AtReferenceChecks(uint32_t id) {
+  if (id >= has_at_reference_checks_.size()) {
+    has_at_reference_checks_.resize(id + 1, false);
   }
+  has_at_reference_checks_[id] = true;
+  return id_to_at_reference_checks_[id];
+}
 
-  if (id_to_at_reference_checks_.empty()) {
-    // No validation tasks were seeded. Nothing else to do.
-    return SPV_SUCCESS;
-  }
+spv_result_t BuiltInsValidator::ValidateAtReferences(const Instruction& inst) {
+  checked_ids_.clear();
+  for (const auto& operand : inst.operands()) {
+    if (!spvIsIdType(operand.type)) {
+      // Not id.
+      continue;
+    }
 
-  // Second pass: validate every id reference in the module using
-  // rules in id_to_at_reference_checks_.
-  for (const Instruction& inst : _.ordered_instructions()) {
-    Update(inst);
+    const uint32_t id = inst.word(operand.offset);
+    if (id == inst.id()) {
+      // No need to check result id.
+      continue;
+    }
 
-    std::set<uint32_t> already_checked;
+    if (id >= has_at_reference_checks_.size() ||
+        !has_at_reference_checks_[id]) {
+      // No checks are associated with the id.
+      continue;
+    }
 
-    for (const auto& operand : inst.operands()) {
-      if (!spvIsIdType(operand.type)) {
-        // Not id.
-        continue;
-      }
+    if (std::find(checked_ids_.begin(), checked_ids_.end(), id) !=
+        checked_ids_.end()) {
+      // The instruction has already referenced this id.
+      continue;
+    }
+    checked_ids_.push_back(id);
 
-      const uint32_t id = inst.word(operand.offset);
-      if (id == inst.id()) {
-        // No need to check result id.
-        continue;
+    // Instruction references the id. Run all checks associated with the id
+    // on the instruction. id_to_at_reference_checks_ can be modified in the
+    // process, iterators are safe because it's a tree-based map.
+    for (const auto& check : id_to_at_reference_checks_[id]) {
+      if (spv_result_t error = check(inst)) {
+        return error;
       }
+    }
+  }
+  return SPV_SUCCESS;
+}
 
-      if (!already_checked.insert(id).second) {
-        // The instruction has already referenced this id.
-        continue;
-      }
+spv_result_t BuiltInsValidator::Run(
+    const std::function<spv_result_t(const Instruction*)>&
+        per_instruction_checks) {
+  // Validate all built-ins at definition and seed id_to_at_reference_checks_
+  // with built-ins.
+  if (auto error = ValidateBuiltInsAtDefinition()) {
+    return error;
+  }
 
-      // Instruction references the id. Run all checks associated with the id
-      // on the instruction. id_to_at_reference_checks_ can be modified in the
-      // process, iterators are safe because it's a tree-based map.
-      const auto it = id_to_at_reference_checks_.find(id);
-      if (it != id_to_at_reference_checks_.end()) {
-        for (const auto& check : it->second) {
-          if (spv_result_t error = check(inst)) {
-            return error;
-          }
-        }
+  // If no validation tasks were seeded, there is nothing to check at
+  // references.
+  const bool check_references = !id_to_at_reference_checks_.empty();
+
+  // Validate every id reference in the module using rules in
+  // id_to_at_reference_checks_, in the same traversal of the module as the
+  // other per-instruction checks.
+  for (const Instruction& inst : _.ordered_instructions()) {
+    if (check_references) {
+      Update(inst);
+      if (auto error = ValidateAtReferences(inst)) {
+        return error;
       }
     }
+    if (auto error = per_instruction_checks(&inst)) {
+      return error;
+    }
   }
 
   return SPV_SUCCESS;
@@ -4371,9 +4417,12 @@ spv_result_t BuiltInsValidator::Run() {
 }  // namespace
 
 // Validates correctness of built-in variables.
-spv_result_t ValidateBuiltIns(ValidationState_t& _) {
+spv_result_t ValidateBuiltIns(
+    ValidationState_t& _,
+    const std::function<spv_result_t(const Instruction*)>&
+        per_instruction_checks) {
   BuiltInsValidator validator(_);
-  return validator.Run();
+  return validator.Run(per_instruction_checks);
 }
 
 }  // namespace val
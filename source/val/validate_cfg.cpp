@@ -477,6 +477,9 @@ spv_result_t FindCaseFallThrough(
 
     if (!visited.insert(block).second) continue;
 
+    if (!_.ChargeWork(spv_validator_work_limit_max_dominance_queries, 1)) {
+      return _.WorkLimitError(target_block->label());
+    }
     if (target_reachable && block->structurally_reachable() &&
         target_block->structurally_dominates(*block)) {
       // Still in the case construct.
@@ -641,7 +644,7 @@ spv_result_t ValidateStructuredSelections(
     const auto* block = *iter;
     const auto* terminator = block->terminator();
     if (!terminator) continue;
-    const auto index = terminator - &_.ordered_instructions()[0];
+    const auto index = terminator->LineNum() - 1;
     auto* merge = &_.ordered_instructions()[index - 1];
     // Marks merges and continues as seen.
     if (merge->opcode() == SpvOpSelectionMerge) {
@@ -767,6 +770,12 @@ spv_result_t StructuredControlFlowChecks(
     }
 
     Construct::ConstructBlockSet construct_blocks = construct.blocks(function);
+    // Finding the blocks of the construct queries the dominance of each of
+    // them, and so do the checks below.
+    if (!_.ChargeWork(spv_validator_work_limit_max_dominance_queries,
+                      construct_blocks.size())) {
+      return _.WorkLimitError(_.FindDef(header->id()));
+    }
     std::string construct_name, header_name, exit_name;
     std::tie(construct_name, header_name, exit_name) =
         ConstructNames(construct.type());
@@ -796,7 +805,7 @@ spv_result_t StructuredControlFlowChecks(
 
       if (block->is_type(BlockType::kBlockTypeSelection) ||
           block->is_type(BlockType::kBlockTypeLoop)) {
-        size_t index = (block->terminator() - &_.ordered_instructions()[0]) - 1;
+        size_t index = block->terminator()->LineNum() - 2;
         const auto& merge_inst = _.ordered_instructions()[index];
         if (merge_inst.opcode() == SpvOpSelectionMerge ||
             merge_inst.opcode() == SpvOpLoopMerge) {
@@ -818,15 +827,14 @@ spv_result_t StructuredControlFlowChecks(
     if (construct.type() == ConstructType::kLoop) {
       // If the continue target differs from the loop header, then check that
       // all edges into the continue construct come from within the loop.
-      const auto index = header->terminator() - &_.ordered_instructions()[0];
+      const auto index = header->terminator()->LineNum() - 1;
       const auto& merge_inst = _.ordered_instructions()[index - 1];
       const auto continue_id = merge_inst.GetOperandAs<uint32_t>(1);
       const auto* continue_inst = _.FindDef(continue_id);
       // OpLabel instructions aren't stored as part of the basic block for
       // legacy reaasons. Grab the next instruction and use it's block pointer
       // instead.
-      const auto next_index =
-          (continue_inst - &_.ordered_instructions()[0]) + 1;
+      const auto next_index = continue_inst->LineNum();
       const auto& next_inst = _.ordered_instructions()[next_index];
       const auto* continue_target = next_inst.block();
       if (header->id() != continue_id) {
@@ -889,6 +897,16 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
              << _.getIdName(function.id());
     }
 
+    // The cost of the dominance and structure checks below grows with the
+    // number of edges of the CFG.
+    size_t num_edges = 0;
+    for (const auto block : function.ordered_blocks()) {
+      num_edges += block->successors()->size();
+    }
+    if (!_.ChargeWork(spv_validator_work_limit_max_cfg_edges, num_edges)) {
+      return _.WorkLimitError(_.FindDef(function.id()));
+    }
+
     // Set each block's immediate dominator.
     //
     // We want to analyze all the blocks in the function, even in degenerate
@@ -69,6 +69,55 @@ struct LayoutConstraints {
 using MemberConstraints = std::unordered_map<std::pair<uint32_t, uint32_t>,
                                              LayoutConstraints, PairHash>;
 
+// Identifies a type laid out with the given inherited layout constraints.
+// For base alignments, |round_up| records whether structs and arrays are
+// aligned to a multiple of 16 bytes.
+struct LayoutKey {
+  LayoutKey(uint32_t the_type_id, const LayoutConstraints& inherited,
+            bool the_round_up = false)
+      : type_id(the_type_id),
+        majorness(inherited.majorness),
+        matrix_stride(inherited.matrix_stride),
+        round_up(the_round_up) {}
+
+  bool operator==(const LayoutKey& other) const {
+    return type_id == other.type_id && majorness == other.majorness &&
+           matrix_stride == other.matrix_stride && round_up == other.round_up;
+  }
+
+  uint32_t type_id;
+  MatrixLayout majorness;
+  uint32_t matrix_stride;
+  bool round_up;
+};
+
+// A functor for hashing layout keys.
+struct LayoutKeyHash {
+  std::size_t operator()(const LayoutKey& key) const {
+    return static_cast<std::size_t>(key.type_id) ^
+           (static_cast<std::size_t>(key.matrix_stride) << 8) ^
+           (static_cast<std::size_t>(key.majorness) << 1) ^
+           static_cast<std::size_t>(key.round_up);
+  }
+};
+
+// Layout information computed while checking the layouts of the buffers of a
+// module.  Sizes and alignments only depend on a type and the layout
+// constraints it inherits, and member constraints only depend on the
+// decorations of a struct, so each of these is computed at most once, however
+// many variables and enclosing structs use a type.
+struct LayoutCache {
+  MemberConstraints constraints;
+  // Structs whose member constraints are in |constraints|.
+  std::unordered_set<uint32_t> structs_with_constraints;
+  // Offsets of the members of structs, or 0xffffffff for members without an
+  // Offset decoration.
+  std::unordered_map<uint32_t, std::vector<uint32_t>> member_offsets;
+  std::unordered_map<LayoutKey, uint32_t, LayoutKeyHash> sizes;
+  std::unordered_map<LayoutKey, uint32_t, LayoutKeyHash> base_alignments;
+  std::unordered_map<uint32_t, uint32_t> scalar_alignments;
+};
+
 // Returns the array stride of the given array type.
 uint32_t GetArrayStride(uint32_t array_id, ValidationState_t& vstate) {
   for (auto& decoration : vstate.id_decorations(array_id)) {
@@ -173,18 +222,43 @@ bool isMissingOffsetInStruct(uint32_t struct_id, ValidationState_t& vstate) {
                       [](const bool b) { return b; });
 }
 
+// Returns the offsets of the members of the given struct, with 0xffffffff
+// for members that have no Offset decoration.
+const std::vector<uint32_t>& getMemberOffsets(uint32_t struct_id,
+                                              LayoutCache& cache,
+                                              ValidationState_t& vstate) {
+  const auto cached = cache.member_offsets.find(struct_id);
+  if (cached != cache.member_offsets.end()) return cached->second;
+
+  const auto num_members = uint32_t(getStructMembers(struct_id, vstate).size());
+  std::vector<uint32_t> offsets(num_members, 0xffffffff);
+  for (uint32_t memberIdx = 0; memberIdx < num_members; memberIdx++) {
+    auto member_decorations =
+        vstate.id_member_decorations(struct_id, memberIdx);
+    for (auto decoration = member_decorations.begin;
+         decoration != member_decorations.end; ++decoration) {
+      assert(decoration->struct_member_index() == (int)memberIdx);
+      if (SpvDecorationOffset == decoration->dec_type()) {
+        offsets[memberIdx] = decoration->params()[0];
+      }
+    }
+  }
+  return cache.member_offsets[struct_id] = std::move(offsets);
+}
+
 // Rounds x up to the next alignment. Assumes alignment is a power of two.
 uint32_t align(uint32_t x, uint32_t alignment) {
   return (x + alignment - 1) & ~(alignment - 1);
 }
 
-// Returns base alignment of struct member. If |roundUp| is true, also
-// ensure that structs and arrays are aligned at least to a multiple of 16
-// bytes.
 uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
                           const LayoutConstraints& inherited,
-                          MemberConstraints& constraints,
-                          ValidationState_t& vstate) {
+                          LayoutCache& cache, ValidationState_t& vstate);
+
+// Computes the base alignment of a struct member; see getBaseAlignment.
+uint32_t computeBaseAlignment(uint32_t member_id, bool roundUp,
+                              const LayoutConstraints& inherited,
+                              LayoutCache& cache, ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   // Minimal alignment is byte-aligned.
@@ -205,7 +279,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
       const auto componentId = words[2];
       const auto numComponents = words[3];
       const auto componentAlignment = getBaseAlignment(
-          componentId, roundUp, inherited, constraints, vstate);
+          componentId, roundUp, inherited, cache, vstate);
       baseAlignment =
           componentAlignment * (numComponents == 3 ? 4 : numComponents);
       break;
@@ -213,8 +287,8 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case SpvOpTypeMatrix: {
       const auto column_type = words[2];
       if (inherited.majorness == kColumnMajor) {
-        baseAlignment = getBaseAlignment(column_type, roundUp, inherited,
-                                         constraints, vstate);
+        baseAlignment =
+            getBaseAlignment(column_type, roundUp, inherited, cache, vstate);
       } else {
         // A row-major matrix of C columns has a base alignment equal to the
         // base alignment of a vector of C matrix components.
@@ -222,7 +296,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
         const auto component_inst = vstate.FindDef(column_type);
         const auto component_id = component_inst->words()[2];
         const auto componentAlignment = getBaseAlignment(
-            component_id, roundUp, inherited, constraints, vstate);
+            component_id, roundUp, inherited, cache, vstate);
         baseAlignment =
             componentAlignment * (num_columns == 3 ? 4 : num_columns);
       }
@@ -231,7 +305,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case SpvOpTypeArray:
     case SpvOpTypeRuntimeArray:
       baseAlignment =
-          getBaseAlignment(words[2], roundUp, inherited, constraints, vstate);
+          getBaseAlignment(words[2], roundUp, inherited, cache, vstate);
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
       break;
     case SpvOpTypeStruct: {
@@ -239,11 +313,11 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
       for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
            memberIdx < numMembers; ++memberIdx) {
         const auto id = members[memberIdx];
-        const auto& constraint =
-            constraints[std::make_pair(member_id, memberIdx)];
-        baseAlignment = std::max(
-            baseAlignment,
-            getBaseAlignment(id, roundUp, constraint, constraints, vstate));
+        const auto constraint =
+            cache.constraints[std::make_pair(member_id, memberIdx)];
+        baseAlignment =
+            std::max(baseAlignment,
+                     getBaseAlignment(id, roundUp, constraint, cache, vstate));
       }
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
       break;
@@ -259,8 +333,27 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
   return baseAlignment;
 }
 
-// Returns scalar alignment of a type.
-uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
+// Returns base alignment of struct member. If |roundUp| is true, also
+// ensure that structs and arrays are aligned at least to a multiple of 16
+// bytes.
+uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
+                          const LayoutConstraints& inherited,
+                          LayoutCache& cache, ValidationState_t& vstate) {
+  const LayoutKey key(member_id, inherited, roundUp);
+  const auto cached = cache.base_alignments.find(key);
+  if (cached != cache.base_alignments.end()) return cached->second;
+  const auto alignment =
+      computeBaseAlignment(member_id, roundUp, inherited, cache, vstate);
+  cache.base_alignments.emplace(key, alignment);
+  return alignment;
+}
+
+uint32_t getScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                            ValidationState_t& vstate);
+
+// Computes the scalar alignment of a type; see getScalarAlignment.
+uint32_t computeScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                                ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(type_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -279,7 +372,7 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
     case SpvOpTypeArray:
     case SpvOpTypeRuntimeArray: {
       const auto compositeMemberTypeId = words[2];
-      return getScalarAlignment(compositeMemberTypeId, vstate);
+      return getScalarAlignment(compositeMemberTypeId, cache, vstate);
     }
     case SpvOpTypeStruct: {
       const auto members = getStructMembers(type_id, vstate);
@@ -287,7 +380,7 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
       for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
            memberIdx < numMembers; ++memberIdx) {
         const auto id = members[memberIdx];
-        uint32_t member_alignment = getScalarAlignment(id, vstate);
+        uint32_t member_alignment = getScalarAlignment(id, cache, vstate);
         if (member_alignment > max_member_alignment) {
           max_member_alignment = member_alignment;
         }
@@ -304,10 +397,22 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
   return 1;
 }
 
-// Returns size of a struct member. Doesn't include padding at the end of struct
-// or array.  Assumes that in the struct case, all members have offsets.
+// Returns scalar alignment of a type.
+uint32_t getScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                            ValidationState_t& vstate) {
+  const auto cached = cache.scalar_alignments.find(type_id);
+  if (cached != cache.scalar_alignments.end()) return cached->second;
+  const auto alignment = computeScalarAlignment(type_id, cache, vstate);
+  cache.scalar_alignments.emplace(type_id, alignment);
+  return alignment;
+}
+
 uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
-                 MemberConstraints& constraints, ValidationState_t& vstate) {
+                 LayoutCache& cache, ValidationState_t& vstate);
+
+// Computes the size of a struct member; see getSize.
+uint32_t computeSize(uint32_t member_id, const LayoutConstraints& inherited,
+                     LayoutCache& cache, ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -325,7 +430,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       const auto componentId = words[2];
       const auto numComponents = words[3];
       const auto componentSize =
-          getSize(componentId, inherited, constraints, vstate);
+          getSize(componentId, inherited, cache, vstate);
       const auto size = componentSize * numComponents;
       return size;
     }
@@ -336,7 +441,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       const uint32_t num_elem = sizeInst->words()[3];
       const uint32_t elem_type = words[2];
       const uint32_t elem_size =
-          getSize(elem_type, inherited, constraints, vstate);
+          getSize(elem_type, inherited, cache, vstate);
       // Account for gaps due to alignments in the first N-1 elements,
       // then add the size of the last element.
       const auto size =
@@ -356,7 +461,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
         const auto num_rows = component_inst->words()[3];
         const auto scalar_elem_type = component_inst->words()[2];
         const uint32_t scalar_elem_size =
-            getSize(scalar_elem_type, inherited, constraints, vstate);
+            getSize(scalar_elem_type, inherited, cache, vstate);
         return (num_rows - 1) * inherited.matrix_stride +
                num_columns * scalar_elem_size;
       }
@@ -366,22 +471,15 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       if (members.empty()) return 0;
       const auto lastIdx = uint32_t(members.size() - 1);
       const auto& lastMember = members.back();
-      uint32_t offset = 0xffffffff;
       // Find the offset of the last element and add the size.
-      auto member_decorations =
-          vstate.id_member_decorations(member_id, lastIdx);
-      for (auto decoration = member_decorations.begin;
-           decoration != member_decorations.end; ++decoration) {
-        assert(decoration->struct_member_index() == (int)lastIdx);
-        if (SpvDecorationOffset == decoration->dec_type()) {
-          offset = decoration->params()[0];
-        }
-      }
+      const uint32_t offset =
+          getMemberOffsets(member_id, cache, vstate)[lastIdx];
       // This check depends on the fact that all members have offsets.  This
       // has been checked earlier in the flow.
       assert(offset != 0xffffffff);
-      const auto& constraint = constraints[std::make_pair(lastMember, lastIdx)];
-      return offset + getSize(lastMember, constraint, constraints, vstate);
+      const auto constraint =
+          cache.constraints[std::make_pair(lastMember, lastIdx)];
+      return offset + getSize(lastMember, constraint, cache, vstate);
     }
     case SpvOpTypePointer:
       return vstate.pointer_size_and_alignment();
@@ -391,6 +489,18 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
   }
 }
 
+// Returns size of a struct member. Doesn't include padding at the end of struct
+// or array.  Assumes that in the struct case, all members have offsets.
+uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
+                 LayoutCache& cache, ValidationState_t& vstate) {
+  const LayoutKey key(member_id, inherited);
+  const auto cached = cache.sizes.find(key);
+  if (cached != cache.sizes.end()) return cached->second;
+  const auto size = computeSize(member_id, inherited, cache, vstate);
+  cache.sizes.emplace(key, size);
+  return size;
+}
+
 // A member is defined to improperly straddle if either of the following are
 // true:
 // - It is a vector with total size less than or equal to 16 bytes, and has
@@ -400,9 +510,8 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
 // decorations placing its first byte at a non-integer multiple of 16.
 bool hasImproperStraddle(uint32_t id, uint32_t offset,
                          const LayoutConstraints& inherited,
-                         MemberConstraints& constraints,
-                         ValidationState_t& vstate) {
-  const auto size = getSize(id, inherited, constraints, vstate);
+                         LayoutCache& cache, ValidationState_t& vstate) {
+  const auto size = getSize(id, inherited, cache, vstate);
   const auto F = offset;
   const auto L = offset + size - 1;
   if (size <= 16) {
@@ -427,10 +536,13 @@ bool IsAlignedTo(uint32_t offset, uint32_t alignment) {
 spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
                          const char* decoration_str, bool blockRules,
                          bool scalar_block_layout,
-                         uint32_t incoming_offset,
-                         MemberConstraints& constraints,
+                         uint32_t incoming_offset, LayoutCache& cache,
                          ValidationState_t& vstate) {
   if (vstate.options()->skip_block_layout) return SPV_SUCCESS;
+  // Structs nested in several members are checked once per member.
+  if (!vstate.ChargeWork(spv_validator_work_limit_max_type_traversal, 1)) {
+    return vstate.WorkLimitError(vstate.FindDef(struct_id));
+  }
 
   // blockRules are the same as bufferBlock rules if the uniform buffer
   // standard layout extension is being used.
@@ -465,26 +577,13 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     uint32_t member;
     uint32_t offset;
   };
+  const auto& declared_offsets = getMemberOffsets(struct_id, cache, vstate);
   std::vector<MemberOffsetPair> member_offsets;
   member_offsets.reserve(members.size());
   for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
        memberIdx < numMembers; memberIdx++) {
-    uint32_t offset = 0xffffffff;
-    auto member_decorations =
-        vstate.id_member_decorations(struct_id, memberIdx);
-    for (auto decoration = member_decorations.begin;
-         decoration != member_decorations.end; ++decoration) {
-      assert(decoration->struct_member_index() == (int)memberIdx);
-      switch (decoration->dec_type()) {
-        case SpvDecorationOffset:
-          offset = decoration->params()[0];
-          break;
-        default:
-          break;
-      }
-    }
-    member_offsets.push_back(
-        MemberOffsetPair{memberIdx, incoming_offset + offset});
+    member_offsets.push_back(MemberOffsetPair{
+        memberIdx, incoming_offset + declared_offsets[memberIdx]});
   }
   std::stable_sort(
       member_offsets.begin(), member_offsets.end(),
@@ -500,18 +599,18 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     const auto memberIdx = member_offset.member;
     const auto offset = member_offset.offset;
     auto id = members[member_offset.member];
-    const LayoutConstraints& constraint =
-        constraints[std::make_pair(struct_id, uint32_t(memberIdx))];
+    const LayoutConstraints constraint =
+        cache.constraints[std::make_pair(struct_id, uint32_t(memberIdx))];
     // Scalar layout takes precedence because it's more permissive, and implying
     // an alignment that divides evenly into the alignment that would otherwise
     // be used.
     const auto alignment =
         scalar_block_layout
-            ? getScalarAlignment(id, vstate)
-            : getBaseAlignment(id, blockRules, constraint, constraints, vstate);
+            ? getScalarAlignment(id, cache, vstate)
+            : getBaseAlignment(id, blockRules, constraint, cache, vstate);
     const auto inst = vstate.FindDef(id);
     const auto opcode = inst->opcode();
-    const auto size = getSize(id, constraint, constraints, vstate);
+    const auto size = getSize(id, constraint, cache, vstate);
     // Check offset.
     if (offset == 0xffffffff)
       return fail(memberIdx) << "is missing an Offset decoration";
@@ -520,7 +619,8 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
       // In relaxed block layout, the vector offset must be aligned to the
       // vector's scalar element type.
       const auto componentId = inst->words()[2];
-      const auto scalar_alignment = getScalarAlignment(componentId, vstate);
+      const auto scalar_alignment =
+          getScalarAlignment(componentId, cache, vstate);
       if (!IsAlignedTo(offset, scalar_alignment)) {
         return fail(memberIdx)
                << "at offset " << offset
@@ -541,7 +641,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (!scalar_block_layout && relaxed_block_layout) {
       // Check improper straddle of vectors.
       if (SpvOpTypeVector == opcode &&
-          hasImproperStraddle(id, offset, constraint, constraints, vstate))
+          hasImproperStraddle(id, offset, constraint, cache, vstate))
         return fail(memberIdx)
                << "is an improperly straddling vector at offset " << offset;
     }
@@ -550,8 +650,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (SpvOpTypeStruct == opcode &&
         SPV_SUCCESS != (recursive_status = checkLayout(
                             id, storage_class_str, decoration_str, blockRules,
-                            scalar_block_layout,
-                            offset, constraints, vstate)))
+                            scalar_block_layout, offset, cache, vstate)))
       return recursive_status;
     // Check matrix stride.
     if (SpvOpTypeMatrix == opcode) {
@@ -608,7 +707,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
           if (SPV_SUCCESS !=
               (recursive_status = checkLayout(
                    typeId, storage_class_str, decoration_str, blockRules,
-                   scalar_block_layout, next_offset, constraints, vstate)))
+                   scalar_block_layout, next_offset, cache, vstate)))
             return recursive_status;
 
           seen[next_offset % 16] = true;
@@ -617,13 +716,14 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
 
       // Proceed to the element in case it is an array.
       array_inst = element_inst;
-      array_alignment = scalar_block_layout
-                            ? getScalarAlignment(array_inst->id(), vstate)
-                            : getBaseAlignment(array_inst->id(), blockRules,
-                                               constraint, constraints, vstate);
+      array_alignment =
+          scalar_block_layout
+              ? getScalarAlignment(array_inst->id(), cache, vstate)
+              : getBaseAlignment(array_inst->id(), blockRules, constraint,
+                                 cache, vstate);
 
       const auto element_size =
-          getSize(element_inst->id(), constraint, constraints, vstate);
+          getSize(element_inst->id(), constraint, cache, vstate);
       if (element_size > array_stride) {
         return fail(memberIdx)
                << "contains an array with stride " << array_stride
@@ -936,26 +1036,24 @@ spv_result_t CheckDecorationsOfEntryPoints(ValidationState_t& vstate) {
   return SPV_SUCCESS;
 }
 
-// Load |constraints| with all the member constraints for structs contained
-// within the given array type.
-void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
-                                      uint32_t array_id,
-                                      const LayoutConstraints& inherited,
+// Load |cache| with all the member constraints for structs contained within
+// the given array type.
+void ComputeMemberConstraintsForArray(LayoutCache* cache, uint32_t array_id,
                                       ValidationState_t& vstate);
 
-// Load |constraints| with all the member constraints for the given struct,
-// and all its contained structs.
-void ComputeMemberConstraintsForStruct(MemberConstraints* constraints,
-                                       uint32_t struct_id,
-                                       const LayoutConstraints& inherited,
+// Load |cache| with all the member constraints for the given struct, and all
+// its contained structs.  The constraints of a struct member only depend on
+// the member's decorations, so structs already in |cache| are skipped.
+void ComputeMemberConstraintsForStruct(LayoutCache* cache, uint32_t struct_id,
                                        ValidationState_t& vstate) {
-  assert(constraints);
+  assert(cache);
+  if (!cache->structs_with_constraints.insert(struct_id).second) return;
   const auto& members = getStructMembers(struct_id, vstate);
   for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
        memberIdx < numMembers; memberIdx++) {
     LayoutConstraints& constraint =
-        (*constraints)[std::make_pair(struct_id, memberIdx)];
-    constraint = inherited;
+        cache->constraints[std::make_pair(struct_id, memberIdx)];
+    constraint = LayoutConstraints();
     auto member_decorations =
         vstate.id_member_decorations(struct_id, memberIdx);
     for (auto decoration = member_decorations.begin;
@@ -983,12 +1081,10 @@ void ComputeMemberConstraintsForStruct(MemberConstraints* constraints,
     switch (opcode) {
       case SpvOpTypeArray:
       case SpvOpTypeRuntimeArray:
-        ComputeMemberConstraintsForArray(constraints, member_type_id, inherited,
-                                         vstate);
+        ComputeMemberConstraintsForArray(cache, member_type_id, vstate);
         break;
       case SpvOpTypeStruct:
-        ComputeMemberConstraintsForStruct(constraints, member_type_id,
-                                          inherited, vstate);
+        ComputeMemberConstraintsForStruct(cache, member_type_id, vstate);
         break;
       default:
         break;
@@ -996,23 +1092,19 @@ void ComputeMemberConstraintsForStruct(MemberConstraints* constraints,
   }
 }
 
-void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
-                                      uint32_t array_id,
-                                      const LayoutConstraints& inherited,
+void ComputeMemberConstraintsForArray(LayoutCache* cache, uint32_t array_id,
                                       ValidationState_t& vstate) {
-  assert(constraints);
+  assert(cache);
   auto elem_type_id = vstate.FindDef(array_id)->words()[2];
   const auto elem_type_inst = vstate.FindDef(elem_type_id);
   const auto opcode = elem_type_inst->opcode();
   switch (opcode) {
     case SpvOpTypeArray:
     case SpvOpTypeRuntimeArray:
-      ComputeMemberConstraintsForArray(constraints, elem_type_id, inherited,
-                                       vstate);
+      ComputeMemberConstraintsForArray(cache, elem_type_id, vstate);
       break;
     case SpvOpTypeStruct:
-      ComputeMemberConstraintsForStruct(constraints, elem_type_id, inherited,
-                                        vstate);
+      ComputeMemberConstraintsForStruct(cache, elem_type_id, vstate);
       break;
     default:
       break;
@@ -1022,6 +1114,8 @@ void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
 spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
   // Set of entry points that are known to use a push constant.
   std::unordered_set<uint32_t> uses_push_constant;
+  // Layout information shared by all the buffers.
+  LayoutCache layout_cache;
   for (const auto& inst : vstate.ordered_instructions()) {
     const auto& words = inst.words();
     if (SpvOpVariable == inst.opcode()) {
@@ -1115,9 +1209,7 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
         }
         // Struct requirement is checked on variables so just move on here.
         if (SpvOpTypeStruct != id_inst->opcode()) continue;
-        MemberConstraints constraints;
-        ComputeMemberConstraintsForStruct(&constraints, id, LayoutConstraints(),
-                                          vstate);
+        ComputeMemberConstraintsForStruct(&layout_cache, id, vstate);
         // Prepare for messages
         const char* sc_str =
             uniform ? "Uniform"
@@ -1259,13 +1351,13 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
                        (SPV_SUCCESS !=
                         (recursive_status = checkLayout(
                              id, sc_str, deco_str, true, scalar_block_layout, 0,
-                             constraints, vstate)))) {
+                             layout_cache, vstate)))) {
               return recursive_status;
             } else if (bufferRules &&
                        (SPV_SUCCESS !=
                         (recursive_status = checkLayout(
                              id, sc_str, deco_str, false, scalar_block_layout,
-                             0, constraints, vstate)))) {
+                             0, layout_cache, vstate)))) {
               return recursive_status;
             }
           }
@@ -58,21 +58,13 @@ spv_result_t DerivativesPass(ValidationState_t& _, const Instruction* inst) {
                << spvOpcodeString(opcode);
       }
       _.function(inst->function()->id())
-          ->RegisterExecutionModelLimitation([opcode](SpvExecutionModel model,
-                                                      std::string* message) {
-            if (model != SpvExecutionModelFragment &&
-                model != SpvExecutionModelGLCompute) {
-              if (message) {
-                *message =
-                    std::string(
-                        "Derivative instructions require Fragment or GLCompute "
-                        "execution model: ") +
-                    spvOpcodeString(opcode);
-              }
-              return false;
-            }
-            return true;
-          });
+          ->RegisterExecutionModelLimitation(
+              ExecutionModelMask(
+                  {SpvExecutionModelFragment, SpvExecutionModelGLCompute}),
+              "",
+              "Derivative instructions require Fragment or GLCompute "
+              "execution model: ",
+              spvOpcodeString(opcode));
       _.function(inst->function()->id())
           ->RegisterLimitation([opcode](const ValidationState_t& state,
                                         const Function* entry_point,
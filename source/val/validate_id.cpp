@@ -37,16 +37,32 @@
 namespace spvtools {
 namespace val {
 
-spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst) {
+namespace {
+
+// Calls |f| with the definition of each id used by |inst| and the index of the
+// word where it is used.
+template <typename F>
+void ForEachIdUse(ValidationState_t& _, const Instruction* inst, F f) {
   for (auto& operand : inst->operands()) {
     const spv_operand_type_t& type = operand.type;
     const uint32_t operand_id = inst->word(operand.offset);
     if (spvIsIdType(type) && type != SPV_OPERAND_TYPE_RESULT_ID) {
-      if (auto def = _.FindDef(operand_id))
-        def->RegisterUse(inst, operand.offset);
+      if (auto def = _.FindDef(operand_id)) f(def, operand.offset);
     }
   }
+}
+
+}  // namespace
+
+spv_result_t CountIdUses(ValidationState_t& _, const Instruction* inst) {
+  ForEachIdUse(_, inst, [](Instruction* def, uint32_t) { def->CountUse(); });
+  return SPV_SUCCESS;
+}
 
+spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst) {
+  ForEachIdUse(_, inst, [inst](Instruction* def, uint32_t index) {
+    def->RegisterUse(inst, index);
+  });
   return SPV_SUCCESS;
 }
 
@@ -71,6 +87,10 @@ spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
           const Instruction* use = use_index_pair.first;
           if (const BasicBlock* use_block = use->block()) {
             if (use_block->reachable() == false) continue;
+            if (!_.ChargeWork(spv_validator_work_limit_max_dominance_queries,
+                              1)) {
+              return _.WorkLimitError(use);
+            }
             if (use->opcode() == SpvOpPhi) {
               if (phi_ids.insert(use->id()).second) {
                 phi_instructions.push_back(use);
@@ -112,6 +132,9 @@ spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
       const Instruction* variable = _.FindDef(phi->word(i));
       const BasicBlock* parent =
           phi->function()->GetBlock(phi->word(i + 1)).first;
+      if (!_.ChargeWork(spv_validator_work_limit_max_dominance_queries, 1)) {
+        return _.WorkLimitError(phi);
+      }
       if (variable->block() && parent->reachable() &&
           !variable->block()->dominates(*parent)) {
         return _.diag(SPV_ERROR_INVALID_ID, phi)
@@ -1606,9 +1606,9 @@ spv_result_t ValidateImageRead(ValidationState_t& _, const Instruction* inst) {
 
     _.function(inst->function()->id())
         ->RegisterExecutionModelLimitation(
-            SpvExecutionModelFragment,
-            std::string("Dim SubpassData requires Fragment execution model: ") +
-                spvOpcodeString(opcode));
+            ExecutionModelMask(SpvExecutionModelFragment), "",
+            "Dim SubpassData requires Fragment execution model: ",
+            spvOpcodeString(opcode));
   }
 
   if (_.GetIdOpcode(info.sampled_type) != SpvOpTypeVoid) {
@@ -1896,18 +1896,10 @@ spv_result_t ValidateImageQueryLod(ValidationState_t& _,
                                    const Instruction* inst) {
   _.function(inst->function()->id())
       ->RegisterExecutionModelLimitation(
-          [&](SpvExecutionModel model, std::string* message) {
-            if (model != SpvExecutionModelFragment &&
-                model != SpvExecutionModelGLCompute) {
-              if (message) {
-                *message = std::string(
-                    "OpImageQueryLod requires Fragment or GLCompute execution "
-                    "model");
-              }
-              return false;
-            }
-            return true;
-          });
+          ExecutionModelMask(
+              {SpvExecutionModelFragment, SpvExecutionModelGLCompute}),
+          "",
+          "OpImageQueryLod requires Fragment or GLCompute execution model");
   _.function(inst->function()->id())
       ->RegisterLimitation([](const ValidationState_t& state,
                               const Function* entry_point,
@@ -2068,21 +2060,13 @@ spv_result_t ImagePass(ValidationState_t& _, const Instruction* inst) {
   const SpvOp opcode = inst->opcode();
   if (IsImplicitLod(opcode)) {
     _.function(inst->function()->id())
-        ->RegisterExecutionModelLimitation([opcode](SpvExecutionModel model,
-                                                    std::string* message) {
-          if (model != SpvExecutionModelFragment &&
-              model != SpvExecutionModelGLCompute) {
-            if (message) {
-              *message =
-                  std::string(
-                      "ImplicitLod instructions require Fragment or GLCompute "
-                      "execution model: ") +
-                  spvOpcodeString(opcode);
-            }
-            return false;
-          }
-          return true;
-        });
+        ->RegisterExecutionModelLimitation(
+            ExecutionModelMask(
+                {SpvExecutionModelFragment, SpvExecutionModelGLCompute}),
+            "",
+            "ImplicitLod instructions require Fragment or GLCompute "
+            "execution model: ",
+            spvOpcodeString(opcode));
     _.function(inst->function()->id())
         ->RegisterLimitation([opcode](const ValidationState_t& state,
                                       const Function* entry_point,
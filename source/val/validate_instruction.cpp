@@ -41,6 +41,11 @@ namespace spvtools {
 namespace val {
 namespace {
 
+// Kinds of memoized opcode requirements, which do not collide with operand
+// types.
+const uint32_t kOpcodeCapabilities = 0xfffffffeu;
+const uint32_t kOpcodeVersion = 0xffffffffu;
+
 std::string ToString(const CapabilitySet& capabilities,
                      const AssemblyGrammar& grammar) {
   std::stringstream ss;
@@ -171,6 +176,10 @@ spv_result_t CheckRequiredCapabilities(ValidationState_t& state,
     return SPV_SUCCESS;
   }
 
+  // The requirements of an operand value only need to be looked up and
+  // checked once all capabilities are known.
+  if (state.AreRequirementsSatisfied(operand.type, word)) return SPV_SUCCESS;
+
   CapabilitySet enabling_capabilities;
   spv_operand_desc operand_desc = nullptr;
   const auto lookup_result =
@@ -208,8 +217,13 @@ spv_result_t CheckRequiredCapabilities(ValidationState_t& state,
                << ToString(enabling_capabilities, state.grammar());
       }
     }
-    return OperandVersionExtensionCheck(state, inst, which_operand,
-                                        *operand_desc, word);
+    if (auto error = OperandVersionExtensionCheck(state, inst, which_operand,
+                                                  *operand_desc, word)) {
+      return error;
+    }
+    if (state.capabilities_complete()) {
+      state.SetRequirementsSatisfied(operand.type, word);
+    }
   }
   return SPV_SUCCESS;
 }
@@ -242,12 +256,17 @@ spv_result_t ReservedCheck(ValidationState_t& _, const Instruction* inst) {
 // in the module.
 spv_result_t CapabilityCheck(ValidationState_t& _, const Instruction* inst) {
   const SpvOp opcode = inst->opcode();
-  CapabilitySet opcode_caps = EnablingCapabilitiesForOp(_, opcode);
-  if (!_.HasAnyOfCapabilities(opcode_caps)) {
-    return _.diag(SPV_ERROR_INVALID_CAPABILITY, inst)
-           << "Opcode " << spvOpcodeString(opcode)
-           << " requires one of these capabilities: "
-           << ToString(opcode_caps, _.grammar());
+  if (!_.AreRequirementsSatisfied(kOpcodeCapabilities, opcode)) {
+    CapabilitySet opcode_caps = EnablingCapabilitiesForOp(_, opcode);
+    if (!_.HasAnyOfCapabilities(opcode_caps)) {
+      return _.diag(SPV_ERROR_INVALID_CAPABILITY, inst)
+             << "Opcode " << spvOpcodeString(opcode)
+             << " requires one of these capabilities: "
+             << ToString(opcode_caps, _.grammar());
+    }
+    if (_.capabilities_complete()) {
+      _.SetRequirementsSatisfied(kOpcodeCapabilities, opcode);
+    }
   }
   for (size_t i = 0; i < inst->operands().size(); ++i) {
     const auto& operand = inst->operand(i);
@@ -278,7 +297,7 @@ spv_result_t CapabilityCheck(ValidationState_t& _, const Instruction* inst) {
 // Checks that the instruction can be used in this target environment's base
 // version. Assumes that CapabilityCheck has checked direct capability
 // dependencies for the opcode.
-spv_result_t VersionCheck(ValidationState_t& _, const Instruction* inst) {
+spv_result_t CheckOpcodeVersion(ValidationState_t& _, const Instruction* inst) {
   const auto opcode = inst->opcode();
   spv_opcode_desc inst_desc;
   const spv_result_t r = _.grammar().lookupOpcode(opcode, &inst_desc);
@@ -345,6 +364,18 @@ spv_result_t VersionCheck(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+// Runs CheckOpcodeVersion, unless the opcode is already known to satisfy its
+// version and extension requirements.
+spv_result_t VersionCheck(ValidationState_t& _, const Instruction* inst) {
+  const auto opcode = inst->opcode();
+  if (_.AreRequirementsSatisfied(kOpcodeVersion, opcode)) return SPV_SUCCESS;
+  if (auto error = CheckOpcodeVersion(_, inst)) return error;
+  if (_.capabilities_complete()) {
+    _.SetRequirementsSatisfied(kOpcodeVersion, opcode);
+  }
+  return SPV_SUCCESS;
+}
+
 // Checks that the Resuld <id> is within the valid bound.
 spv_result_t LimitCheckIdBound(ValidationState_t& _, const Instruction* inst) {
   if (inst->id() >= _.getIdBound()) {
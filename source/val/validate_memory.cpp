@@ -982,22 +982,13 @@ spv_result_t ValidateStore(ValidationState_t& _, const Instruction* inst) {
       return _.diag(SPV_ERROR_INVALID_ID, inst)
              << "ShaderRecordBufferKHR Storage Class variables are read only";
     } else if (storage_class == SpvStorageClassHitAttributeKHR) {
-      std::string errorVUID = _.VkErrorID(4703);
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [errorVUID](SpvExecutionModel model, std::string* message) {
-                if (model == SpvExecutionModelAnyHitKHR ||
-                    model == SpvExecutionModelClosestHitKHR) {
-                  if (message) {
-                    *message =
-                        errorVUID +
-                        "HitAttributeKHR Storage Class variables are read only "
-                        "with AnyHitKHR and ClosestHitKHR";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ~ExecutionModelMask({SpvExecutionModelAnyHitKHR,
+                                   SpvExecutionModelClosestHitKHR}),
+              _.VkErrorID(4703),
+              "HitAttributeKHR Storage Class variables are read only with "
+              "AnyHitKHR and ClosestHitKHR");
     }
 
     if (spvIsVulkanEnv(_.context()->target_env) &&
@@ -37,9 +37,9 @@ spv_result_t PrimitivesPass(ValidationState_t& _, const Instruction* inst) {
     case SpvOpEndStreamPrimitive:
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              SpvExecutionModelGeometry,
-              std::string(spvOpcodeString(opcode)) +
-                  " instructions require Geometry execution model");
+              ExecutionModelMask(SpvExecutionModelGeometry),
+              spvOpcodeString(opcode),
+              " instructions require Geometry execution model");
       break;
     default:
       break;
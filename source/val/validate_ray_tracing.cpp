@@ -30,19 +30,12 @@ spv_result_t RayTracingPass(ValidationState_t& _, const Instruction* inst) {
     case SpvOpTraceRayKHR: {
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [](SpvExecutionModel model, std::string* message) {
-                if (model != SpvExecutionModelRayGenerationKHR &&
-                    model != SpvExecutionModelClosestHitKHR &&
-                    model != SpvExecutionModelMissKHR) {
-                  if (message) {
-                    *message =
-                        "OpTraceRayKHR requires RayGenerationKHR, "
-                        "ClosestHitKHR and MissKHR execution models";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                  SpvExecutionModelClosestHitKHR,
+                                  SpvExecutionModelMissKHR}),
+              "",
+              "OpTraceRayKHR requires RayGenerationKHR, ClosestHitKHR and "
+              "MissKHR execution models");
 
       if (_.GetIdOpcode(_.GetOperandTypeId(inst, 0)) !=
           SpvOpTypeAccelerationStructureKHR) {
@@ -124,17 +117,9 @@ spv_result_t RayTracingPass(ValidationState_t& _, const Instruction* inst) {
     case SpvOpReportIntersectionKHR: {
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [](SpvExecutionModel model, std::string* message) {
-                if (model != SpvExecutionModelIntersectionKHR) {
-                  if (message) {
-                    *message =
-                        "OpReportIntersectionKHR requires IntersectionKHR "
-                        "execution model";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ExecutionModelMask(SpvExecutionModelIntersectionKHR), "",
+              "OpReportIntersectionKHR requires IntersectionKHR execution "
+              "model");
 
       if (!_.IsBoolScalarType(result_type)) {
         return _.diag(SPV_ERROR_INVALID_DATA, inst)
@@ -158,21 +143,14 @@ spv_result_t RayTracingPass(ValidationState_t& _, const Instruction* inst) {
 
     case SpvOpExecuteCallableKHR: {
       _.function(inst->function()->id())
-          ->RegisterExecutionModelLimitation([](SpvExecutionModel model,
-                                                std::string* message) {
-            if (model != SpvExecutionModelRayGenerationKHR &&
-                model != SpvExecutionModelClosestHitKHR &&
-                model != SpvExecutionModelMissKHR &&
-                model != SpvExecutionModelCallableKHR) {
-              if (message) {
-                *message =
-                    "OpExecuteCallableKHR requires RayGenerationKHR, "
-                    "ClosestHitKHR, MissKHR and CallableKHR execution models";
-              }
-              return false;
-            }
-            return true;
-          });
+          ->RegisterExecutionModelLimitation(
+              ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                  SpvExecutionModelClosestHitKHR,
+                                  SpvExecutionModelMissKHR,
+                                  SpvExecutionModelCallableKHR}),
+              "",
+              "OpExecuteCallableKHR requires RayGenerationKHR, ClosestHitKHR, "
+              "MissKHR and CallableKHR execution models");
 
       const uint32_t sbt_index = _.GetOperandTypeId(inst, 0);
       if (!_.IsUnsignedIntScalarType(sbt_index) ||
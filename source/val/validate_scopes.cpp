@@ -108,55 +108,36 @@ spv_result_t ValidateExecutionScope(ValidationState_t& _,
     // OpControlBarrier must only use Subgroup execution scope for a subset of
     // execution models.
     if (opcode == SpvOpControlBarrier && value != SpvScopeSubgroup) {
-      std::string errorVUID = _.VkErrorID(4682);
       _.function(inst->function()->id())
-          ->RegisterExecutionModelLimitation([errorVUID](
-                                                 SpvExecutionModel model,
-                                                 std::string* message) {
-            if (model == SpvExecutionModelFragment ||
-                model == SpvExecutionModelVertex ||
-                model == SpvExecutionModelGeometry ||
-                model == SpvExecutionModelTessellationEvaluation ||
-                model == SpvExecutionModelRayGenerationKHR ||
-                model == SpvExecutionModelIntersectionKHR ||
-                model == SpvExecutionModelAnyHitKHR ||
-                model == SpvExecutionModelClosestHitKHR ||
-                model == SpvExecutionModelMissKHR) {
-              if (message) {
-                *message =
-                    errorVUID +
-                    "in Vulkan environment, OpControlBarrier execution scope "
-                    "must be Subgroup for Fragment, Vertex, Geometry, "
-                    "TessellationEvaluation, RayGeneration, Intersection, "
-                    "AnyHit, ClosestHit, and Miss execution models";
-              }
-              return false;
-            }
-            return true;
-          });
+          ->RegisterExecutionModelLimitation(
+              ~ExecutionModelMask({SpvExecutionModelFragment,
+                                   SpvExecutionModelVertex,
+                                   SpvExecutionModelGeometry,
+                                   SpvExecutionModelTessellationEvaluation,
+                                   SpvExecutionModelRayGenerationKHR,
+                                   SpvExecutionModelIntersectionKHR,
+                                   SpvExecutionModelAnyHitKHR,
+                                   SpvExecutionModelClosestHitKHR,
+                                   SpvExecutionModelMissKHR}),
+              _.VkErrorID(4682),
+              "in Vulkan environment, OpControlBarrier execution scope must be "
+              "Subgroup for Fragment, Vertex, Geometry, "
+              "TessellationEvaluation, RayGeneration, Intersection, AnyHit, "
+              "ClosestHit, and Miss execution models");
     }
 
     // Only subset of execution models support Workgroup.
     if (value == SpvScopeWorkgroup) {
-      std::string errorVUID = _.VkErrorID(4637);
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [errorVUID](SpvExecutionModel model, std::string* message) {
-                if (model != SpvExecutionModelTaskNV &&
-                    model != SpvExecutionModelMeshNV &&
-                    model != SpvExecutionModelTessellationControl &&
-                    model != SpvExecutionModelGLCompute) {
-                  if (message) {
-                    *message =
-                        errorVUID +
-                        "in Vulkan environment, Workgroup execution scope is "
-                        "only for TaskNV, MeshNV, TessellationControl, and "
-                        "GLCompute execution models";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ExecutionModelMask({SpvExecutionModelTaskNV,
+                                  SpvExecutionModelMeshNV,
+                                  SpvExecutionModelTessellationControl,
+                                  SpvExecutionModelGLCompute}),
+              _.VkErrorID(4637),
+              "in Vulkan environment, Workgroup execution scope is only for "
+              "TaskNV, MeshNV, TessellationControl, and GLCompute execution "
+              "models");
     }
 
     // Vulkan generic rules
@@ -240,45 +221,28 @@ spv_result_t ValidateMemoryScope(ValidationState_t& _, const Instruction* inst,
     }
 
     if (value == SpvScopeShaderCallKHR) {
-      std::string errorVUID = _.VkErrorID(4640);
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [errorVUID](SpvExecutionModel model, std::string* message) {
-                if (model != SpvExecutionModelRayGenerationKHR &&
-                    model != SpvExecutionModelIntersectionKHR &&
-                    model != SpvExecutionModelAnyHitKHR &&
-                    model != SpvExecutionModelClosestHitKHR &&
-                    model != SpvExecutionModelMissKHR &&
-                    model != SpvExecutionModelCallableKHR) {
-                  if (message) {
-                    *message =
-                        errorVUID +
-                        "ShaderCallKHR Memory Scope requires a ray tracing "
-                        "execution model";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                  SpvExecutionModelIntersectionKHR,
+                                  SpvExecutionModelAnyHitKHR,
+                                  SpvExecutionModelClosestHitKHR,
+                                  SpvExecutionModelMissKHR,
+                                  SpvExecutionModelCallableKHR}),
+              _.VkErrorID(4640),
+              "ShaderCallKHR Memory Scope requires a ray tracing execution "
+              "model");
     }
 
     if (value == SpvScopeWorkgroup) {
-      std::string errorVUID = _.VkErrorID(4639);
       _.function(inst->function()->id())
           ->RegisterExecutionModelLimitation(
-              [errorVUID](SpvExecutionModel model, std::string* message) {
-                if (model != SpvExecutionModelGLCompute &&
-                    model != SpvExecutionModelTaskNV &&
-                    model != SpvExecutionModelMeshNV) {
-                  if (message) {
-                    *message = errorVUID +
-                               "Workgroup Memory Scope is limited to MeshNV, "
-                               "TaskNV, and GLCompute execution model";
-                  }
-                  return false;
-                }
-                return true;
-              });
+              ExecutionModelMask({SpvExecutionModelGLCompute,
+                                  SpvExecutionModelTaskNV,
+                                  SpvExecutionModelMeshNV}),
+              _.VkErrorID(4639),
+              "Workgroup Memory Scope is limited to MeshNV, TaskNV, and "
+              "GLCompute execution model");
     }
   }
 
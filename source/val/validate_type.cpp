@@ -31,7 +31,7 @@ namespace {
 // to fill out to word granularity.  Assumes that the constant value
 // has
 int64_t ConstantLiteralAsInt64(uint32_t width,
-                               const std::vector<uint32_t>& const_words) {
+                               const utils::Span<uint32_t>& const_words) {
   const uint32_t lo_word = const_words[3];
   if (width <= 32) return int32_t(lo_word);
   assert(width <= 64);
@@ -255,7 +255,7 @@ spv_result_t ValidateTypeArray(ValidationState_t& _, const Instruction* inst) {
   switch (length->opcode()) {
     case SpvOpSpecConstant:
     case SpvOpConstant: {
-      auto& type_words = const_result_type->words();
+      const auto type_words = const_result_type->words();
       const bool is_signed = type_words[3] > 0;
       const uint32_t width = type_words[2];
       const int64_t ivalue = ConstantLiteralAsInt64(width, length->words());
@@ -16,11 +16,16 @@
 
 #include <cassert>
 #include <stack>
+#include <string>
 #include <utility>
 
+#include "source/enum_string_mapping.h"
+#include "source/extensions.h"
 #include "source/opcode.h"
 #include "source/spirv_constant.h"
+#include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
+#include "source/util/hash_combine.h"
 #include "source/val/basic_block.h"
 #include "source/val/construct.h"
 #include "source/val/function.h"
@@ -30,6 +35,10 @@ namespace spvtools {
 namespace val {
 namespace {
 
+// The minimum number of operands in a chunk of operand storage allocated
+// while parsing.
+const size_t kOperandChunkSize = 4096;
+
 ModuleLayoutSection InstructionLayoutSection(
     ModuleLayoutSection current_section, SpvOp op) {
   // See Section 2.4
@@ -102,12 +111,32 @@ bool IsInstructionInLayoutSection(ModuleLayoutSection layout, SpvOp op) {
   return layout == InstructionLayoutSection(layout, op);
 }
 
-// Counts the number of instructions and functions in the file.
-spv_result_t CountInstructions(void* user_data,
-                               const spv_parsed_instruction_t* inst) {
-  ValidationState_t& _ = *(reinterpret_cast<ValidationState_t*>(user_data));
-  if (inst->opcode == SpvOpFunction) _.increment_total_functions();
-  _.increment_total_instructions();
+// State threaded through the pre-parse performed by the ValidationState_t
+// constructor.
+struct PreParseState {
+  ValidationState_t* vstate;
+  // True until the first instruction which is neither OpCapability nor
+  // OpExtension has been seen.
+  bool in_capability_and_extension_block;
+};
+
+// Counts the number of operands in the file, and registers the extensions
+// declared at the beginning of the module.  According to the SPIR-V spec
+// extensions are declared after capabilities and before everything else, so
+// only that leading block is searched.  Doing both in one pass saves the
+// validator a second walk over the leading instructions.
+spv_result_t CountOperandsAndRegisterExtensions(
+    void* user_data, const spv_parsed_instruction_t* inst) {
+  PreParseState& state = *(reinterpret_cast<PreParseState*>(user_data));
+  ValidationState_t& _ = *state.vstate;
+  if (state.in_capability_and_extension_block) {
+    if (inst->opcode == SpvOpExtension) {
+      _.RegisterExtension(inst);
+    } else if (inst->opcode != SpvOpCapability) {
+      state.in_capability_and_extension_block = false;
+    }
+  }
+  _.increment_total_operands(inst->num_operands);
 
   return SPV_SUCCESS;
 }
@@ -116,7 +145,7 @@ spv_result_t setHeader(void* user_data, spv_endianness_t, uint32_t,
                        uint32_t version, uint32_t generator, uint32_t id_bound,
                        uint32_t) {
   ValidationState_t& vstate =
-      *(reinterpret_cast<ValidationState_t*>(user_data));
+      *(reinterpret_cast<PreParseState*>(user_data))->vstate;
   vstate.setIdBound(id_bound);
   vstate.setGenerator(generator);
   vstate.setVersion(version);
@@ -153,6 +182,9 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
       module_functions_(),
       module_capabilities_(),
       module_extensions_(),
+      work_done_(),
+      exceeded_work_limit_(spv_validator_work_limit_max_cfg_edges),
+      work_limit_exceeded_(false),
       ordered_instructions_(),
       all_definitions_(),
       global_vars_(),
@@ -191,31 +223,50 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
       break;
   }
 
-  // Only attempt to count if we have words, otherwise let the other validation
-  // fail and generate an error.
-  if (num_words > 0) {
-    // Count the number of instructions in the binary.
+  // The instructions refer to the words of the module, so keep a host endian
+  // copy of them if needed.
+  spv_const_binary_t binary = {words, num_words};
+  spv_endianness_t endian;
+  if (num_words > 0 && spvBinaryEndianness(&binary, &endian) == SPV_SUCCESS &&
+      !spvIsHostEndian(endian)) {
+    host_endian_words_.reserve(num_words);
+    for (size_t i = 0; i < num_words; ++i) {
+      host_endian_words_.push_back(spvFixWord(words[i], endian));
+    }
+    words_ = host_endian_words_.data();
+  }
+
+  if (opt->streaming) {
+    // A streaming validation grows its storage and registers the extensions
+    // as the instructions are parsed, so only the header is read here.
+    if (num_words >= SPV_INDEX_INSTRUCTION) {
+      setVersion(words_[SPV_INDEX_VERSION_NUMBER]);
+      setGenerator(words_[SPV_INDEX_GENERATOR_NUMBER]);
+      setIdBound(words_[SPV_INDEX_BOUND]);
+    }
+  } else if (num_words > 0) {
+    // Only attempt to count if we have words, otherwise let the other
+    // validation fail and generate an error.
+    // Count the number of operands in the binary and register the extensions
+    // it declares.
     // This parse should not produce any error messages. Hijack the context and
     // replace the message consumer so that we do not pollute any state in input
     // consumer.
     spv_context_t hijacked_context = *ctx;
     hijacked_context.consumer = [](spv_message_level_t, const char*,
                                    const spv_position_t&, const char*) {};
-    spvBinaryParse(&hijacked_context, this, words, num_words, setHeader,
-                   CountInstructions,
+    PreParseState pre_parse_state = {this, true};
+    spvBinaryParse(&hijacked_context, &pre_parse_state, words_, num_words_,
+                   setHeader, CountOperandsAndRegisterExtensions,
                    /* diagnostic = */ nullptr);
     preallocateStorage();
   }
   UpdateFeaturesBasedOnSpirvVersion(&features_, version_);
-
-  friendly_mapper_ = spvtools::MakeUnique<spvtools::FriendlyNameMapper>(
-      context_, words_, num_words_);
-  name_mapper_ = friendly_mapper_->GetNameMapper();
 }
 
 void ValidationState_t::preallocateStorage() {
-  ordered_instructions_.reserve(total_instructions_);
-  module_functions_.reserve(total_functions_);
+  operand_chunks_.emplace_back();
+  operand_chunks_.back().reserve(total_operands_);
 }
 
 spv_result_t ValidationState_t::ForwardDeclareId(uint32_t id) {
@@ -242,7 +293,11 @@ void ValidationState_t::AssignNameToId(uint32_t id, std::string name) {
 }
 
 std::string ValidationState_t::getIdName(uint32_t id) const {
-  const std::string id_name = name_mapper_(id);
+  if (!friendly_mapper_) {
+    friendly_mapper_ = spvtools::MakeUnique<spvtools::FriendlyNameMapper>(
+        context_, words_, num_words_);
+  }
+  const std::string id_name = friendly_mapper_->NameForId(id);
 
   std::stringstream out;
   out << id << "[%" << id_name << "]";
@@ -310,6 +365,12 @@ DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
     ++num_of_warnings_;
   }
 
+  // The errors found after a work limit was exceeded may be caused by the
+  // work left undone.
+  if (work_limit_exceeded_ && error_code != SPV_ERROR_WORK_LIMIT) {
+    return DiagnosticStream({0, 0, 0}, nullptr, "", error_code);
+  }
+
   std::string disassembly;
   if (inst) disassembly = Disassemble(*inst);
 
@@ -317,7 +378,54 @@ DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
                           context_->consumer, disassembly, error_code);
 }
 
-std::vector<Function>& ValidationState_t::functions() {
+bool ValidationState_t::ChargeWork(spv_validator_work_limit limit,
+                                   uint64_t amount) const {
+  uint32_t max = 0;
+  switch (limit) {
+    case spv_validator_work_limit_max_cfg_edges:
+      max = options_->work_limits_.max_cfg_edges;
+      break;
+    case spv_validator_work_limit_max_dominance_queries:
+      max = options_->work_limits_.max_dominance_queries;
+      break;
+    case spv_validator_work_limit_max_type_traversal:
+      max = options_->work_limits_.max_type_traversal;
+      break;
+  }
+  work_done_[limit] += amount;
+  if (max == 0 || work_done_[limit] <= max) return true;
+  if (!work_limit_exceeded_) {
+    exceeded_work_limit_ = limit;
+    work_limit_exceeded_ = true;
+  }
+  return false;
+}
+
+spv_result_t ValidationState_t::WorkLimitError(const Instruction* inst) {
+  assert(work_limit_exceeded_);
+  const auto& limits = options_->work_limits_;
+  uint32_t max = 0;
+  const char* work = "";
+  switch (exceeded_work_limit_) {
+    case spv_validator_work_limit_max_cfg_edges:
+      max = limits.max_cfg_edges;
+      work = "CFG edges";
+      break;
+    case spv_validator_work_limit_max_dominance_queries:
+      max = limits.max_dominance_queries;
+      work = "dominance queries";
+      break;
+    case spv_validator_work_limit_max_type_traversal:
+      max = limits.max_type_traversal;
+      work = "types traversed";
+      break;
+  }
+  return diag(SPV_ERROR_WORK_LIMIT, inst)
+         << "Validation stopped after exceeding the limit of " << max << " "
+         << work << ".";
+}
+
+std::deque<Function>& ValidationState_t::functions() {
   return module_functions_;
 }
 
@@ -441,6 +549,17 @@ void ValidationState_t::RegisterExtension(Extension ext) {
   }
 }
 
+void ValidationState_t::RegisterExtension(
+    const spv_parsed_instruction_t* inst) {
+  const std::string extension_str = spvtools::GetExtensionString(inst);
+  Extension extension;
+  if (!GetExtensionFromString(extension_str.c_str(), &extension)) {
+    return;
+  }
+
+  RegisterExtension(extension);
+}
+
 bool ValidationState_t::HasAnyOfCapabilities(
     const CapabilitySet& capabilities) const {
   return module_capabilities_.HasAnyOf(capabilities);
@@ -515,11 +634,53 @@ spv_result_t ValidationState_t::RegisterFunctionEnd() {
 
 Instruction* ValidationState_t::AddOrderedInstruction(
     const spv_parsed_instruction_t* inst) {
-  ordered_instructions_.emplace_back(inst);
+  // The words of |inst| point into |words_|, but its operands only live until
+  // the next instruction is parsed, so they are moved to |operand_chunks_|.
+  // A chunk is never filled beyond its capacity, so the operands never move
+  // afterwards.  The storage is either preallocated, or grows a chunk at a
+  // time as the instructions are parsed.
+  assert(inst->words >= words_ && inst->words < words_ + num_words_);
+  if (operand_chunks_.empty() ||
+      operand_chunks_.back().capacity() - operand_chunks_.back().size() <
+          inst->num_operands) {
+    operand_chunks_.emplace_back();
+    operand_chunks_.back().reserve(
+        std::max<size_t>(kOperandChunkSize, inst->num_operands));
+  }
+  auto& operands = operand_chunks_.back();
+  spv_parsed_instruction_t stored_inst = *inst;
+  stored_inst.operands = operands.data() + operands.size();
+  operands.insert(operands.end(), inst->operands,
+                  inst->operands + inst->num_operands);
+  num_operands_ += inst->num_operands;
+  ordered_instructions_.emplace_back(&stored_inst);
   ordered_instructions_.back().SetLineNum(ordered_instructions_.size());
   return &ordered_instructions_.back();
 }
 
+void ValidationState_t::AllocateIdUses() {
+  size_t num_uses = 0;
+  for (const auto& inst : ordered_instructions_) num_uses += inst.num_uses();
+  id_uses_.resize(num_uses);
+
+  Instruction::Use* next = id_uses_.data();
+  for (auto& inst : ordered_instructions_) {
+    const uint32_t num_inst_uses = inst.num_uses();
+    inst.SetUseStorage(next);
+    next += num_inst_uses;
+  }
+}
+
+size_t ValidationState_t::instruction_storage_bytes() const {
+  size_t result = ordered_instructions_.size() * sizeof(Instruction);
+  for (const auto& chunk : operand_chunks_) {
+    result += chunk.capacity() * sizeof(spv_parsed_operand_t);
+  }
+  result += id_uses_.capacity() * sizeof(Instruction::Use);
+  result += host_endian_words_.capacity() * sizeof(uint32_t);
+  return result;
+}
+
 // Improves diagnostic messages by collecting names of IDs
 void ValidationState_t::RegisterDebugInstruction(const Instruction* inst) {
   switch (inst->opcode()) {
@@ -605,162 +766,89 @@ void ValidationState_t::RegisterStorageClassConsumer(
     SpvStorageClass storage_class, Instruction* consumer) {
   if (spvIsVulkanEnv(context()->target_env)) {
     if (storage_class == SpvStorageClassOutput) {
-      std::string errorVUID = VkErrorID(4644);
       function(consumer->function()->id())
-          ->RegisterExecutionModelLimitation([errorVUID](
-                                                 SpvExecutionModel model,
-                                                 std::string* message) {
-            if (model == SpvExecutionModelGLCompute ||
-                model == SpvExecutionModelRayGenerationKHR ||
-                model == SpvExecutionModelIntersectionKHR ||
-                model == SpvExecutionModelAnyHitKHR ||
-                model == SpvExecutionModelClosestHitKHR ||
-                model == SpvExecutionModelMissKHR ||
-                model == SpvExecutionModelCallableKHR) {
-              if (message) {
-                *message =
-                    errorVUID +
-                    "in Vulkan environment, Output Storage Class must not be "
-                    "used in GLCompute, RayGenerationKHR, IntersectionKHR, "
-                    "AnyHitKHR, ClosestHitKHR, MissKHR, or CallableKHR "
-                    "execution models";
-              }
-              return false;
-            }
-            return true;
-          });
+          ->RegisterExecutionModelLimitation(
+              ~ExecutionModelMask({SpvExecutionModelGLCompute,
+                                   SpvExecutionModelRayGenerationKHR,
+                                   SpvExecutionModelIntersectionKHR,
+                                   SpvExecutionModelAnyHitKHR,
+                                   SpvExecutionModelClosestHitKHR,
+                                   SpvExecutionModelMissKHR,
+                                   SpvExecutionModelCallableKHR}),
+              VkErrorID(4644),
+              "in Vulkan environment, Output Storage Class must not be used in "
+              "GLCompute, RayGenerationKHR, IntersectionKHR, AnyHitKHR, "
+              "ClosestHitKHR, MissKHR, or CallableKHR execution models");
     }
 
     if (storage_class == SpvStorageClassWorkgroup) {
-      std::string errorVUID = VkErrorID(4645);
       function(consumer->function()->id())
-          ->RegisterExecutionModelLimitation([errorVUID](
-                                                 SpvExecutionModel model,
-                                                 std::string* message) {
-            if (model != SpvExecutionModelGLCompute &&
-                model != SpvExecutionModelTaskNV &&
-                model != SpvExecutionModelMeshNV) {
-              if (message) {
-                *message =
-                    errorVUID +
-                    "in Vulkan environment, Workgroup Storage Class is limited "
-                    "to MeshNV, TaskNV, and GLCompute execution model";
-              }
-              return false;
-            }
-            return true;
-          });
+          ->RegisterExecutionModelLimitation(
+              ExecutionModelMask({SpvExecutionModelGLCompute,
+                                  SpvExecutionModelTaskNV,
+                                  SpvExecutionModelMeshNV}),
+              VkErrorID(4645),
+              "in Vulkan environment, Workgroup Storage Class is limited to "
+              "MeshNV, TaskNV, and GLCompute execution model");
     }
   }
 
   if (storage_class == SpvStorageClassCallableDataKHR) {
-    std::string errorVUID = VkErrorID(4704);
     function(consumer->function()->id())
-        ->RegisterExecutionModelLimitation([errorVUID](SpvExecutionModel model,
-                                                       std::string* message) {
-          if (model != SpvExecutionModelRayGenerationKHR &&
-              model != SpvExecutionModelClosestHitKHR &&
-              model != SpvExecutionModelCallableKHR &&
-              model != SpvExecutionModelMissKHR) {
-            if (message) {
-              *message = errorVUID +
-                         "CallableDataKHR Storage Class is limited to "
-                         "RayGenerationKHR, ClosestHitKHR, CallableKHR, and "
-                         "MissKHR execution model";
-            }
-            return false;
-          }
-          return true;
-        });
+        ->RegisterExecutionModelLimitation(
+            ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                SpvExecutionModelClosestHitKHR,
+                                SpvExecutionModelCallableKHR,
+                                SpvExecutionModelMissKHR}),
+            VkErrorID(4704),
+            "CallableDataKHR Storage Class is limited to RayGenerationKHR, "
+            "ClosestHitKHR, CallableKHR, and MissKHR execution model");
   } else if (storage_class == SpvStorageClassIncomingCallableDataKHR) {
-    std::string errorVUID = VkErrorID(4705);
     function(consumer->function()->id())
-        ->RegisterExecutionModelLimitation([errorVUID](SpvExecutionModel model,
-                                                       std::string* message) {
-          if (model != SpvExecutionModelCallableKHR) {
-            if (message) {
-              *message = errorVUID +
-                         "IncomingCallableDataKHR Storage Class is limited to "
-                         "CallableKHR execution model";
-            }
-            return false;
-          }
-          return true;
-        });
+        ->RegisterExecutionModelLimitation(
+            ExecutionModelMask(SpvExecutionModelCallableKHR), VkErrorID(4705),
+            "IncomingCallableDataKHR Storage Class is limited to CallableKHR "
+            "execution model");
   } else if (storage_class == SpvStorageClassRayPayloadKHR) {
-    std::string errorVUID = VkErrorID(4698);
     function(consumer->function()->id())
-        ->RegisterExecutionModelLimitation([errorVUID](SpvExecutionModel model,
-                                                       std::string* message) {
-          if (model != SpvExecutionModelRayGenerationKHR &&
-              model != SpvExecutionModelClosestHitKHR &&
-              model != SpvExecutionModelMissKHR) {
-            if (message) {
-              *message =
-                  errorVUID +
-                  "RayPayloadKHR Storage Class is limited to RayGenerationKHR, "
-                  "ClosestHitKHR, and MissKHR execution model";
-            }
-            return false;
-          }
-          return true;
-        });
+        ->RegisterExecutionModelLimitation(
+            ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                SpvExecutionModelClosestHitKHR,
+                                SpvExecutionModelMissKHR}),
+            VkErrorID(4698),
+            "RayPayloadKHR Storage Class is limited to RayGenerationKHR, "
+            "ClosestHitKHR, and MissKHR execution model");
   } else if (storage_class == SpvStorageClassHitAttributeKHR) {
-    std::string errorVUID = VkErrorID(4701);
     function(consumer->function()->id())
         ->RegisterExecutionModelLimitation(
-            [errorVUID](SpvExecutionModel model, std::string* message) {
-              if (model != SpvExecutionModelIntersectionKHR &&
-                  model != SpvExecutionModelAnyHitKHR &&
-                  model != SpvExecutionModelClosestHitKHR) {
-                if (message) {
-                  *message = errorVUID +
-                             "HitAttributeKHR Storage Class is limited to "
-                             "IntersectionKHR, AnyHitKHR, sand ClosestHitKHR "
-                             "execution model";
-                }
-                return false;
-              }
-              return true;
-            });
+            ExecutionModelMask({SpvExecutionModelIntersectionKHR,
+                                SpvExecutionModelAnyHitKHR,
+                                SpvExecutionModelClosestHitKHR}),
+            VkErrorID(4701),
+            "HitAttributeKHR Storage Class is limited to IntersectionKHR, "
+            "AnyHitKHR, sand ClosestHitKHR execution model");
   } else if (storage_class == SpvStorageClassIncomingRayPayloadKHR) {
-    std::string errorVUID = VkErrorID(4699);
     function(consumer->function()->id())
         ->RegisterExecutionModelLimitation(
-            [errorVUID](SpvExecutionModel model, std::string* message) {
-              if (model != SpvExecutionModelAnyHitKHR &&
-                  model != SpvExecutionModelClosestHitKHR &&
-                  model != SpvExecutionModelMissKHR) {
-                if (message) {
-                  *message =
-                      errorVUID +
-                      "IncomingRayPayloadKHR Storage Class is limited to "
-                      "AnyHitKHR, ClosestHitKHR, and MissKHR execution model";
-                }
-                return false;
-              }
-              return true;
-            });
+            ExecutionModelMask({SpvExecutionModelAnyHitKHR,
+                                SpvExecutionModelClosestHitKHR,
+                                SpvExecutionModelMissKHR}),
+            VkErrorID(4699),
+            "IncomingRayPayloadKHR Storage Class is limited to AnyHitKHR, "
+            "ClosestHitKHR, and MissKHR execution model");
   } else if (storage_class == SpvStorageClassShaderRecordBufferKHR) {
     function(consumer->function()->id())
         ->RegisterExecutionModelLimitation(
-            [](SpvExecutionModel model, std::string* message) {
-              if (model != SpvExecutionModelRayGenerationKHR &&
-                  model != SpvExecutionModelIntersectionKHR &&
-                  model != SpvExecutionModelAnyHitKHR &&
-                  model != SpvExecutionModelClosestHitKHR &&
-                  model != SpvExecutionModelCallableKHR &&
-                  model != SpvExecutionModelMissKHR) {
-                if (message) {
-                  *message =
-                      "ShaderRecordBufferKHR Storage Class is limited to "
-                      "RayGenerationKHR, IntersectionKHR, AnyHitKHR, "
-                      "ClosestHitKHR, CallableKHR, and MissKHR execution model";
-                }
-                return false;
-              }
-              return true;
-            });
+            ExecutionModelMask({SpvExecutionModelRayGenerationKHR,
+                                SpvExecutionModelIntersectionKHR,
+                                SpvExecutionModelAnyHitKHR,
+                                SpvExecutionModelClosestHitKHR,
+                                SpvExecutionModelCallableKHR,
+                                SpvExecutionModelMissKHR}),
+            "",
+            "ShaderRecordBufferKHR Storage Class is limited to "
+            "RayGenerationKHR, IntersectionKHR, AnyHitKHR, ClosestHitKHR, "
+            "CallableKHR, and MissKHR execution model");
   }
 }
 
@@ -769,22 +857,45 @@ uint32_t ValidationState_t::getIdBound() const { return id_bound_; }
 void ValidationState_t::setIdBound(const uint32_t bound) { id_bound_ = bound; }
 
 bool ValidationState_t::RegisterUniqueTypeDeclaration(const Instruction* inst) {
-  std::vector<uint32_t> key;
-  key.push_back(static_cast<uint32_t>(inst->opcode()));
-  for (size_t index = 0; index < inst->operands().size(); ++index) {
-    const spv_parsed_operand_t& operand = inst->operand(index);
-
-    if (operand.type == SPV_OPERAND_TYPE_RESULT_ID) continue;
+  return unique_type_declarations_.insert(inst).second;
+}
 
-    const int words_begin = operand.offset;
-    const int words_end = words_begin + operand.num_words;
-    assert(words_end <= static_cast<int>(inst->words().size()));
+namespace {
 
-    key.insert(key.end(), inst->words().begin() + words_begin,
-               inst->words().begin() + words_end);
+// Returns the index of the word holding the result id of |inst|, or the number
+// of words of |inst| if it has none.
+size_t ResultIdWordIndex(const Instruction* inst) {
+  for (const auto& operand : inst->operands()) {
+    if (operand.type == SPV_OPERAND_TYPE_RESULT_ID) return operand.offset;
   }
+  return inst->words().size();
+}
+
+}  // namespace
 
-  return unique_type_declarations_.insert(std::move(key)).second;
+size_t ValidationState_t::TypeDeclarationHash::operator()(
+    const Instruction* inst) const {
+  const auto words = inst->words();
+  const size_t result_id_index = ResultIdWordIndex(inst);
+  size_t hash = 0;
+  for (size_t i = 0; i < words.size(); ++i) {
+    if (i != result_id_index) hash = utils::hash_combine(hash, words[i]);
+  }
+  return hash;
+}
+
+bool ValidationState_t::TypeDeclarationEqual::operator()(
+    const Instruction* lhs, const Instruction* rhs) const {
+  // The first word holds the opcode and the word count, so the result ids of
+  // declarations with the same first word are at the same index.
+  const auto lhs_words = lhs->words();
+  const auto rhs_words = rhs->words();
+  if (lhs_words[0] != rhs_words[0]) return false;
+  const size_t result_id_index = ResultIdWordIndex(lhs);
+  for (size_t i = 1; i < lhs_words.size(); ++i) {
+    if (i != result_id_index && lhs_words[i] != rhs_words[i]) return false;
+  }
+  return true;
 }
 
 uint32_t ValidationState_t::GetTypeId(uint32_t id) const {
@@ -1430,6 +1541,9 @@ bool ValidationState_t::ContainsType(
     bool traverse_all_types) const {
   const auto inst = FindDef(id);
   if (!inst) return false;
+  if (!ChargeWork(spv_validator_work_limit_max_type_traversal, 1)) {
+    return false;
+  }
 
   if (f(inst)) return true;
 
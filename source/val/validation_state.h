@@ -16,6 +16,8 @@
 #define SOURCE_VAL_VALIDATION_STATE_H_
 
 #include <algorithm>
+#include <cassert>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
@@ -116,6 +118,13 @@ class ValidationState_t {
   /// Returns the context
   spv_const_context context() const { return context_; }
 
+  /// Returns the words of the module, in host endianness.  The instructions
+  /// of the module refer to them.
+  const uint32_t* words() const { return words_; }
+
+  /// Returns the number of words of the module.
+  size_t num_words() const { return num_words_; }
+
   /// Returns the command line options
   spv_const_validator_options options() const { return options_; }
 
@@ -167,15 +176,12 @@ class ValidationState_t {
   /// Returns true if the id has been defined
   bool IsDefinedId(uint32_t id) const;
 
-  /// Increments the total number of instructions in the file.
-  void increment_total_instructions() { total_instructions_++; }
+  /// Adds |count| to the total number of operands in the file.
+  void increment_total_operands(size_t count) { total_operands_ += count; }
 
-  /// Increments the total number of functions in the file.
-  void increment_total_functions() { total_functions_++; }
-
-  /// Allocates internal storage. Note, calling this will invalidate any
-  /// pointers to |ordered_instructions_| or |module_functions_| and, hence,
-  /// should only be called at the beginning of validation.
+  /// Allocates the storage of the operands of all instructions at once, using
+  /// the counts of the pre-parse.  Should only be called at the beginning of
+  /// validation.
   void preallocateStorage();
 
   /// Returns the current layout section which is being processed
@@ -193,7 +199,7 @@ class ValidationState_t {
   DiagnosticStream diag(spv_result_t error_code, const Instruction* inst);
 
   /// Returns the function states
-  std::vector<Function>& functions();
+  std::deque<Function>& functions();
 
   /// Returns the function states
   Function& current_function();
@@ -305,6 +311,11 @@ class ValidationState_t {
   /// Registers the extension.
   void RegisterExtension(Extension ext);
 
+  /// Registers the extension declared by the OpExtension instruction |inst|,
+  /// if it is recognized.  Unrecognized extensions are reported when the
+  /// instruction is validated.
+  void RegisterExtension(const spv_parsed_instruction_t* inst);
+
   /// Registers the function in the module. Subsequent instructions will be
   /// called against this function
   spv_result_t RegisterFunction(uint32_t id, uint32_t ret_type_id,
@@ -338,6 +349,44 @@ class ValidationState_t {
   /// is an empty set.
   bool HasAnyOfExtensions(const ExtensionSet& extensions) const;
 
+  /// Returns true once all capabilities declared by the module are registered,
+  /// that is once past the capability section.  From then on, whether the
+  /// module satisfies the requirements of an opcode or operand value no longer
+  /// changes.
+  bool capabilities_complete() const {
+    return current_layout_section_ > kLayoutCapabilities;
+  }
+
+  /// Returns true if the capability, extension and version requirements
+  /// identified by |kind| and |value| are known to be satisfied by the
+  /// module.  |kind| is an operand type, or a kind of opcode requirements
+  /// above the operand types.
+  bool AreRequirementsSatisfied(uint32_t kind, uint32_t value) const {
+    return satisfied_requirements_.count(uint64_t(kind) << 32 | value) != 0;
+  }
+
+  /// Records that the requirements identified by |kind| and |value| are
+  /// satisfied by the module.  May only be called once the capabilities are
+  /// complete.
+  void SetRequirementsSatisfied(uint32_t kind, uint32_t value) {
+    assert(capabilities_complete());
+    satisfied_requirements_.insert(uint64_t(kind) << 32 | value);
+  }
+
+  /// Charges |amount| units of the work bounded by |limit| in the validator
+  /// options.  Returns false, and records that the limit was exceeded, once
+  /// the work charged exceeds the limit.  The checks stop at the first limit
+  /// exceeded, and further diagnostics are suppressed since they may be
+  /// caused by the work left undone.  Const so that the type queries can
+  /// charge their traversals.
+  bool ChargeWork(spv_validator_work_limit limit, uint64_t amount) const;
+
+  /// Returns true if the work charged exceeded one of the work limits.
+  bool work_limit_exceeded() const { return work_limit_exceeded_; }
+
+  /// Reports the work limit which was exceeded while checking |inst|.
+  spv_result_t WorkLimitError(const Instruction* inst);
+
   /// Sets the addressing model of this module (logical/physical).
   void set_addressing_model(SpvAddressingModel am);
 
@@ -378,8 +427,24 @@ class ValidationState_t {
   const AssemblyGrammar& grammar() const { return grammar_; }
 
   /// Inserts the instruction into the list of ordered instructions in the file.
+  /// The words of |inst| must be part of words().
   Instruction* AddOrderedInstruction(const spv_parsed_instruction_t* inst);
 
+  /// Allocates the storage of the uses of all ids.  Must be called after the
+  /// uses of every instruction were counted, and before they are registered.
+  void AllocateIdUses();
+
+  /// Returns the number of operands of all instructions.
+  size_t num_operands() const { return num_operands_; }
+
+  /// Returns the number of uses of all ids.
+  size_t num_id_uses() const { return id_uses_.size(); }
+
+  /// Returns the number of bytes allocated to hold the instructions, their
+  /// operands, the uses of all ids and, if one was made, the host endian copy
+  /// of the binary.
+  size_t instruction_storage_bytes() const;
+
   /// Registers the instruction. This will add the instruction to the list of
   /// definitions and register sampled image consumers.
   void RegisterInstruction(Instruction* inst);
@@ -467,7 +532,7 @@ class ValidationState_t {
   Instruction* FindDef(uint32_t id);
 
   /// Returns the instructions in the order they appear in the binary
-  const std::vector<Instruction>& ordered_instructions() const {
+  const std::deque<Instruction>& ordered_instructions() const {
     return ordered_instructions_;
   }
 
@@ -790,20 +855,24 @@ class ValidationState_t {
   /// Stores the Validator command line options. Must be a valid options object.
   const spv_const_validator_options options_;
 
-  /// The SPIR-V binary module we're validating.
+  /// The SPIR-V binary module we're validating, in host endianness.  Either
+  /// the binary given on construction, which must outlive the validation
+  /// state, or |host_endian_words_|.
   const uint32_t* words_;
   const size_t num_words_;
 
+  /// A host endian copy of the binary, if it was given in the other
+  /// endianness.
+  std::vector<uint32_t> host_endian_words_;
+
   /// The generator of the SPIR-V.
   uint32_t generator_ = 0;
 
   /// The version of the SPIR-V.
   uint32_t version_ = 0;
 
-  /// The total number of instructions in the binary.
-  size_t total_instructions_ = 0;
-  /// The total number of functions in the binary.
-  size_t total_functions_ = 0;
+  /// The total number of operands of the instructions in the binary.
+  size_t total_operands_ = 0;
 
   /// IDs which have been forward declared but have not been defined
   std::unordered_set<uint32_t> unresolved_forward_ids_;
@@ -825,7 +894,7 @@ class ValidationState_t {
   /// A list of functions in the module.
   /// Pointers to objects in this container are guaranteed to be stable and
   /// valid until the end of lifetime of the validation state.
-  std::vector<Function> module_functions_;
+  std::deque<Function> module_functions_;
 
   /// Capabilities declared in the module
   CapabilitySet module_capabilities_;
@@ -833,8 +902,36 @@ class ValidationState_t {
   /// Extensions declared in the module
   ExtensionSet module_extensions_;
 
-  /// List of all instructions in the order they appear in the binary
-  std::vector<Instruction> ordered_instructions_;
+  /// The requirements of opcodes and operand values that the module is known
+  /// to satisfy, keyed by their kind in the high word and their value in the
+  /// low word.  Saves looking up and checking the requirements of each use.
+  std::unordered_set<uint64_t> satisfied_requirements_;
+
+  /// The work charged so far, indexed by spv_validator_work_limit.
+  mutable uint64_t work_done_[spv_validator_work_limit_max_type_traversal + 1];
+
+  /// The first work limit exceeded, if |work_limit_exceeded_| is true.
+  mutable spv_validator_work_limit exceeded_work_limit_;
+  mutable bool work_limit_exceeded_;
+
+  /// List of all instructions in the order they appear in the binary.
+  /// Instructions are appended as they are parsed, and pointers to them stay
+  /// valid until the end of lifetime of the validation state.
+  std::deque<Instruction> ordered_instructions_;
+
+  /// The operands of all instructions, in the order they appear in the
+  /// binary.  Each instruction refers to its range of operands, which lies
+  /// in a single chunk.  A chunk never grows beyond the capacity it was
+  /// created with, so the operands never move.
+  std::vector<std::vector<spv_parsed_operand_t>> operand_chunks_;
+
+  /// The number of operands in |operand_chunks_|.
+  size_t num_operands_ = 0;
+
+  /// The uses of all ids, grouped by the instruction defining the id, in the
+  /// order of |ordered_instructions_|.  Each instruction refers to the range
+  /// of its uses.
+  std::vector<Instruction::Use> id_uses_;
 
   /// Instructions that can be referenced by Ids
   std::unordered_map<uint32_t, Instruction*> all_definitions_;
@@ -875,11 +972,21 @@ class ValidationState_t {
   /// Stores the list of decorations for a given <id>
   std::map<uint32_t, std::set<Decoration>> id_decorations_;
 
-  /// Stores type declarations which need to be unique (i.e. non-aggregates),
-  /// in the form [opcode, operand words], result_id is not stored.
-  /// Using ordered set to avoid the need for a vector hash function.
-  /// The size of this container is expected not to exceed double-digits.
-  std::set<std::vector<uint32_t>> unique_type_declarations_;
+  /// Hashes a type declaration by its words, except for its result id.
+  struct TypeDeclarationHash {
+    size_t operator()(const Instruction* inst) const;
+  };
+
+  /// Compares type declarations by their words, except for their result ids.
+  struct TypeDeclarationEqual {
+    bool operator()(const Instruction* lhs, const Instruction* rhs) const;
+  };
+
+  /// Stores type declarations which need to be unique (i.e. non-aggregates).
+  /// The declarations are compared in place, without copying their words.
+  std::unordered_set<const Instruction*, TypeDeclarationHash,
+                     TypeDeclarationEqual>
+      unique_type_declarations_;
 
   AssemblyGrammar grammar_;
 
@@ -934,9 +1041,9 @@ class ValidationState_t {
   // TypePass.
   std::unordered_set<uint32_t> pointer_to_storage_image_;
 
-  /// Maps ids to friendly names.
-  std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper_;
-  spvtools::NameMapper name_mapper_;
+  /// Maps ids to friendly names.  Only built when a name is first needed,
+  /// since building it parses the whole module.
+  mutable std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper_;
 
   /// Variables used to reduce the number of diagnostic messages.
   uint32_t num_of_warnings_;
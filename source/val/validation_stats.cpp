@@ -0,0 +1,185 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/val/validation_stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace spvtools {
+namespace val {
+namespace {
+
+double ToMilliseconds(ValidationStats::Clock::duration time) {
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+}  // namespace
+
+ValidationStats::ScopedTimer::ScopedTimer(ValidationStats* stats,
+                                          Family family,
+                                          uint64_t num_instructions)
+    : stats_(stats), family_(family), parent_(nullptr) {
+  if (!stats_) return;
+  const auto now = Clock::now();
+  parent_ = stats_->active_timer_;
+  if (parent_) parent_->Charge(now);
+  stats_->active_timer_ = this;
+  stats_->AddInstructions(family_, num_instructions);
+  start_ = now;
+}
+
+ValidationStats::ScopedTimer::~ScopedTimer() {
+  if (!stats_) return;
+  const auto now = Clock::now();
+  Charge(now);
+  stats_->active_timer_ = parent_;
+  if (parent_) parent_->start_ = now;
+}
+
+void ValidationStats::ScopedTimer::Charge(Clock::time_point now) {
+  stats_->families_[family_].time += now - start_;
+  start_ = now;
+}
+
+ValidationStats::ValidationStats()
+    : total_time_(Clock::duration::zero()), active_timer_(nullptr) {}
+
+const char* ValidationStats::FamilyName(Family family) {
+  switch (family) {
+    case kParse:
+      return "Parse";
+    case kId:
+      return "Id";
+    case kCapability:
+      return "Capability";
+    case kModuleLayout:
+      return "ModuleLayout";
+    case kCfg:
+      return "Cfg";
+    case kInstruction:
+      return "Instruction";
+    case kForwardDecls:
+      return "ForwardDecls";
+    case kReachability:
+      return "Reachability";
+    case kIdUse:
+      return "IdUse";
+    case kMisc:
+      return "Misc";
+    case kDebug:
+      return "Debug";
+    case kAnnotation:
+      return "Annotation";
+    case kExtension:
+      return "Extension";
+    case kModeSetting:
+      return "ModeSetting";
+    case kType:
+      return "Type";
+    case kConstant:
+      return "Constant";
+    case kMemory:
+      return "Memory";
+    case kFunction:
+      return "Function";
+    case kImage:
+      return "Image";
+    case kConversion:
+      return "Conversion";
+    case kComposites:
+      return "Composites";
+    case kArithmetics:
+      return "Arithmetics";
+    case kBitwise:
+      return "Bitwise";
+    case kLogicals:
+      return "Logicals";
+    case kControlFlow:
+      return "ControlFlow";
+    case kDerivatives:
+      return "Derivatives";
+    case kAtomics:
+      return "Atomics";
+    case kPrimitives:
+      return "Primitives";
+    case kBarriers:
+      return "Barriers";
+    case kNonUniform:
+      return "NonUniform";
+    case kLiterals:
+      return "Literals";
+    case kRayQuery:
+      return "RayQuery";
+    case kRayTracing:
+      return "RayTracing";
+    case kAdjacency:
+      return "Adjacency";
+    case kEntryPoints:
+      return "EntryPoints";
+    case kCfgChecks:
+      return "CfgChecks";
+    case kIdDominance:
+      return "IdDominance";
+    case kDecorations:
+      return "Decorations";
+    case kInterfaces:
+      return "Interfaces";
+    case kBuiltIns:
+      return "BuiltIns";
+    case kExecutionLimitations:
+      return "ExecutionLimitations";
+    case kSmallTypeUses:
+      return "SmallTypeUses";
+    case kNumFamilies:
+      break;
+  }
+  return "";
+}
+
+std::string ValidationStats::Report() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "Validation statistics:\n";
+  out << std::left << std::setw(24) << "  Check family" << std::right
+      << std::setw(12) << "Time (ms)" << std::setw(16) << "Instructions"
+      << "\n";
+  for (int family = 0; family < kNumFamilies; ++family) {
+    const auto& stats = families_[family];
+    if (stats.time == Clock::duration::zero() && stats.num_instructions == 0) {
+      continue;
+    }
+    out << "  " << std::left << std::setw(22)
+        << FamilyName(static_cast<Family>(family)) << std::right
+        << std::setw(12) << ToMilliseconds(stats.time) << std::setw(16);
+    if (stats.num_instructions) {
+      out << stats.num_instructions;
+    } else {
+      out << "-";
+    }
+    out << "\n";
+  }
+  out << "  " << std::left << std::setw(22) << "Total" << std::right
+      << std::setw(12) << ToMilliseconds(total_time_) << "\n";
+
+  out << "Sizes:\n";
+  for (const auto& size : sizes_) {
+    out << "  " << std::left << std::setw(22) << size.first << std::right
+        << std::setw(12) << size.second << "\n";
+  }
+  return out.str();
+}
+
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,144 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_VAL_VALIDATION_STATS_H_
+#define SOURCE_VAL_VALIDATION_STATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace val {
+
+/// Records the time spent and the number of instructions inspected by each
+/// family of checks of the validator, along with the sizes of the data
+/// structures it builds.  Only collected when requested by the validator
+/// options.
+class ValidationStats {
+ public:
+  /// The families of checks, in the order in which the validator runs them.
+  enum Family {
+    kParse,
+    kId,
+    kCapability,
+    kModuleLayout,
+    kCfg,
+    kInstruction,
+    kForwardDecls,
+    kReachability,
+    kIdUse,
+    kMisc,
+    kDebug,
+    kAnnotation,
+    kExtension,
+    kModeSetting,
+    kType,
+    kConstant,
+    kMemory,
+    kFunction,
+    kImage,
+    kConversion,
+    kComposites,
+    kArithmetics,
+    kBitwise,
+    kLogicals,
+    kControlFlow,
+    kDerivatives,
+    kAtomics,
+    kPrimitives,
+    kBarriers,
+    kNonUniform,
+    kLiterals,
+    kRayQuery,
+    kRayTracing,
+    kAdjacency,
+    kEntryPoints,
+    kCfgChecks,
+    kIdDominance,
+    kDecorations,
+    kInterfaces,
+    kBuiltIns,
+    kExecutionLimitations,
+    kSmallTypeUses,
+    kNumFamilies
+  };
+
+  using Clock = std::chrono::steady_clock;
+
+  /// Charges the time spent in its scope to a family of checks.  Time spent
+  /// in a nested timer is only charged to the family of the nested timer.
+  /// Does nothing if |stats| is null, so that checks can be timed
+  /// unconditionally.
+  class ScopedTimer {
+   public:
+    /// Starts timing |family|, which inspects |num_instructions| more
+    /// instructions.
+    ScopedTimer(ValidationStats* stats, Family family,
+                uint64_t num_instructions = 0);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    // Charges the time since |start_| to |family_|, and restarts the timer.
+    void Charge(Clock::time_point now);
+
+    ValidationStats* stats_;
+    Family family_;
+    ScopedTimer* parent_;
+    Clock::time_point start_;
+  };
+
+  ValidationStats();
+
+  /// Adds |num_instructions| to the instructions inspected by |family|.
+  void AddInstructions(Family family, uint64_t num_instructions) {
+    families_[family].num_instructions += num_instructions;
+  }
+
+  /// Records the size of the data structure described by |name|.
+  void SetSize(const char* name, uint64_t size) {
+    sizes_.emplace_back(name, size);
+  }
+
+  /// Records the total time spent validating the module.
+  void SetTotalTime(Clock::duration time) { total_time_ = time; }
+
+  /// Returns a human-readable table of the statistics.
+  std::string Report() const;
+
+  /// Returns the name of |family|.
+  static const char* FamilyName(Family family);
+
+ private:
+  struct FamilyStats {
+    Clock::duration time = Clock::duration::zero();
+    uint64_t num_instructions = 0;
+  };
+
+  FamilyStats families_[kNumFamilies];
+  std::vector<std::pair<const char*, uint64_t>> sizes_;
+  Clock::duration total_time_;
+  // The innermost running timer, if any.
+  ScopedTimer* active_timer_;
+};
+
+}  // namespace val
+}  // namespace spvtools
+
+#endif  // SOURCE_VAL_VALIDATION_STATS_H_
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -222,6 +223,93 @@ TEST(CppInterface, ValidateWithOptionsFail) {
           "Number of OpTypeStruct members (10) has exceeded the limit (9)"));
 }
 
+TEST(CppInterface, ValidateWithStats) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  std::vector<std::string> info_messages;
+  t.SetMessageConsumer(
+      [&info_messages](spv_message_level_t level, const char*,
+                       const spv_position_t&, const char* message) {
+        if (level == SPV_MSG_INFO) info_messages.push_back(message);
+      });
+
+  ValidatorOptions opts;
+  EXPECT_TRUE(t.Validate(binary.data(), binary.size(), opts));
+  EXPECT_TRUE(info_messages.empty());
+
+  opts.SetCollectStats(true);
+  EXPECT_TRUE(t.Validate(binary.data(), binary.size(), opts));
+  ASSERT_EQ(1u, info_messages.size());
+  EXPECT_THAT(info_messages[0], HasSubstr("Validation statistics"));
+  EXPECT_THAT(info_messages[0], HasSubstr("Type"));
+  EXPECT_THAT(info_messages[0], HasSubstr("Decorations"));
+  EXPECT_THAT(info_messages[0], HasSubstr("Id bound"));
+}
+
+TEST(CppInterface, ValidateWithStatsFail) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  ValidatorOptions opts;
+  opts.SetUniversalLimit(spv_validator_limit_max_struct_members, 9);
+  opts.SetCollectStats(true);
+  std::vector<spv_message_level_t> levels;
+  t.SetMessageConsumer([&levels](spv_message_level_t level, const char*,
+                                 const spv_position_t&,
+                                 const char*) { levels.push_back(level); });
+
+  // The statistics of the checks that ran are reported after the error.
+  EXPECT_FALSE(t.Validate(binary.data(), binary.size(), opts));
+  EXPECT_THAT(levels, ContainerEq(std::vector<spv_message_level_t>{
+                          SPV_MSG_ERROR, SPV_MSG_INFO}));
+}
+
+// Checks that the time of the checks run while streaming is not charged to
+// the parse too, so that the families add up to at most the total time.
+TEST(CppInterface, ValidateWithStatsWhileStreaming) {
+  SpirvTools t(SPV_ENV_UNIVERSAL_1_1);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(t.Assemble(MakeModuleHavingStruct(10), &binary));
+  std::string report;
+  t.SetMessageConsumer([&report](spv_message_level_t level, const char*,
+                                 const spv_position_t&, const char* message) {
+    if (level == SPV_MSG_INFO) report = message;
+  });
+
+  ValidatorOptions opts;
+  opts.SetStreaming(true);
+  opts.SetCollectStats(true);
+  EXPECT_TRUE(t.Validate(binary.data(), binary.size(), opts));
+  EXPECT_THAT(report, HasSubstr("Parse"));
+  EXPECT_THAT(report, HasSubstr("Id"));
+
+  // Skip the title and the column names, then read the time of each family
+  // up to the total.
+  std::istringstream lines(report);
+  std::string line;
+  std::getline(lines, line);
+  std::getline(lines, line);
+  double families_ms = 0;
+  double total_ms = -1;
+  size_t num_families = 0;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    double ms = 0;
+    ASSERT_TRUE(fields >> name >> ms) << line;
+    if (name == "Total") {
+      total_ms = ms;
+      break;
+    }
+    families_ms += ms;
+    ++num_families;
+  }
+  ASSERT_GE(total_ms, 0);
+  // Each time is rounded to a microsecond.
+  EXPECT_LE(families_ms, total_ms + 0.001 * static_cast<double>(num_families));
+}
+
 // Checks that after running the given optimizer |opt| on the given |original|
 // source code, we can get the given |optimized| source code.
 void CheckOptimization(const std::string& original,
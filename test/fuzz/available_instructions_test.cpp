@@ -16,6 +16,8 @@
 
 #include "gtest/gtest.h"
 #include "source/fuzz/fuzzer_util.h"
+#include "source/fuzz/instruction_descriptor.h"
+#include "source/fuzz/transformation_add_synonym.h"
 #include "test/fuzz/fuzz_test_util.h"
 
 namespace spvtools {
@@ -323,6 +325,65 @@ TEST(AvailableInstructionsTest, UnreachableBlock) {
 #endif
 }
 
+TEST(AvailableInstructionsTest, IndexSurvivesInsertions) {
+  std::string shader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource ESSL 320
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %9 = OpConstant %6 2
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+          %8 = OpVariable %7 Function
+               OpStore %8 %9
+         %12 = OpLoad %6 %8
+         %13 = OpIAdd %6 %12 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  const auto consumer = nullptr;
+  const auto context = BuildModule(env, consumer, shader, kFuzzAssembleOption);
+  spvtools::ValidatorOptions validator_options;
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
+                                               kConsoleMessageConsumer));
+  TransformationContext transformation_context(
+      MakeUnique<FactManager>(context.get()), validator_options);
+
+  AvailableInstructions integer_instructions(
+      context.get(), [](opt::IRContext*, opt::Instruction* inst) -> bool {
+        return inst->type_id() == 6;
+      });
+  auto* inst_13 = context->get_def_use_mgr()->GetDef(13);
+
+  // Fuzzer passes build an index once and then apply transformations that
+  // insert instructions into the module.  The index should still describe
+  // the instructions that were present when it was built.
+  ApplyAndCheckFreshIds(
+      TransformationAddSynonym(
+          12, protobufs::TransformationAddSynonym::COPY_OBJECT, 100,
+          MakeInstructionDescriptor(13, SpvOpIAdd, 0)),
+      context.get(), &transformation_context);
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
+                                               kConsoleMessageConsumer));
+
+  auto available_before_13 =
+      integer_instructions.GetAvailableBeforeInstruction(inst_13);
+  ASSERT_EQ(2, available_before_13.size());
+  std::vector<uint32_t> available_ids;
+  for (uint32_t i = 0; i < available_before_13.size(); i++) {
+    available_ids.push_back(available_before_13[i]->result_id());
+  }
+  ASSERT_EQ(std::vector<uint32_t>({9, 12}), available_ids);
+}
+
 }  // namespace
 }  // namespace fuzz
 }  // namespace spvtools
@@ -0,0 +1,678 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of spirv-fuzz on a corpus of reference shaders.
+//
+// Every fuzzer pass is run in isolation on a fresh copy of each shader, after
+// which the module is validated.  The transformations that the pass applied
+// are then replayed on another fresh copy of the shader, so that the time
+// spent in Transformation::IsApplicable and Transformation::Apply can be told
+// apart from the time the pass spends looking for opportunities.  The heap
+// footprint of the FactManager is measured before and after each pass.
+//
+// Results are reported per fuzzer pass, most expensive first, and per
+// transformation family.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/fuzz/fact_manager/fact_manager.h"
+#include "source/fuzz/fuzzer_context.h"
+#include "source/fuzz/fuzzer_pass_add_access_chains.h"
+#include "source/fuzz/fuzzer_pass_add_bit_instruction_synonyms.h"
+#include "source/fuzz/fuzzer_pass_add_composite_extract.h"
+#include "source/fuzz/fuzzer_pass_add_composite_inserts.h"
+#include "source/fuzz/fuzzer_pass_add_composite_types.h"
+#include "source/fuzz/fuzzer_pass_add_copy_memory.h"
+#include "source/fuzz/fuzzer_pass_add_dead_blocks.h"
+#include "source/fuzz/fuzzer_pass_add_dead_breaks.h"
+#include "source/fuzz/fuzzer_pass_add_dead_continues.h"
+#include "source/fuzz/fuzzer_pass_add_equation_instructions.h"
+#include "source/fuzz/fuzzer_pass_add_function_calls.h"
+#include "source/fuzz/fuzzer_pass_add_global_variables.h"
+#include "source/fuzz/fuzzer_pass_add_image_sample_unused_components.h"
+#include "source/fuzz/fuzzer_pass_add_loads.h"
+#include "source/fuzz/fuzzer_pass_add_local_variables.h"
+#include "source/fuzz/fuzzer_pass_add_loop_preheaders.h"
+#include "source/fuzz/fuzzer_pass_add_loops_to_create_int_constant_synonyms.h"
+#include "source/fuzz/fuzzer_pass_add_no_contraction_decorations.h"
+#include "source/fuzz/fuzzer_pass_add_opphi_synonyms.h"
+#include "source/fuzz/fuzzer_pass_add_parameters.h"
+#include "source/fuzz/fuzzer_pass_add_relaxed_decorations.h"
+#include "source/fuzz/fuzzer_pass_add_stores.h"
+#include "source/fuzz/fuzzer_pass_add_synonyms.h"
+#include "source/fuzz/fuzzer_pass_add_vector_shuffle_instructions.h"
+#include "source/fuzz/fuzzer_pass_adjust_branch_weights.h"
+#include "source/fuzz/fuzzer_pass_adjust_function_controls.h"
+#include "source/fuzz/fuzzer_pass_adjust_loop_controls.h"
+#include "source/fuzz/fuzzer_pass_adjust_memory_operands_masks.h"
+#include "source/fuzz/fuzzer_pass_adjust_selection_controls.h"
+#include "source/fuzz/fuzzer_pass_apply_id_synonyms.h"
+#include "source/fuzz/fuzzer_pass_construct_composites.h"
+#include "source/fuzz/fuzzer_pass_copy_objects.h"
+#include "source/fuzz/fuzzer_pass_donate_modules.h"
+#include "source/fuzz/fuzzer_pass_duplicate_regions_with_selections.h"
+#include "source/fuzz/fuzzer_pass_expand_vector_reductions.h"
+#include "source/fuzz/fuzzer_pass_flatten_conditional_branches.h"
+#include "source/fuzz/fuzzer_pass_inline_functions.h"
+#include "source/fuzz/fuzzer_pass_interchange_signedness_of_integer_operands.h"
+#include "source/fuzz/fuzzer_pass_interchange_zero_like_constants.h"
+#include "source/fuzz/fuzzer_pass_invert_comparison_operators.h"
+#include "source/fuzz/fuzzer_pass_make_vector_operations_dynamic.h"
+#include "source/fuzz/fuzzer_pass_merge_blocks.h"
+#include "source/fuzz/fuzzer_pass_merge_function_returns.h"
+#include "source/fuzz/fuzzer_pass_mutate_pointers.h"
+#include "source/fuzz/fuzzer_pass_obfuscate_constants.h"
+#include "source/fuzz/fuzzer_pass_outline_functions.h"
+#include "source/fuzz/fuzzer_pass_permute_blocks.h"
+#include "source/fuzz/fuzzer_pass_permute_function_parameters.h"
+#include "source/fuzz/fuzzer_pass_permute_function_variables.h"
+#include "source/fuzz/fuzzer_pass_permute_instructions.h"
+#include "source/fuzz/fuzzer_pass_permute_phi_operands.h"
+#include "source/fuzz/fuzzer_pass_propagate_instructions_down.h"
+#include "source/fuzz/fuzzer_pass_propagate_instructions_up.h"
+#include "source/fuzz/fuzzer_pass_push_ids_through_variables.h"
+#include "source/fuzz/fuzzer_pass_replace_adds_subs_muls_with_carrying_extended.h"
+#include "source/fuzz/fuzzer_pass_replace_branches_from_dead_blocks_with_exits.h"
+#include "source/fuzz/fuzzer_pass_replace_copy_memories_with_loads_stores.h"
+#include "source/fuzz/fuzzer_pass_replace_copy_objects_with_stores_loads.h"
+#include "source/fuzz/fuzzer_pass_replace_irrelevant_ids.h"
+#include "source/fuzz/fuzzer_pass_replace_linear_algebra_instructions.h"
+#include "source/fuzz/fuzzer_pass_replace_loads_stores_with_copy_memories.h"
+#include "source/fuzz/fuzzer_pass_replace_opphi_ids_from_dead_predecessors.h"
+#include "source/fuzz/fuzzer_pass_replace_opselects_with_conditional_branches.h"
+#include "source/fuzz/fuzzer_pass_replace_parameter_with_global.h"
+#include "source/fuzz/fuzzer_pass_replace_params_with_struct.h"
+#include "source/fuzz/fuzzer_pass_split_blocks.h"
+#include "source/fuzz/fuzzer_pass_swap_commutable_operands.h"
+#include "source/fuzz/fuzzer_pass_swap_conditional_branch_operands.h"
+#include "source/fuzz/fuzzer_pass_swap_functions.h"
+#include "source/fuzz/fuzzer_pass_toggle_access_chain_instruction.h"
+#include "source/fuzz/fuzzer_pass_wrap_regions_in_selections.h"
+#include "source/fuzz/fuzzer_pass_wrap_vector_synonym.h"
+#include "source/fuzz/fuzzer_util.h"
+#include "source/fuzz/protobufs/spirvfuzz_protobufs.h"
+#include "source/fuzz/pseudo_random_generator.h"
+#include "source/fuzz/transformation.h"
+#include "source/fuzz/transformation_context.h"
+#include "source/opt/build_module.h"
+#include "source/util/make_unique.h"
+#include "spirv-tools/libspirv.hpp"
+#include "tools/io.h"
+
+namespace {
+
+// Every allocation made through the global operator new is preceded by a
+// header recording its size, so that the number of live heap bytes is known
+// at all times.  The header is as large as the strictest fundamental
+// alignment, so that the memory following it is suitably aligned.
+const size_t kAllocationHeaderSize = alignof(std::max_align_t);
+
+std::atomic<int64_t> live_heap_bytes(0);
+
+}  // namespace
+
+void* operator new(size_t size) {
+  auto* block = static_cast<char*>(std::malloc(size + kAllocationHeaderSize));
+  if (block == nullptr) {
+    std::fprintf(stderr, "error: out of memory\n");
+    std::abort();
+  }
+  *reinterpret_cast<size_t*>(block) = size;
+  live_heap_bytes += static_cast<int64_t>(size);
+  return block + kAllocationHeaderSize;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* block = static_cast<char*>(ptr) - kAllocationHeaderSize;
+  live_heap_bytes -= static_cast<int64_t>(*reinterpret_cast<size_t*>(block));
+  std::free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+
+namespace spvtools {
+namespace fuzz {
+namespace {
+
+const spv_target_env kTargetEnv = SPV_ENV_UNIVERSAL_1_3;
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Shader {
+  std::string name;
+  std::vector<uint32_t> binary;
+};
+
+struct BenchmarkOptions {
+  // The number of times each pass is applied to each shader.
+  uint32_t rounds = 3;
+  uint32_t seed = 0;
+  // Only passes whose name contains this string are run.
+  std::string pass_filter;
+};
+
+// Costs accumulated for a fuzzer pass over the whole corpus.
+struct PassStats {
+  std::string name;
+  // The number of shaders the pass was run on, i.e. the number of variants it
+  // generated.
+  uint32_t num_variants = 0;
+  uint32_t num_transformations = 0;
+  // Time spent in FuzzerPass::Apply, which includes the calls the pass makes to
+  // IsApplicable and Apply.
+  double pass_seconds = 0;
+  // Time spent in IsApplicable and Apply when the transformations are
+  // replayed.
+  double is_applicable_seconds = 0;
+  double apply_seconds = 0;
+  double validation_seconds = 0;
+  int64_t fact_manager_growth_bytes = 0;
+};
+
+// Costs accumulated for a transformation family over the whole corpus.
+struct FamilyStats {
+  uint32_t num_transformations = 0;
+  double is_applicable_seconds = 0;
+  double apply_seconds = 0;
+};
+
+using PassFactory = std::function<std::unique_ptr<FuzzerPass>(
+    opt::IRContext*, TransformationContext*, FuzzerContext*,
+    protobufs::TransformationSequence*)>;
+
+struct PassEntry {
+  std::string name;
+  PassFactory factory;
+};
+
+template <typename FuzzerPassT>
+PassEntry MakePassEntry(const std::string& name) {
+  return {name,
+          [](opt::IRContext* ir_context,
+             TransformationContext* transformation_context,
+             FuzzerContext* fuzzer_context,
+             protobufs::TransformationSequence* transformations)
+              -> std::unique_ptr<FuzzerPass> {
+            // Inapplicable transformations are ignored, as they are when
+            // spirv-fuzz is deployed at scale.
+            return MakeUnique<FuzzerPassT>(ir_context, transformation_context,
+                                           fuzzer_context, transformations,
+                                           true);
+          }};
+}
+
+// Returns an entry for every fuzzer pass.  |donor_suppliers| is used by the
+// pass that donates modules.
+std::vector<PassEntry> GetPassEntries(
+    const std::vector<fuzzerutil::ModuleSupplier>& donor_suppliers) {
+  std::vector<PassEntry> result = {
+      MakePassEntry<FuzzerPassAddAccessChains>("FuzzerPassAddAccessChains"),
+      MakePassEntry<FuzzerPassAddBitInstructionSynonyms>(
+          "FuzzerPassAddBitInstructionSynonyms"),
+      MakePassEntry<FuzzerPassAddCompositeExtract>(
+          "FuzzerPassAddCompositeExtract"),
+      MakePassEntry<FuzzerPassAddCompositeInserts>(
+          "FuzzerPassAddCompositeInserts"),
+      MakePassEntry<FuzzerPassAddCompositeTypes>("FuzzerPassAddCompositeTypes"),
+      MakePassEntry<FuzzerPassAddCopyMemory>("FuzzerPassAddCopyMemory"),
+      MakePassEntry<FuzzerPassAddDeadBlocks>("FuzzerPassAddDeadBlocks"),
+      MakePassEntry<FuzzerPassAddDeadBreaks>("FuzzerPassAddDeadBreaks"),
+      MakePassEntry<FuzzerPassAddDeadContinues>("FuzzerPassAddDeadContinues"),
+      MakePassEntry<FuzzerPassAddEquationInstructions>(
+          "FuzzerPassAddEquationInstructions"),
+      MakePassEntry<FuzzerPassAddFunctionCalls>("FuzzerPassAddFunctionCalls"),
+      MakePassEntry<FuzzerPassAddGlobalVariables>(
+          "FuzzerPassAddGlobalVariables"),
+      MakePassEntry<FuzzerPassAddImageSampleUnusedComponents>(
+          "FuzzerPassAddImageSampleUnusedComponents"),
+      MakePassEntry<FuzzerPassAddLoads>("FuzzerPassAddLoads"),
+      MakePassEntry<FuzzerPassAddLocalVariables>("FuzzerPassAddLocalVariables"),
+      MakePassEntry<FuzzerPassAddLoopPreheaders>("FuzzerPassAddLoopPreheaders"),
+      MakePassEntry<FuzzerPassAddLoopsToCreateIntConstantSynonyms>(
+          "FuzzerPassAddLoopsToCreateIntConstantSynonyms"),
+      MakePassEntry<FuzzerPassAddNoContractionDecorations>(
+          "FuzzerPassAddNoContractionDecorations"),
+      MakePassEntry<FuzzerPassAddOpPhiSynonyms>("FuzzerPassAddOpPhiSynonyms"),
+      MakePassEntry<FuzzerPassAddParameters>("FuzzerPassAddParameters"),
+      MakePassEntry<FuzzerPassAddRelaxedDecorations>(
+          "FuzzerPassAddRelaxedDecorations"),
+      MakePassEntry<FuzzerPassAddStores>("FuzzerPassAddStores"),
+      MakePassEntry<FuzzerPassAddSynonyms>("FuzzerPassAddSynonyms"),
+      MakePassEntry<FuzzerPassAddVectorShuffleInstructions>(
+          "FuzzerPassAddVectorShuffleInstructions"),
+      MakePassEntry<FuzzerPassAdjustBranchWeights>(
+          "FuzzerPassAdjustBranchWeights"),
+      MakePassEntry<FuzzerPassAdjustFunctionControls>(
+          "FuzzerPassAdjustFunctionControls"),
+      MakePassEntry<FuzzerPassAdjustLoopControls>(
+          "FuzzerPassAdjustLoopControls"),
+      MakePassEntry<FuzzerPassAdjustMemoryOperandsMasks>(
+          "FuzzerPassAdjustMemoryOperandsMasks"),
+      MakePassEntry<FuzzerPassAdjustSelectionControls>(
+          "FuzzerPassAdjustSelectionControls"),
+      MakePassEntry<FuzzerPassApplyIdSynonyms>("FuzzerPassApplyIdSynonyms"),
+      MakePassEntry<FuzzerPassConstructComposites>(
+          "FuzzerPassConstructComposites"),
+      MakePassEntry<FuzzerPassCopyObjects>("FuzzerPassCopyObjects"),
+      MakePassEntry<FuzzerPassDuplicateRegionsWithSelections>(
+          "FuzzerPassDuplicateRegionsWithSelections"),
+      MakePassEntry<FuzzerPassExpandVectorReductions>(
+          "FuzzerPassExpandVectorReductions"),
+      MakePassEntry<FuzzerPassFlattenConditionalBranches>(
+          "FuzzerPassFlattenConditionalBranches"),
+      MakePassEntry<FuzzerPassInlineFunctions>("FuzzerPassInlineFunctions"),
+      MakePassEntry<FuzzerPassInterchangeSignednessOfIntegerOperands>(
+          "FuzzerPassInterchangeSignednessOfIntegerOperands"),
+      MakePassEntry<FuzzerPassInterchangeZeroLikeConstants>(
+          "FuzzerPassInterchangeZeroLikeConstants"),
+      MakePassEntry<FuzzerPassInvertComparisonOperators>(
+          "FuzzerPassInvertComparisonOperators"),
+      MakePassEntry<FuzzerPassMakeVectorOperationsDynamic>(
+          "FuzzerPassMakeVectorOperationsDynamic"),
+      MakePassEntry<FuzzerPassMergeBlocks>("FuzzerPassMergeBlocks"),
+      MakePassEntry<FuzzerPassMergeFunctionReturns>(
+          "FuzzerPassMergeFunctionReturns"),
+      MakePassEntry<FuzzerPassMutatePointers>("FuzzerPassMutatePointers"),
+      MakePassEntry<FuzzerPassObfuscateConstants>(
+          "FuzzerPassObfuscateConstants"),
+      MakePassEntry<FuzzerPassOutlineFunctions>("FuzzerPassOutlineFunctions"),
+      MakePassEntry<FuzzerPassPermuteBlocks>("FuzzerPassPermuteBlocks"),
+      MakePassEntry<FuzzerPassPermuteFunctionParameters>(
+          "FuzzerPassPermuteFunctionParameters"),
+      MakePassEntry<FuzzerPassPermuteFunctionVariables>(
+          "FuzzerPassPermuteFunctionVariables"),
+      MakePassEntry<FuzzerPassPermuteInstructions>(
+          "FuzzerPassPermuteInstructions"),
+      MakePassEntry<FuzzerPassPermutePhiOperands>(
+          "FuzzerPassPermutePhiOperands"),
+      MakePassEntry<FuzzerPassPropagateInstructionsDown>(
+          "FuzzerPassPropagateInstructionsDown"),
+      MakePassEntry<FuzzerPassPropagateInstructionsUp>(
+          "FuzzerPassPropagateInstructionsUp"),
+      MakePassEntry<FuzzerPassPushIdsThroughVariables>(
+          "FuzzerPassPushIdsThroughVariables"),
+      MakePassEntry<FuzzerPassReplaceAddsSubsMulsWithCarryingExtended>(
+          "FuzzerPassReplaceAddsSubsMulsWithCarryingExtended"),
+      MakePassEntry<FuzzerPassReplaceBranchesFromDeadBlocksWithExits>(
+          "FuzzerPassReplaceBranchesFromDeadBlocksWithExits"),
+      MakePassEntry<FuzzerPassReplaceCopyMemoriesWithLoadsStores>(
+          "FuzzerPassReplaceCopyMemoriesWithLoadsStores"),
+      MakePassEntry<FuzzerPassReplaceCopyObjectsWithStoresLoads>(
+          "FuzzerPassReplaceCopyObjectsWithStoresLoads"),
+      MakePassEntry<FuzzerPassReplaceIrrelevantIds>(
+          "FuzzerPassReplaceIrrelevantIds"),
+      MakePassEntry<FuzzerPassReplaceLinearAlgebraInstructions>(
+          "FuzzerPassReplaceLinearAlgebraInstructions"),
+      MakePassEntry<FuzzerPassReplaceLoadsStoresWithCopyMemories>(
+          "FuzzerPassReplaceLoadsStoresWithCopyMemories"),
+      MakePassEntry<FuzzerPassReplaceOpPhiIdsFromDeadPredecessors>(
+          "FuzzerPassReplaceOpPhiIdsFromDeadPredecessors"),
+      MakePassEntry<FuzzerPassReplaceOpSelectsWithConditionalBranches>(
+          "FuzzerPassReplaceOpSelectsWithConditionalBranches"),
+      MakePassEntry<FuzzerPassReplaceParameterWithGlobal>(
+          "FuzzerPassReplaceParameterWithGlobal"),
+      MakePassEntry<FuzzerPassReplaceParamsWithStruct>(
+          "FuzzerPassReplaceParamsWithStruct"),
+      MakePassEntry<FuzzerPassSplitBlocks>("FuzzerPassSplitBlocks"),
+      MakePassEntry<FuzzerPassSwapCommutableOperands>(
+          "FuzzerPassSwapCommutableOperands"),
+      MakePassEntry<FuzzerPassSwapBranchConditionalOperands>(
+          "FuzzerPassSwapBranchConditionalOperands"),
+      MakePassEntry<FuzzerPassSwapFunctions>("FuzzerPassSwapFunctions"),
+      MakePassEntry<FuzzerPassToggleAccessChainInstruction>(
+          "FuzzerPassToggleAccessChainInstruction"),
+      MakePassEntry<FuzzerPassWrapRegionsInSelections>(
+          "FuzzerPassWrapRegionsInSelections"),
+      MakePassEntry<FuzzerPassWrapVectorSynonym>("FuzzerPassWrapVectorSynonym"),
+  };
+  result.push_back(
+      {"FuzzerPassDonateModules",
+       [donor_suppliers](opt::IRContext* ir_context,
+                         TransformationContext* transformation_context,
+                         FuzzerContext* fuzzer_context,
+                         protobufs::TransformationSequence* transformations)
+           -> std::unique_ptr<FuzzerPass> {
+         return MakeUnique<FuzzerPassDonateModules>(
+             ir_context, transformation_context, fuzzer_context,
+             transformations, true, donor_suppliers);
+       }});
+  std::sort(result.begin(), result.end(),
+            [](const PassEntry& first, const PassEntry& second) {
+              return first.name < second.name;
+            });
+  return result;
+}
+
+// Returns the number of heap bytes owned by |fact_manager|, measured by
+// copying it.
+int64_t GetFactManagerBytes(const FactManager& fact_manager,
+                            opt::IRContext* ir_context) {
+  const int64_t bytes_before = live_heap_bytes;
+  auto copy = MakeUnique<FactManager>(fact_manager, ir_context);
+  return live_heap_bytes - bytes_before;
+}
+
+// Returns the name of the transformation family that |message| belongs to,
+// e.g. "add_dead_block".
+std::string GetTransformationFamily(const protobufs::Transformation& message) {
+  const auto* field =
+      protobufs::Transformation::descriptor()->FindFieldByNumber(
+          static_cast<int>(message.transformation_case()));
+  return field == nullptr ? "unknown" : field->name();
+}
+
+// Runs the pass described by |pass_entry| on |shader|, adding its costs to
+// |pass_stats| and the costs of the transformations it applied to
+// |family_stats|.  Returns false if the pass led to an invalid module.
+bool BenchmarkPassOnShader(const PassEntry& pass_entry, const Shader& shader,
+                           const BenchmarkOptions& options,
+                           const MessageConsumer& consumer,
+                           PassStats* pass_stats,
+                           std::map<std::string, FamilyStats>* family_stats) {
+  ValidatorOptions validator_options;
+  auto ir_context = BuildModule(kTargetEnv, consumer, shader.binary.data(),
+                                shader.binary.size());
+  TransformationContext transformation_context(
+      MakeUnique<FactManager>(ir_context.get()), validator_options);
+  FuzzerContext fuzzer_context(MakeUnique<PseudoRandomGenerator>(options.seed),
+                               FuzzerContext::GetMinFreshId(ir_context.get()),
+                               false);
+  protobufs::TransformationSequence transformations;
+  auto pass = pass_entry.factory(ir_context.get(), &transformation_context,
+                                 &fuzzer_context, &transformations);
+
+  const int64_t fact_manager_bytes_before = GetFactManagerBytes(
+      *transformation_context.GetFactManager(), ir_context.get());
+
+  auto start = Clock::now();
+  for (uint32_t round = 0; round < options.rounds; round++) {
+    pass->Apply();
+  }
+  pass_stats->pass_seconds += SecondsSince(start);
+
+  start = Clock::now();
+  const bool is_valid = fuzzerutil::IsValidAndWellFormed(
+      ir_context.get(), validator_options, consumer);
+  pass_stats->validation_seconds += SecondsSince(start);
+  if (!is_valid) {
+    std::fprintf(stderr, "error: %s led to an invalid module for %s\n",
+                 pass_entry.name.c_str(), shader.name.c_str());
+    return false;
+  }
+
+  pass_stats->fact_manager_growth_bytes +=
+      GetFactManagerBytes(*transformation_context.GetFactManager(),
+                          ir_context.get()) -
+      fact_manager_bytes_before;
+  pass_stats->num_variants++;
+
+  auto replay_ir_context = BuildModule(
+      kTargetEnv, consumer, shader.binary.data(), shader.binary.size());
+  TransformationContext replay_transformation_context(
+      MakeUnique<FactManager>(replay_ir_context.get()), validator_options);
+  for (const auto& message : transformations.transformation()) {
+    auto transformation = Transformation::FromMessage(message);
+    auto& family = (*family_stats)[GetTransformationFamily(message)];
+
+    start = Clock::now();
+    const bool is_applicable = transformation->IsApplicable(
+        replay_ir_context.get(), replay_transformation_context);
+    const double is_applicable_seconds = SecondsSince(start);
+    pass_stats->is_applicable_seconds += is_applicable_seconds;
+    family.is_applicable_seconds += is_applicable_seconds;
+    if (!is_applicable) {
+      // The transformation was applicable when the pass applied it, so this
+      // should not happen; the replay has diverged.
+      std::fprintf(stderr, "error: replay of %s diverged for %s\n",
+                   pass_entry.name.c_str(), shader.name.c_str());
+      return false;
+    }
+
+    start = Clock::now();
+    transformation->Apply(replay_ir_context.get(),
+                          &replay_transformation_context);
+    const double apply_seconds = SecondsSince(start);
+    pass_stats->apply_seconds += apply_seconds;
+    family.apply_seconds += apply_seconds;
+
+    pass_stats->num_transformations++;
+    family.num_transformations++;
+  }
+  return true;
+}
+
+double Percentage(double part, double whole) {
+  return whole > 0 ? 100.0 * part / whole : 0.0;
+}
+
+double PerSecond(uint32_t count, double seconds) {
+  return seconds > 0 ? count / seconds : 0.0;
+}
+
+double MicrosecondsEach(double seconds, uint32_t count) {
+  return count > 0 ? 1e6 * seconds / count : 0.0;
+}
+
+void PrintPassStats(std::vector<PassStats> all_pass_stats) {
+  // The most expensive passes, per generated variant, are listed first.
+  auto cost_per_variant = [](const PassStats& stats) {
+    return stats.num_variants == 0
+               ? 0.0
+               : (stats.pass_seconds + stats.validation_seconds) /
+                     stats.num_variants;
+  };
+  std::sort(all_pass_stats.begin(), all_pass_stats.end(),
+            [&cost_per_variant](const PassStats& first,
+                                const PassStats& second) {
+              return cost_per_variant(first) > cost_per_variant(second);
+            });
+
+  // The time a pass spends outside IsApplicable and Apply is its search for
+  // opportunities.  IsApplicable and Apply are timed during the replay, which
+  // performs the same work as the pass did.
+  std::printf("%-52s %8s %10s %10s %7s %7s %7s %7s %10s\n", "pass",
+              "#trans", "trans/s", "ms/variant", "search%", "isapp%",
+              "apply%", "valid%", "facts(KiB)");
+  for (const auto& stats : all_pass_stats) {
+    const double total_seconds = stats.pass_seconds + stats.validation_seconds;
+    const double search_seconds =
+        std::max(0.0, stats.pass_seconds - stats.is_applicable_seconds -
+                          stats.apply_seconds);
+    std::printf(
+        "%-52s %8u %10.0f %10.3f %7.1f %7.1f %7.1f %7.1f %10.1f\n",
+        stats.name.c_str(), stats.num_transformations,
+        PerSecond(stats.num_transformations, total_seconds),
+        1000.0 * cost_per_variant(stats),
+        Percentage(search_seconds, total_seconds),
+        Percentage(stats.is_applicable_seconds, total_seconds),
+        Percentage(stats.apply_seconds, total_seconds),
+        Percentage(stats.validation_seconds, total_seconds),
+        static_cast<double>(stats.fact_manager_growth_bytes) / 1024.0);
+  }
+}
+
+void PrintFamilyStats(const std::map<std::string, FamilyStats>& family_stats) {
+  std::printf("%-52s %8s %10s %12s %12s\n", "transformation", "#trans",
+              "trans/s", "isapp(us)", "apply(us)");
+  for (const auto& entry : family_stats) {
+    const auto& stats = entry.second;
+    std::printf("%-52s %8u %10.0f %12.2f %12.2f\n", entry.first.c_str(),
+                stats.num_transformations,
+                PerSecond(stats.num_transformations,
+                          stats.is_applicable_seconds + stats.apply_seconds),
+                MicrosecondsEach(stats.is_applicable_seconds,
+                                 stats.num_transformations),
+                MicrosecondsEach(stats.apply_seconds,
+                                 stats.num_transformations));
+  }
+}
+
+void PrintUsage(const char* program) {
+  std::printf(
+      R"(%s - Measures the throughput of spirv-fuzz's fuzzer passes and
+transformations.
+
+USAGE: %s [options] <shader.spv> [<shader.spv> ...]
+
+Each fuzzer pass is run on every given shader, which must be valid.  For each
+pass, the report gives the number of transformations applied, transformations
+per second, the cost per generated variant, the share of time spent searching
+for opportunities, in IsApplicable, in Apply and in validation, and how much
+the FactManager grew.  A second report gives the cost of each transformation
+family.
+
+Options (in lexicographical order):
+  -h, --help
+               Print this help.
+  --pass=<substring>
+               Only run the fuzzer passes whose name contains <substring>.
+  --rounds=<n>
+               Apply each pass <n> times to each shader.  Defaults to 3.
+  --seed=<n>
+               Seed for the random number generator.  Defaults to 0.
+)",
+      program, program);
+}
+
+bool ParseUint32(const char* arg, uint32_t* value) {
+  char* end = nullptr;
+  const unsigned long parsed = std::strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || parsed > UINT32_MAX) {
+    return false;
+  }
+  *value = static_cast<uint32_t>(parsed);
+  return true;
+}
+
+int Run(int argc, const char** argv) {
+  BenchmarkOptions options;
+  std::vector<std::string> shader_files;
+  for (int argi = 1; argi < argc; argi++) {
+    const char* arg = argv[argi];
+    if (0 == strcmp(arg, "-h") || 0 == strcmp(arg, "--help")) {
+      PrintUsage(argv[0]);
+      return 0;
+    } else if (0 == strncmp(arg, "--pass=", sizeof("--pass=") - 1)) {
+      options.pass_filter = arg + sizeof("--pass=") - 1;
+    } else if (0 == strncmp(arg, "--rounds=", sizeof("--rounds=") - 1)) {
+      if (!ParseUint32(arg + sizeof("--rounds=") - 1, &options.rounds)) {
+        std::fprintf(stderr, "error: invalid argument: %s\n", arg);
+        return 1;
+      }
+    } else if (0 == strncmp(arg, "--seed=", sizeof("--seed=") - 1)) {
+      if (!ParseUint32(arg + sizeof("--seed=") - 1, &options.seed)) {
+        std::fprintf(stderr, "error: invalid argument: %s\n", arg);
+        return 1;
+      }
+    } else if (arg[0] == '-') {
+      std::fprintf(stderr, "error: unknown argument: %s\n", arg);
+      return 1;
+    } else {
+      shader_files.emplace_back(arg);
+    }
+  }
+  if (shader_files.empty()) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  const MessageConsumer consumer = [](spv_message_level_t, const char*,
+                                      const spv_position_t&, const char*) {};
+
+  // Shaders that cannot be read or are invalid are skipped, so that the
+  // whole of a corpus directory can be given on the command line.
+  std::vector<Shader> shaders;
+  for (const auto& shader_file : shader_files) {
+    Shader shader;
+    shader.name = shader_file;
+    if (!ReadBinaryFile<uint32_t>(shader_file.c_str(), &shader.binary)) {
+      continue;
+    }
+    auto ir_context = BuildModule(kTargetEnv, consumer, shader.binary.data(),
+                                  shader.binary.size());
+    if (!ir_context || !fuzzerutil::IsValidAndWellFormed(
+                           ir_context.get(), ValidatorOptions(), consumer)) {
+      std::fprintf(stderr, "warning: skipping invalid shader %s\n",
+                   shader_file.c_str());
+      continue;
+    }
+    shaders.push_back(std::move(shader));
+  }
+  if (shaders.empty()) {
+    std::fprintf(stderr, "error: no valid shaders\n");
+    return 1;
+  }
+
+  // The corpus doubles as the set of donor modules.
+  std::vector<fuzzerutil::ModuleSupplier> donor_suppliers;
+  for (const auto& shader : shaders) {
+    const auto* binary = &shader.binary;
+    donor_suppliers.emplace_back([binary, consumer]() {
+      return BuildModule(kTargetEnv, consumer, binary->data(), binary->size());
+    });
+  }
+
+  bool all_succeeded = true;
+  std::vector<PassStats> all_pass_stats;
+  std::map<std::string, FamilyStats> family_stats;
+  for (const auto& pass_entry : GetPassEntries(donor_suppliers)) {
+    if (pass_entry.name.find(options.pass_filter) == std::string::npos) {
+      continue;
+    }
+    PassStats pass_stats;
+    pass_stats.name = pass_entry.name;
+    for (const auto& shader : shaders) {
+      all_succeeded &= BenchmarkPassOnShader(pass_entry, shader, options,
+                                             consumer, &pass_stats,
+                                             &family_stats);
+    }
+    all_pass_stats.push_back(pass_stats);
+  }
+
+  std::printf("%zu shader(s), %u round(s) per pass, seed %u\n\n",
+              shaders.size(), options.rounds, options.seed);
+  PrintPassStats(all_pass_stats);
+  std::printf("\n");
+  PrintFamilyStats(family_stats);
+  return all_succeeded ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace fuzz
+}  // namespace spvtools
+
+int main(int argc, const char** argv) {
+  return spvtools::fuzz::Run(argc, argv);
+}
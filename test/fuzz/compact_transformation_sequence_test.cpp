@@ -0,0 +1,153 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/fuzz/compact_transformation_sequence.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace spvtools {
+namespace fuzz {
+namespace {
+
+protobufs::TransformationSequence MakeSequence(uint32_t num_transformations) {
+  protobufs::TransformationSequence result;
+  for (uint32_t i = 0; i < num_transformations; i++) {
+    auto* message =
+        result.add_transformation()->mutable_add_constant_boolean();
+    message->set_fresh_id(100 + i);
+    message->set_is_true(i % 2 == 0);
+  }
+  return result;
+}
+
+TEST(CompactTransformationSequenceTest, RoundTrip) {
+  for (uint32_t num_transformations : {0u, 1u, 10u}) {
+    const auto sequence = MakeSequence(num_transformations);
+    std::stringstream stream;
+    ASSERT_TRUE(WriteCompactTransformationSequence(sequence, &stream));
+    ASSERT_TRUE(IsCompactTransformationSequence(&stream));
+
+    protobufs::TransformationSequence read_sequence;
+    ASSERT_TRUE(ReadCompactTransformationSequence(&stream, UINT32_MAX,
+                                                  &read_sequence));
+    ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        sequence, read_sequence));
+  }
+}
+
+TEST(CompactTransformationSequenceTest, ReadPrefix) {
+  const auto sequence = MakeSequence(10);
+  std::stringstream stream;
+  ASSERT_TRUE(WriteCompactTransformationSequence(sequence, &stream));
+
+  protobufs::TransformationSequence prefix;
+  ASSERT_TRUE(ReadCompactTransformationSequence(&stream, 3, &prefix));
+  ASSERT_EQ(3, prefix.transformation_size());
+  for (int i = 0; i < prefix.transformation_size(); i++) {
+    ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        sequence.transformation(i), prefix.transformation(i)));
+  }
+}
+
+TEST(CompactTransformationSequenceTest, Reader) {
+  const auto sequence = MakeSequence(4);
+  std::stringstream stream;
+  ASSERT_TRUE(WriteCompactTransformationSequence(sequence, &stream));
+
+  CompactTransformationSequenceReader reader(&stream);
+  ASSERT_TRUE(reader.HasValidHeader());
+  ASSERT_EQ(4, reader.GetNumTransformations());
+  protobufs::Transformation transformation;
+  for (uint32_t i = 0; i < 4; i++) {
+    ASSERT_EQ(i, reader.GetNumTransformationsRead());
+    ASSERT_TRUE(reader.ReadNext(&transformation));
+    ASSERT_EQ(100 + i, transformation.add_constant_boolean().fresh_id());
+  }
+  ASSERT_FALSE(reader.ReadNext(&transformation));
+  ASSERT_EQ(4, reader.GetNumTransformationsRead());
+}
+
+TEST(CompactTransformationSequenceTest, Malformed) {
+  // A sequence in binary protobuf form is not in compact form.
+  std::stringstream protobuf_stream;
+  ASSERT_TRUE(MakeSequence(2).SerializeToOstream(&protobuf_stream));
+  ASSERT_FALSE(IsCompactTransformationSequence(&protobuf_stream));
+  protobufs::TransformationSequence read_sequence;
+  ASSERT_FALSE(ReadCompactTransformationSequence(&protobuf_stream, UINT32_MAX,
+                                                 &read_sequence));
+
+  // A truncated sequence has a valid header, but cannot be read completely.
+  std::stringstream stream;
+  ASSERT_TRUE(WriteCompactTransformationSequence(MakeSequence(2), &stream));
+  std::string contents = stream.str();
+  std::stringstream truncated_stream(contents.substr(0, contents.size() - 1));
+  ASSERT_TRUE(IsCompactTransformationSequence(&truncated_stream));
+  CompactTransformationSequenceReader reader(&truncated_stream);
+  ASSERT_TRUE(reader.HasValidHeader());
+  protobufs::Transformation transformation;
+  ASSERT_TRUE(reader.ReadNext(&transformation));
+  ASSERT_FALSE(reader.ReadNext(&transformation));
+}
+
+// Returns the bytes of |word| in little-endian order.
+std::string WordBytes(uint32_t word) {
+  std::string result;
+  for (uint32_t shift = 0; shift < 32; shift += 8) {
+    result.push_back(static_cast<char>((word >> shift) & 0xFF));
+  }
+  return result;
+}
+
+TEST(CompactTransformationSequenceTest, TruncatedRecord) {
+  std::stringstream stream;
+  ASSERT_TRUE(WriteCompactTransformationSequence(MakeSequence(1), &stream));
+  const std::string contents = stream.str();
+  // Drop the last byte of the only record, so that its size is larger than
+  // the bytes left.
+  std::stringstream truncated_stream(contents.substr(0, contents.size() - 1));
+  protobufs::TransformationSequence read_sequence;
+  ASSERT_FALSE(ReadCompactTransformationSequence(&truncated_stream, UINT32_MAX,
+                                                 &read_sequence));
+}
+
+TEST(CompactTransformationSequenceTest, OversizedRecord) {
+  // A record claiming to hold 4 GiB, followed by only a few bytes.
+  std::stringstream stream(WordBytes(kCompactTransformationSequenceMagic) +
+                           WordBytes(kCompactTransformationSequenceVersion) +
+                           WordBytes(1) + WordBytes(UINT32_MAX) + "abcd");
+  CompactTransformationSequenceReader reader(&stream);
+  ASSERT_TRUE(reader.HasValidHeader());
+  protobufs::Transformation transformation;
+  ASSERT_FALSE(reader.ReadNext(&transformation));
+  ASSERT_EQ(0, reader.GetNumTransformationsRead());
+}
+
+TEST(CompactTransformationSequenceTest, OversizedTransformationCount) {
+  // The header claims many more transformations than the stream holds.
+  std::stringstream stream;
+  ASSERT_TRUE(WriteCompactTransformationSequence(MakeSequence(2), &stream));
+  std::string contents = stream.str();
+  contents.replace(8, 4, WordBytes(UINT32_MAX));
+  std::stringstream oversized_stream(contents);
+  protobufs::TransformationSequence read_sequence;
+  ASSERT_FALSE(ReadCompactTransformationSequence(&oversized_stream, UINT32_MAX,
+                                                 &read_sequence));
+}
+
+}  // namespace
+}  // namespace fuzz
+}  // namespace spvtools
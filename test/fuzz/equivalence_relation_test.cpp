@@ -150,6 +150,63 @@ TEST(EquivalenceRelationTest, DeterministicEquivalenceClassOrder) {
   }
 }
 
+TEST(EquivalenceRelationTest, ClassSizes) {
+  EquivalenceRelation<uint32_t, UInt32Hash, UInt32Equals> relation;
+  for (uint32_t i = 0; i < 64; ++i) {
+    relation.Register(i);
+    ASSERT_EQ(1u, relation.GetEquivalenceClassSize(i));
+  }
+
+  // Merge classes of equal size pairwise, doubling the size of every class at
+  // each round.
+  for (uint32_t stride = 1; stride < 64; stride *= 2) {
+    for (uint32_t i = 0; i < 64; i += 2 * stride) {
+      relation.MakeEquivalent(i, i + stride);
+    }
+    for (uint32_t i = 0; i < 64; ++i) {
+      ASSERT_EQ(2 * stride, relation.GetEquivalenceClassSize(i));
+      ASSERT_EQ(2 * stride, relation.GetEquivalenceClass(i).size());
+    }
+  }
+  ASSERT_EQ(1u, relation.GetEquivalenceClassRepresentatives().size());
+
+  // Merging values that are already equivalent changes nothing.
+  relation.MakeEquivalent(3, 60);
+  ASSERT_EQ(64u, relation.GetEquivalenceClassSize(17));
+  ASSERT_THAT(ToUIntVector(relation.GetEquivalenceClass(17)),
+              testing::WhenSorted(ToUIntVector(relation.GetAllKnownValues())));
+}
+
+TEST(EquivalenceRelationTest, Copy) {
+  EquivalenceRelation<uint32_t, UInt32Hash, UInt32Equals> relation;
+  for (uint32_t i = 0; i < 100; ++i) {
+    relation.Register(i);
+  }
+  for (uint32_t i = 3; i < 100; ++i) {
+    relation.MakeEquivalent(i, i - 3);
+  }
+
+  EquivalenceRelation<uint32_t, UInt32Hash, UInt32Equals> copy(relation);
+
+  // The copy should own its values, and should present them, its
+  // representatives and its equivalence classes in the same order as the
+  // original.
+  ASSERT_THAT(ToUIntVector(copy.GetAllKnownValues()),
+              ToUIntVector(relation.GetAllKnownValues()));
+  ASSERT_NE(copy.GetAllKnownValues()[0], relation.GetAllKnownValues()[0]);
+  ASSERT_THAT(ToUIntVector(copy.GetEquivalenceClassRepresentatives()),
+              ToUIntVector(relation.GetEquivalenceClassRepresentatives()));
+  for (auto representative : relation.GetEquivalenceClassRepresentatives()) {
+    ASSERT_THAT(ToUIntVector(copy.GetEquivalenceClass(*representative)),
+                ToUIntVector(relation.GetEquivalenceClass(*representative)));
+  }
+
+  // The relations should evolve independently.
+  copy.MakeEquivalent(0, 1);
+  ASSERT_TRUE(copy.IsEquivalent(3, 4));
+  ASSERT_FALSE(relation.IsEquivalent(3, 4));
+}
+
 }  // namespace
 }  // namespace fuzz
 }  // namespace spvtools
@@ -86,6 +86,133 @@ TEST(DataSynonymAndIdEquationFactsTest, RecursiveAdditionOfFacts) {
                                         MakeDataDescriptor(11, {2, 3})));
 }
 
+TEST(DataSynonymAndIdEquationFactsTest, IncrementalClosureOfFacts) {
+  std::string shader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %12 "main"
+               OpExecutionMode %12 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeFloat 32
+          %7 = OpTypeVector %6 4
+          %9 = OpConstant %6 0
+         %10 = OpConstantComposite %7 %9 %9 %9 %9
+         %12 = OpFunction %2 None %3
+         %13 = OpLabel
+         %20 = OpCopyObject %7 %10
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  const auto consumer = nullptr;
+  const auto context = BuildModule(env, consumer, shader, kFuzzAssembleOption);
+  spvtools::ValidatorOptions validator_options;
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
+                                               kConsoleMessageConsumer));
+
+  FactManager fact_manager(context.get());
+
+  // Record that the vectors match at three of their four components, and
+  // compute the closure; nothing can be deduced about the vectors yet.
+  for (uint32_t i = 0; i < 3; i++) {
+    fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {i}),
+                                    MakeDataDescriptor(20, {i}));
+  }
+  fact_manager.ComputeClosureOfFacts(100);
+  ASSERT_FALSE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                         MakeDataDescriptor(20, {})));
+
+  // Recording the final component match allows the vectors to be deduced as
+  // synonymous, even though the other matches were already considered by the
+  // earlier closure computation.
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {3}),
+                                  MakeDataDescriptor(20, {3}));
+  ASSERT_FALSE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                         MakeDataDescriptor(20, {})));
+  fact_manager.ComputeClosureOfFacts(100);
+  ASSERT_TRUE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                        MakeDataDescriptor(20, {})));
+}
+
+TEST(DataSynonymAndIdEquationFactsTest, ClosureOnlyRevisitsChangedClasses) {
+  std::string shader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %12 "main"
+               OpExecutionMode %12 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeFloat 32
+          %7 = OpTypeVector %6 2
+          %9 = OpConstant %6 0
+         %10 = OpConstantComposite %7 %9 %9
+         %12 = OpFunction %2 None %3
+         %13 = OpLabel
+         %20 = OpCopyObject %7 %10
+         %30 = OpCopyObject %6 %9
+         %31 = OpCopyObject %6 %9
+         %32 = OpCopyObject %6 %9
+         %33 = OpCopyObject %6 %9
+         %40 = OpCopyObject %6 %9
+         %41 = OpCopyObject %6 %9
+         %50 = OpCopyObject %6 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  const auto consumer = nullptr;
+  const auto context = BuildModule(env, consumer, shader, kFuzzAssembleOption);
+  spvtools::ValidatorOptions validator_options;
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
+                                               kConsoleMessageConsumer));
+
+  FactManager fact_manager(context.get());
+
+  // The vectors match at both components, but each component class has four
+  // members, so a closure computation limited to classes of three members
+  // deduces nothing.
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {0}),
+                                  MakeDataDescriptor(20, {0}));
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {0}),
+                                  MakeDataDescriptor(30, {}));
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {0}),
+                                  MakeDataDescriptor(31, {}));
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {1}),
+                                  MakeDataDescriptor(20, {1}));
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {1}),
+                                  MakeDataDescriptor(32, {}));
+  fact_manager.AddFactDataSynonym(MakeDataDescriptor(10, {1}),
+                                  MakeDataDescriptor(33, {}));
+  fact_manager.ComputeClosureOfFacts(3);
+  ASSERT_FALSE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                         MakeDataDescriptor(20, {})));
+
+  // The component classes were too large to be searched, so they remain to be
+  // searched: a later closure computation with a larger limit deduces the
+  // fact, even if only an unrelated class has changed in the meantime.
+  FactManager copy(fact_manager, context.get());
+  copy.AddFactDataSynonym(MakeDataDescriptor(40, {}),
+                          MakeDataDescriptor(41, {}));
+  copy.ComputeClosureOfFacts(100);
+  ASSERT_TRUE(copy.IsSynonymous(MakeDataDescriptor(10, {}),
+                                MakeDataDescriptor(20, {})));
+
+  // The original facts are not affected by the copy, and also deduce the fact
+  // once the limit is raised.
+  ASSERT_FALSE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                         MakeDataDescriptor(20, {})));
+  fact_manager.ComputeClosureOfFacts(100);
+  ASSERT_TRUE(fact_manager.IsSynonymous(MakeDataDescriptor(10, {}),
+                                        MakeDataDescriptor(20, {})));
+}
+
 TEST(DataSynonymAndIdEquationFactsTest, CorollaryConversionFacts) {
   std::string shader = R"(
                OpCapability Shader
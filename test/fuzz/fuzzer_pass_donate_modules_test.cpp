@@ -2265,6 +2265,90 @@ TEST(FuzzerPassDonateModulesTest, HandlesOpPhisInMergeBlock) {
       recipient_context.get(), validator_options, kConsoleMessageConsumer));
 }
 
+TEST(FuzzerPassDonateModulesTest, DonorModulesAreSuppliedOnce) {
+  std::string recipient_shader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  std::string donor_shader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %8 = OpConstant %6 0
+          %9 = OpConstant %6 1
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+         %10 = OpVariable %7 Function
+               OpStore %10 %8
+         %11 = OpFunctionCall %2 %12
+               OpReturn
+               OpFunctionEnd
+         %12 = OpFunction %2 None %3
+         %13 = OpLabel
+         %14 = OpIAdd %6 %8 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  const auto consumer = nullptr;
+  spvtools::ValidatorOptions validator_options;
+
+  const auto recipient_context =
+      BuildModule(env, consumer, recipient_shader, kFuzzAssembleOption);
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
+      recipient_context.get(), validator_options, kConsoleMessageConsumer));
+
+  TransformationContext transformation_context(
+      MakeUnique<FactManager>(recipient_context.get()), validator_options);
+
+  FuzzerContext fuzzer_context(MakeUnique<PseudoRandomGenerator>(0), 100,
+                               false);
+  protobufs::TransformationSequence transformation_sequence;
+
+  // The supplier counts how many times it is invoked.
+  uint32_t times_supplied = 0;
+  std::vector<fuzzerutil::ModuleSupplier> donor_suppliers = {
+      [env, consumer, donor_shader,
+       &times_supplied]() -> std::unique_ptr<opt::IRContext> {
+        times_supplied++;
+        return BuildModule(env, consumer, donor_shader, kFuzzAssembleOption);
+      }};
+
+  FuzzerPassDonateModules fuzzer_pass(
+      recipient_context.get(), &transformation_context, &fuzzer_context,
+      &transformation_sequence, false, std::move(donor_suppliers));
+
+  for (uint32_t i = 0; i < 5; i++) {
+    fuzzer_pass.Apply();
+  }
+
+  // Every application of the pass donates at least once, but the donor should
+  // only have been supplied the first time.
+  ASSERT_EQ(1u, times_supplied);
+  ASSERT_GE(transformation_sequence.transformation_size(), 5);
+  ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
+      recipient_context.get(), validator_options, kConsoleMessageConsumer));
+}
+
 }  // namespace
 }  // namespace fuzz
 }  // namespace spvtools
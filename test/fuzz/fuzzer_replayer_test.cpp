@@ -1661,7 +1661,8 @@ void RunFuzzerAndReplayer(const std::string& shader,
   std::vector<RepeatedPassStrategy> strategies{
       RepeatedPassStrategy::kSimple,
       RepeatedPassStrategy::kLoopedWithRecommendations,
-      RepeatedPassStrategy::kRandomWithRecommendations};
+      RepeatedPassStrategy::kRandomWithRecommendations,
+      RepeatedPassStrategy::kCoverageGuided};
   uint32_t strategy_index = 0;
   for (uint32_t seed = initial_seed; seed < initial_seed + num_runs; seed++) {
     spvtools::ValidatorOptions validator_options;
@@ -983,6 +983,10 @@ class InterestingThenRandom : public InterestingnessTest {
 //
 // The |validator_options| parameter provides validator options that should be
 // used during shrinking.
+//
+// The |num_threads| parameter controls how many shrink attempts may run
+// concurrently; if it exceeds 1, |interestingness_function| must be
+// thread-safe.
 void RunAndCheckShrinker(
     const spv_target_env& target_env, const std::vector<uint32_t>& binary_in,
     const protobufs::FactSequence& initial_facts,
@@ -990,13 +994,14 @@ void RunAndCheckShrinker(
     const Shrinker::InterestingnessFunction& interestingness_function,
     const std::vector<uint32_t>& expected_binary_out,
     uint32_t expected_transformations_out_size, uint32_t step_limit,
-    spv_validator_options validator_options) {
+    spv_validator_options validator_options, uint32_t num_threads) {
   // Run the shrinker.
-  auto shrinker_result =
-      Shrinker(target_env, kConsoleMessageConsumer, binary_in, initial_facts,
-               transformation_sequence_in, interestingness_function, step_limit,
-               false, validator_options)
-          .Run();
+  Shrinker shrinker(target_env, kConsoleMessageConsumer, binary_in,
+                    initial_facts, transformation_sequence_in,
+                    interestingness_function, step_limit, false,
+                    validator_options);
+  shrinker.SetNumThreads(num_threads);
+  auto shrinker_result = shrinker.Run();
 
   ASSERT_TRUE(Shrinker::ShrinkerResultStatus::kComplete ==
                   shrinker_result.status ||
@@ -1084,7 +1089,13 @@ void RunFuzzerAndShrinker(const std::string& shader,
   RunAndCheckShrinker(env, binary_in, initial_facts,
                       fuzzer.GetTransformationSequence(),
                       AlwaysInteresting().AsFunction(), binary_in, 0,
-                      kReasonableStepLimit, validator_options);
+                      kReasonableStepLimit, validator_options, 1);
+
+  // The same should happen when several shrink attempts run concurrently.
+  RunAndCheckShrinker(env, binary_in, initial_facts,
+                      fuzzer.GetTransformationSequence(),
+                      AlwaysInteresting().AsFunction(), binary_in, 0,
+                      kReasonableStepLimit, validator_options, 4);
 
   // With the OnlyInterestingFirstTime test, no shrinking should be achieved.
   RunAndCheckShrinker(
@@ -1092,14 +1103,14 @@ void RunFuzzerAndShrinker(const std::string& shader,
       OnlyInterestingFirstTime().AsFunction(), transformed_binary,
       static_cast<uint32_t>(
           fuzzer.GetTransformationSequence().transformation_size()),
-      kReasonableStepLimit, validator_options);
+      kReasonableStepLimit, validator_options, 1);
 
   // The PingPong test is unpredictable; passing an empty expected binary
   // means that we don't check anything beyond that shrinking completes
   // successfully.
   RunAndCheckShrinker(
       env, binary_in, initial_facts, fuzzer.GetTransformationSequence(),
-      PingPong().AsFunction(), {}, 0, kSmallStepLimit, validator_options);
+      PingPong().AsFunction(), {}, 0, kSmallStepLimit, validator_options, 1);
 
   // The InterestingThenRandom test is unpredictable; passing an empty
   // expected binary means that we do not check anything about shrinking
@@ -1107,7 +1118,7 @@ void RunFuzzerAndShrinker(const std::string& shader,
   RunAndCheckShrinker(
       env, binary_in, initial_facts, fuzzer.GetTransformationSequence(),
       InterestingThenRandom(PseudoRandomGenerator(seed)).AsFunction(), {}, 0,
-      kSmallStepLimit, validator_options);
+      kSmallStepLimit, validator_options, 1);
 }
 
 TEST(FuzzerShrinkerTest, Miscellaneous1) {
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/fuzz/pass_management/repeated_pass_manager_coverage_guided.h"
+
+#include "gtest/gtest.h"
+#include "source/fuzz/fuzzer_util.h"
+#include "source/fuzz/pseudo_random_generator.h"
+#include "source/util/coverage_counters.h"
+#include "test/fuzz/fuzz_test_util.h"
+
+namespace spvtools {
+namespace fuzz {
+namespace {
+
+const std::string kShader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Function %6
+          %9 = OpConstant %6 0
+         %10 = OpConstant %6 1
+         %11 = OpTypeBool
+         %12 = OpConstantTrue %11
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+          %8 = OpVariable %7 Function
+               OpStore %8 %9
+               OpSelectionMerge %14 None
+               OpBranchConditional %12 %13 %14
+         %13 = OpLabel
+         %15 = OpIAdd %6 %9 %10
+               OpStore %8 %15
+               OpBranch %14
+         %14 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+// Fuzzes |kShader| with the passes chosen by a coverage-guided manager seeded
+// with |seed|, checking that measuring coverage leaves the module as it was,
+// and returns the index of each of the |num_choices| passes chosen.
+std::vector<uint32_t> ChoosePasses(uint32_t seed, uint32_t num_choices) {
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  const auto consumer = nullptr;
+  const auto context = BuildModule(env, consumer, kShader, kFuzzAssembleOption);
+  spvtools::ValidatorOptions validator_options;
+  EXPECT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
+                                               kConsoleMessageConsumer));
+  TransformationContext transformation_context(
+      MakeUnique<FactManager>(context.get()), validator_options);
+  FuzzerContext fuzzer_context(MakeUnique<PseudoRandomGenerator>(seed), 100,
+                               false);
+  protobufs::TransformationSequence transformations;
+
+  RepeatedPassInstances pass_instances;
+  pass_instances.SetPass(MakeUnique<FuzzerPassSplitBlocks>(
+      context.get(), &transformation_context, &fuzzer_context,
+      &transformations, false));
+  pass_instances.SetPass(MakeUnique<FuzzerPassAddDeadBreaks>(
+      context.get(), &transformation_context, &fuzzer_context,
+      &transformations, false));
+  pass_instances.SetPass(MakeUnique<FuzzerPassPermuteBlocks>(
+      context.get(), &transformation_context, &fuzzer_context,
+      &transformations, false));
+  const auto& passes = pass_instances.GetPasses();
+
+  RepeatedPassManagerCoverageGuided manager(&fuzzer_context, &pass_instances,
+                                            context.get());
+  std::vector<uint32_t> result;
+  for (uint32_t i = 0; i < num_choices; i++) {
+    std::vector<uint32_t> binary_before;
+    context->module()->ToBinary(&binary_before, false);
+    FuzzerPass* pass = manager.ChoosePass(transformations);
+    std::vector<uint32_t> binary_after;
+    context->module()->ToBinary(&binary_after, false);
+    EXPECT_EQ(binary_before, binary_after);
+    // The recorder used to measure coverage must not outlive the measurement.
+    EXPECT_EQ(nullptr, utils::CoverageRecorder::Current());
+
+    uint32_t index = 0;
+    while (index < passes.size() && passes[index].get() != pass) {
+      index++;
+    }
+    EXPECT_LT(index, passes.size());
+    result.push_back(index);
+
+    pass->Apply();
+    EXPECT_TRUE(fuzzerutil::IsValidAndWellFormed(
+        context.get(), validator_options, kConsoleMessageConsumer));
+  }
+  return result;
+}
+
+TEST(RepeatedPassManagerCoverageGuidedTest, ChoosesEnabledPasses) {
+  const std::vector<uint32_t> choices = ChoosePasses(0, 20);
+  ASSERT_EQ(20u, choices.size());
+  if (utils::CoverageCounters::Enabled()) {
+    // Measuring coverage ran the validator and the optimizer, which have
+    // registered the points they hit.
+    ASSERT_LT(0u, utils::CoverageCounters::Get().GetNumPoints());
+  }
+}
+
+TEST(RepeatedPassManagerCoverageGuidedTest, ChoicesDependOnlyOnTheSeed) {
+  // The second run starts with the coverage points of the first already
+  // registered and hit, and must make the same choices regardless.
+  for (uint32_t seed = 0; seed < 4; seed++) {
+    ASSERT_EQ(ChoosePasses(seed, 20), ChoosePasses(seed, 20));
+  }
+}
+
+}  // namespace
+}  // namespace fuzz
+}  // namespace spvtools
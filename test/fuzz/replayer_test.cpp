@@ -470,6 +470,149 @@ TEST(ReplayerTest, ReplayWithOverflowIds) {
   ASSERT_EQ(2, replayer_result.applied_transformations.transformation_size());
 }
 
+TEST(ReplayerTest, ReplayWithCheckpointCache) {
+  const std::string kTestShader = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+               OpSource ESSL 310
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %6 = OpTypeInt 32 1
+          %7 = OpTypePointer Private %6
+          %8 = OpVariable %7 Private
+          %9 = OpConstant %6 10
+         %10 = OpTypePointer Function %6
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+         %11 = OpVariable %10 Function
+               OpStore %8 %9
+         %12 = OpLoad %6 %8
+               OpStore %11 %12
+         %13 = OpLoad %6 %8
+               OpStore %11 %13
+         %14 = OpLoad %6 %8
+               OpStore %11 %14
+         %15 = OpLoad %6 %8
+               OpStore %11 %15
+         %16 = OpLoad %6 %8
+               OpStore %11 %16
+         %17 = OpLoad %6 %8
+               OpStore %11 %17
+         %18 = OpLoad %6 %8
+               OpStore %11 %18
+         %19 = OpLoad %6 %8
+               OpStore %11 %19
+         %20 = OpLoad %6 %8
+               OpStore %11 %20
+         %21 = OpLoad %6 %8
+               OpStore %11 %21
+         %22 = OpLoad %6 %8
+               OpStore %11 %22
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  const auto env = SPV_ENV_UNIVERSAL_1_3;
+  spvtools::ValidatorOptions validator_options;
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(env);
+  t.SetMessageConsumer(kConsoleMessageConsumer);
+  ASSERT_TRUE(t.Assemble(kTestShader, &binary_in, kFuzzAssembleOption));
+  ASSERT_TRUE(t.Validate(binary_in));
+
+  // Split blocks before each load, and make some synonyms, so that the
+  // snapshots need to capture both the module and the facts.
+  protobufs::TransformationSequence transformations;
+  for (uint32_t id = 12; id <= 22; id++) {
+    *transformations.add_transformation() =
+        TransformationSplitBlock(MakeInstructionDescriptor(id, SpvOpLoad, 0),
+                                 id + 100)
+            .ToMessage();
+    *transformations.add_transformation() =
+        TransformationAddSynonym(
+            id,
+            protobufs::TransformationAddSynonym::SynonymType::
+                TransformationAddSynonym_SynonymType_COPY_OBJECT,
+            id + 200, MakeInstructionDescriptor(id, SpvOpStore, 0))
+            .ToMessage();
+  }
+
+  protobufs::FactSequence empty_facts;
+  ReplayCheckpointCache checkpoint_cache(4);
+
+  // A full replay populates the cache.
+  auto full_result =
+      Replayer(env, kConsoleMessageConsumer, binary_in, empty_facts,
+               transformations, transformations.transformation_size(), true,
+               validator_options, &checkpoint_cache)
+          .Run();
+  ASSERT_EQ(Replayer::ReplayerResultStatus::kComplete, full_result.status);
+  ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+      transformations, full_result.applied_transformations));
+  ASSERT_EQ(5u, checkpoint_cache.GetNumCheckpoints());
+  ASSERT_EQ(0u, checkpoint_cache.GetNumTransformationsSkipped());
+
+  // Remove the last four transformations; replay should resume from the
+  // snapshot taken after 16 transformations.
+  protobufs::TransformationSequence shorter_transformations;
+  for (int i = 0; i < transformations.transformation_size() - 4; i++) {
+    *shorter_transformations.add_transformation() =
+        transformations.transformation(i);
+  }
+  auto cached_result =
+      Replayer(env, kConsoleMessageConsumer, binary_in, empty_facts,
+               shorter_transformations,
+               shorter_transformations.transformation_size(), true,
+               validator_options, &checkpoint_cache)
+          .Run();
+  ASSERT_EQ(Replayer::ReplayerResultStatus::kComplete, cached_result.status);
+  ASSERT_EQ(16u, checkpoint_cache.GetNumTransformationsSkipped());
+  ASSERT_EQ(4u, checkpoint_cache.GetNumCheckpoints());
+
+  auto uncached_result =
+      Replayer(env, kConsoleMessageConsumer, binary_in, empty_facts,
+               shorter_transformations,
+               shorter_transformations.transformation_size(), true,
+               validator_options)
+          .Run();
+  ASSERT_EQ(Replayer::ReplayerResultStatus::kComplete, uncached_result.status);
+
+  // Resuming from a snapshot should give exactly the same result as replaying
+  // from scratch.
+  ASSERT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+      uncached_result.applied_transformations,
+      cached_result.applied_transformations));
+  std::vector<uint32_t> cached_binary;
+  std::vector<uint32_t> uncached_binary;
+  cached_result.transformed_module->module()->ToBinary(&cached_binary, false);
+  uncached_result.transformed_module->module()->ToBinary(&uncached_binary,
+                                                         false);
+  ASSERT_EQ(uncached_binary, cached_binary);
+  for (uint32_t id = 12; id <= 20; id++) {
+    ASSERT_TRUE(
+        cached_result.transformation_context->GetFactManager()->IsSynonymous(
+            MakeDataDescriptor(id, {}), MakeDataDescriptor(id + 200, {})));
+  }
+
+  // Changing the first transformation invalidates every snapshot.
+  protobufs::TransformationSequence different_transformations =
+      shorter_transformations;
+  different_transformations.mutable_transformation()->DeleteSubrange(0, 1);
+  auto different_result =
+      Replayer(env, kConsoleMessageConsumer, binary_in, empty_facts,
+               different_transformations,
+               different_transformations.transformation_size(), true,
+               validator_options, &checkpoint_cache)
+          .Run();
+  ASSERT_EQ(Replayer::ReplayerResultStatus::kComplete, different_result.status);
+  ASSERT_EQ(16u, checkpoint_cache.GetNumTransformationsSkipped());
+  ASSERT_EQ(4u, checkpoint_cache.GetNumCheckpoints());
+}
+
 }  // namespace
 }  // namespace fuzz
 }  // namespace spvtools
@@ -161,6 +161,7 @@ TEST(TransformationExpandVectorReductionTest, Apply) {
   // Adds OpAny synonym for 2-dimensional vector.
   auto transformation = TransformationExpandVectorReduction(15, {21, 22, 23});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(23, {}), MakeDataDescriptor(15, {})));
 
@@ -168,6 +169,7 @@ TEST(TransformationExpandVectorReductionTest, Apply) {
   transformation =
       TransformationExpandVectorReduction(16, {24, 25, 26, 27, 28});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(28, {}), MakeDataDescriptor(16, {})));
 
@@ -175,12 +177,14 @@ TEST(TransformationExpandVectorReductionTest, Apply) {
   transformation =
       TransformationExpandVectorReduction(17, {29, 30, 31, 32, 33, 34, 35});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(35, {}), MakeDataDescriptor(17, {})));
 
   // Adds OpAll synonym for 2-dimensional vector.
   transformation = TransformationExpandVectorReduction(18, {36, 37, 38});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(38, {}), MakeDataDescriptor(18, {})));
 
@@ -188,6 +192,7 @@ TEST(TransformationExpandVectorReductionTest, Apply) {
   transformation =
       TransformationExpandVectorReduction(19, {39, 40, 41, 42, 43});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(43, {}), MakeDataDescriptor(19, {})));
 
@@ -195,6 +200,7 @@ TEST(TransformationExpandVectorReductionTest, Apply) {
   transformation =
       TransformationExpandVectorReduction(20, {44, 45, 46, 47, 48, 49, 50});
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(transformation_context.GetFactManager()->IsSynonymous(
       MakeDataDescriptor(50, {}), MakeDataDescriptor(20, {})));
 
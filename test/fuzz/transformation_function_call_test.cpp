@@ -262,6 +262,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
   {
     // Livesafe called from original live block: fine
@@ -273,6 +274,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
   {
     // Livesafe called from livesafe function: fine
@@ -284,6 +286,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
   {
     // Dead called from dead block in injected function: fine
@@ -295,6 +298,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
   {
     // Non-livesafe called from dead block in livesafe function: OK
@@ -306,6 +310,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
   {
     // Livesafe called from dead block with non-arbitrary parameter
@@ -317,6 +322,7 @@ TEST(TransformationFunctionCallTest, BasicTest) {
                           &transformation_context);
     ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(
         context.get(), validator_options, kConsoleMessageConsumer));
+    ASSERT_TRUE(context->IsConsistent());
   }
 
   std::string after_transformation = R"(
@@ -295,24 +295,28 @@ TEST(TransformationReplaceBooleanConstantWithConstantBinaryTest,
                         &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(replace_true_with_uint32_comparison.IsApplicable(
       context.get(), transformation_context));
   ApplyAndCheckFreshIds(replace_true_with_uint32_comparison, context.get(),
                         &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(replace_false_with_float_comparison.IsApplicable(
       context.get(), transformation_context));
   ApplyAndCheckFreshIds(replace_false_with_float_comparison, context.get(),
                         &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
   ASSERT_TRUE(replace_false_with_sint64_comparison.IsApplicable(
       context.get(), transformation_context));
   ApplyAndCheckFreshIds(replace_false_with_sint64_comparison, context.get(),
                         &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
 
   std::string after = R"(
                OpCapability Shader
@@ -561,12 +565,14 @@ TEST(TransformationReplaceBooleanConstantWithConstantBinaryTest,
   ApplyAndCheckFreshIds(replacement_1, context.get(), &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
 
   ASSERT_TRUE(
       replacement_2.IsApplicable(context.get(), transformation_context));
   ApplyAndCheckFreshIds(replacement_2, context.get(), &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  ASSERT_TRUE(context->IsConsistent());
 
   std::string after = R"(
                OpCapability Shader
@@ -669,6 +675,7 @@ TEST(TransformationReplaceBooleanConstantWithConstantBinaryTest, OpPhi) {
   ASSERT_TRUE(
       transformation.IsApplicable(context.get(), transformation_context));
   ApplyAndCheckFreshIds(transformation, context.get(), &transformation_context);
+  ASSERT_TRUE(context->IsConsistent());
 
   std::string variant_shader = R"(
                OpCapability Shader
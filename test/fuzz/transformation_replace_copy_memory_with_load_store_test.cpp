@@ -101,6 +101,9 @@ TEST(TransformationReplaceCopyMemoryWithLoadStoreTest, BasicScenarios) {
                         &transformation_context);
   ASSERT_TRUE(fuzzerutil::IsValidAndWellFormed(context.get(), validator_options,
                                                kConsoleMessageConsumer));
+  // The transformation updates the analyses it relies on rather than
+  // invalidating them, so they should agree with the module.
+  ASSERT_TRUE(context->IsConsistent());
 
   auto transformation_valid_2 = TransformationReplaceCopyMemoryWithLoadStore(
       21, instruction_descriptor_valid_2);
@@ -37,6 +37,14 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
                      (data[i + 3]) << 24;
   }
 
-  tools.Validate(input);
+  // Bound the checks whose cost is not linear in the size of the module, so
+  // that small inputs cannot make the fuzzer time out.
+  spvtools::ValidatorOptions options;
+  options.SetWorkLimit(spv_validator_work_limit_max_cfg_edges, 1u << 16);
+  options.SetWorkLimit(spv_validator_work_limit_max_dominance_queries,
+                       1u << 20);
+  options.SetWorkLimit(spv_validator_work_limit_max_type_traversal, 1u << 20);
+
+  tools.Validate(input.data(), input.size(), options);
   return 0;
 }
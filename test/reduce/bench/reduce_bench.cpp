@@ -0,0 +1,272 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the reduction strategies of spirv-reduce on a corpus of shaders.
+//
+// Each shader is reduced with respect to a known property: that it still
+// contains an instruction with a given opcode, chosen as the first opcode of a
+// fixed list that the shader uses.  The reduced shader is therefore known to
+// need little more than that instruction and the instructions it depends on,
+// which makes the sizes reached by the strategies comparable.
+//
+// The report gives, per shader and strategy, the number of interestingness
+// tests run and the number of bytes removed, and the number of tests run per
+// byte removed over the whole corpus.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "source/reduce/reducer.h"
+#include "source/spirv_constant.h"
+#include "spirv-tools/libspirv.hpp"
+#include "tools/io.h"
+
+namespace spvtools {
+namespace reduce {
+namespace {
+
+const spv_target_env kTargetEnv = SPV_ENV_UNIVERSAL_1_3;
+
+using Clock = std::chrono::steady_clock;
+
+// The opcodes a reduced shader is required to keep, most preferred first.
+const SpvOp kTargetOpcodes[] = {SpvOpFDiv, SpvOpIMul, SpvOpFMul, SpvOpIAdd,
+                                SpvOpFAdd, SpvOpLoad, SpvOpStore};
+
+struct BenchmarkOptions {
+  uint32_t step_limit = 2500;
+  // Only shaders whose file name contains this string are reduced.
+  std::string shader_filter;
+};
+
+struct Strategy {
+  const char* name;
+  Reducer::ReductionStrategy strategy;
+};
+
+const Strategy kStrategies[] = {
+    {"round-robin", Reducer::ReductionStrategy::kRoundRobin},
+    {"adaptive", Reducer::ReductionStrategy::kAdaptive}};
+
+// The cost and outcome of reducing one shader with one strategy.
+struct ReductionStats {
+  uint32_t num_tests = 0;
+  size_t bytes_removed = 0;
+  size_t final_bytes = 0;
+  double seconds = 0;
+  bool succeeded = false;
+};
+
+// Returns true if and only if |binary| contains an instruction with opcode
+// |opcode|.  |binary| must be a well-formed module.
+bool ContainsOpcode(const std::vector<uint32_t>& binary, SpvOp opcode) {
+  for (size_t word = SPV_INDEX_INSTRUCTION; word < binary.size();) {
+    const uint32_t word_count = binary[word] >> 16;
+    if (static_cast<SpvOp>(binary[word] & 0xFFFF) == opcode) {
+      return true;
+    }
+    if (word_count == 0) {
+      break;
+    }
+    word += word_count;
+  }
+  return false;
+}
+
+// Reduces |binary| with |strategy|, keeping the instructions with opcode
+// |target_opcode|.
+ReductionStats ReduceShader(const std::vector<uint32_t>& binary,
+                            SpvOp target_opcode,
+                            Reducer::ReductionStrategy strategy,
+                            const BenchmarkOptions& options) {
+  ReductionStats stats;
+  Reducer reducer(kTargetEnv);
+  reducer.SetMessageConsumer([](spv_message_level_t, const char*,
+                                const spv_position_t&, const char*) {});
+  reducer.SetInterestingnessFunction(
+      [target_opcode, &stats](const std::vector<uint32_t>& candidate,
+                              uint32_t) {
+        stats.num_tests++;
+        return ContainsOpcode(candidate, target_opcode);
+      });
+  reducer.AddDefaultReductionPasses();
+  reducer.SetReductionStrategy(strategy);
+
+  ReducerOptions reducer_options;
+  reducer_options.set_step_limit(options.step_limit);
+  std::vector<uint32_t> binary_out;
+  const auto start = Clock::now();
+  const auto status = reducer.Run(binary, &binary_out, reducer_options,
+                                  ValidatorOptions());
+  stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  stats.succeeded =
+      status == Reducer::ReductionResultStatus::kComplete ||
+      status == Reducer::ReductionResultStatus::kReachedStepLimit;
+  const size_t original_bytes = binary.size() * sizeof(uint32_t);
+  stats.final_bytes = binary_out.size() * sizeof(uint32_t);
+  stats.bytes_removed = stats.final_bytes < original_bytes
+                            ? original_bytes - stats.final_bytes
+                            : 0;
+  return stats;
+}
+
+double TestsPerByte(uint32_t num_tests, size_t bytes_removed) {
+  return bytes_removed == 0 ? 0 : static_cast<double>(num_tests) /
+                                      static_cast<double>(bytes_removed);
+}
+
+void PrintUsage(const char* program) {
+  std::printf(
+      R"(%s - Compares the interestingness tests per byte removed of the
+reduction strategies of spirv-reduce.
+
+USAGE: %s [options] <shader.spv> [<shader.spv> ...]
+
+Each given shader, which must be valid, is reduced with every strategy while
+keeping an instruction with the first of the opcodes OpFDiv, OpIMul, OpFMul,
+OpIAdd, OpFAdd, OpLoad and OpStore that it contains.  Shaders without any of
+these opcodes are skipped.  The report gives, per shader and strategy, the
+number of interestingness tests, the bytes removed and the size reached, then
+the totals of each strategy.
+
+Options (in lexicographical order):
+  -h, --help
+               Print this help.
+  --shader=<substring>
+               Only reduce the shaders whose file name contains <substring>.
+  --step-limit=<n>
+               The reduction step limit.  Defaults to 2500.
+)",
+      program, program);
+}
+
+bool ParseUint32(const char* arg, uint32_t* value) {
+  char* end = nullptr;
+  const unsigned long parsed = std::strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || parsed > UINT32_MAX) {
+    return false;
+  }
+  *value = static_cast<uint32_t>(parsed);
+  return true;
+}
+
+int Run(int argc, const char** argv) {
+  BenchmarkOptions options;
+  std::vector<std::string> shader_files;
+  for (int argi = 1; argi < argc; argi++) {
+    const char* arg = argv[argi];
+    if (0 == strcmp(arg, "-h") || 0 == strcmp(arg, "--help")) {
+      PrintUsage(argv[0]);
+      return 0;
+    } else if (0 == strncmp(arg, "--shader=", sizeof("--shader=") - 1)) {
+      options.shader_filter = arg + sizeof("--shader=") - 1;
+    } else if (0 == strncmp(arg, "--step-limit=",
+                            sizeof("--step-limit=") - 1)) {
+      if (!ParseUint32(arg + sizeof("--step-limit=") - 1,
+                       &options.step_limit)) {
+        std::fprintf(stderr, "error: invalid argument: %s\n", arg);
+        return 1;
+      }
+    } else if (arg[0] == '-') {
+      std::fprintf(stderr, "error: unknown argument: %s\n", arg);
+      return 1;
+    } else {
+      shader_files.emplace_back(arg);
+    }
+  }
+  if (shader_files.empty()) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  SpirvTools tools(kTargetEnv);
+  tools.SetMessageConsumer([](spv_message_level_t, const char*,
+                              const spv_position_t&, const char*) {});
+
+  const size_t num_strategies = sizeof(kStrategies) / sizeof(kStrategies[0]);
+  std::vector<ReductionStats> totals(num_strategies);
+  bool all_succeeded = true;
+  uint32_t num_shaders = 0;
+  std::printf("%-40s %-12s %8s %10s %10s %10s %9s\n", "shader", "strategy",
+              "tests", "removed", "final", "tests/B", "seconds");
+  for (const auto& shader_file : shader_files) {
+    if (shader_file.find(options.shader_filter) == std::string::npos) {
+      continue;
+    }
+    // Shaders that cannot be read, are invalid or lack every target opcode
+    // are skipped, so that the whole of a corpus directory can be given on
+    // the command line.
+    std::vector<uint32_t> binary;
+    if (!ReadBinaryFile<uint32_t>(shader_file.c_str(), &binary) ||
+        !tools.Validate(binary)) {
+      std::fprintf(stderr, "warning: skipping invalid shader %s\n",
+                   shader_file.c_str());
+      continue;
+    }
+    const SpvOp* target_opcode = nullptr;
+    for (const SpvOp& opcode : kTargetOpcodes) {
+      if (ContainsOpcode(binary, opcode)) {
+        target_opcode = &opcode;
+        break;
+      }
+    }
+    if (target_opcode == nullptr) {
+      continue;
+    }
+    num_shaders++;
+
+    for (size_t i = 0; i < num_strategies; i++) {
+      const ReductionStats stats = ReduceShader(
+          binary, *target_opcode, kStrategies[i].strategy, options);
+      if (!stats.succeeded) {
+        std::fprintf(stderr, "error: %s failed to reduce %s\n",
+                     kStrategies[i].name, shader_file.c_str());
+        all_succeeded = false;
+      }
+      std::printf("%-40s %-12s %8u %10zu %10zu %10.3f %9.3f\n",
+                  shader_file.c_str(), kStrategies[i].name, stats.num_tests,
+                  stats.bytes_removed, stats.final_bytes,
+                  TestsPerByte(stats.num_tests, stats.bytes_removed),
+                  stats.seconds);
+      totals[i].num_tests += stats.num_tests;
+      totals[i].bytes_removed += stats.bytes_removed;
+      totals[i].final_bytes += stats.final_bytes;
+      totals[i].seconds += stats.seconds;
+    }
+  }
+
+  std::printf("\n%u shader(s), step limit %u\n", num_shaders,
+              options.step_limit);
+  for (size_t i = 0; i < num_strategies; i++) {
+    std::printf("%-40s %-12s %8u %10zu %10zu %10.3f %9.3f\n", "total",
+                kStrategies[i].name, totals[i].num_tests,
+                totals[i].bytes_removed, totals[i].final_bytes,
+                TestsPerByte(totals[i].num_tests, totals[i].bytes_removed),
+                totals[i].seconds);
+  }
+  return all_succeeded ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace reduce
+}  // namespace spvtools
+
+int main(int argc, const char** argv) {
+  return spvtools::reduce::Run(argc, argv);
+}
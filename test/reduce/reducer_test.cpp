@@ -14,6 +14,7 @@
 
 #include "source/reduce/reducer.h"
 
+#include <cstring>
 #include <unordered_map>
 
 #include "source/opt/build_module.h"
@@ -558,6 +559,34 @@ TEST(ReducerTest, ShaderReduceWhileDivReachable) {
   ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
 }
 
+TEST(ReducerTest, ShaderReduceWhileMulReachableAdaptive) {
+  Reducer reducer(kEnv);
+
+  reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  reducer.AddDefaultReductionPasses();
+  reducer.SetReductionStrategy(Reducer::ReductionStrategy::kAdaptive);
+  reducer.SetMessageConsumer(kMessageConsumer);
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+
+  ASSERT_TRUE(
+      t.Assemble(kShaderWithLoopsDivAndMul, &binary_in, kReduceAssembleOption));
+  const size_t original_size = binary_in.size();
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+  spvtools::ValidatorOptions validator_options;
+
+  Reducer::ReductionResultStatus status = reducer.Run(
+      std::move(binary_in), &binary_out, reducer_options, validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+  ASSERT_LT(binary_out.size(), original_size);
+  ASSERT_TRUE(InterestingWhileIMulReachable(binary_out, 0));
+}
+
 // Computes an instruction count for each function in the module represented by
 // |binary|.
 std::unordered_map<uint32_t, uint32_t> GetFunctionInstructionCount(
@@ -622,6 +651,226 @@ TEST(ReducerTest, SingleFunctionReduction) {
   ASSERT_EQ(5, final_instruction_count.at(13));
 }
 
+TEST(ReducerTest, SingleFunctionReductionAdaptive) {
+  Reducer reducer(kEnv);
+
+  PingPongInteresting ping_pong_interesting(4);
+  reducer.SetInterestingnessFunction(
+      [&ping_pong_interesting](const std::vector<uint32_t>&, uint32_t) -> bool {
+        return ping_pong_interesting.IsInteresting();
+      });
+  reducer.AddDefaultReductionPasses();
+  reducer.SetReductionStrategy(Reducer::ReductionStrategy::kAdaptive);
+  reducer.SetMessageConsumer(kMessageConsumer);
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+
+  ASSERT_TRUE(t.Assemble(kShaderWithMultipleFunctions, &binary_in,
+                         kReduceAssembleOption));
+
+  auto original_instruction_count = GetFunctionInstructionCount(binary_in);
+
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+  reducer_options.set_target_function(13);
+
+  spvtools::ValidatorOptions validator_options;
+
+  Reducer::ReductionResultStatus status = reducer.Run(
+      std::move(binary_in), &binary_out, reducer_options, validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+
+  auto final_instruction_count = GetFunctionInstructionCount(binary_out);
+
+  // The adaptive strategy must reach the same fixpoint as the default one.
+  ASSERT_EQ(original_instruction_count.at(4), final_instruction_count.at(4));
+  ASSERT_EQ(original_instruction_count.at(10), final_instruction_count.at(10));
+  ASSERT_EQ(5, final_instruction_count.at(13));
+}
+
+TEST(ReducerTest, FunctionParallelReduction) {
+  Reducer reducer(kEnv);
+
+  reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  reducer.AddDefaultReductionPasses();
+  reducer.SetNumThreads(4);
+  reducer.SetMessageConsumer(kMessageConsumer);
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+
+  ASSERT_TRUE(t.Assemble(kShaderWithMultipleFunctions, &binary_in,
+                         kReduceAssembleOption));
+  const size_t original_size = binary_in.size();
+
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+  spvtools::ValidatorOptions validator_options;
+
+  Reducer::ReductionResultStatus status = reducer.Run(
+      std::move(binary_in), &binary_out, reducer_options, validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+  ASSERT_LT(binary_out.size(), original_size);
+  ASSERT_TRUE(t.Validate(binary_out));
+  ASSERT_TRUE(InterestingWhileIMulReachable(binary_out, 0));
+}
+
+TEST(ReducerTest, FunctionParallelReductionRespectsStepLimit) {
+  Reducer reducer(kEnv);
+
+  reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  reducer.AddDefaultReductionPasses();
+  reducer.SetNumThreads(4);
+  // Messages from the workers are serialized by the reducer.
+  uint32_t num_steps = 0;
+  reducer.SetMessageConsumer([&num_steps](spv_message_level_t, const char*,
+                                          const spv_position_t&,
+                                          const char* message) {
+    if (std::strstr(message, " made reduction step ") != nullptr) {
+      num_steps++;
+    }
+  });
+
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+
+  ASSERT_TRUE(t.Assemble(kShaderWithMultipleFunctions, &binary_in,
+                         kReduceAssembleOption));
+
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(6);
+  reducer_options.set_fail_on_validation_error(true);
+  spvtools::ValidatorOptions validator_options;
+
+  Reducer::ReductionResultStatus status = reducer.Run(
+      std::move(binary_in), &binary_out, reducer_options, validator_options);
+
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kReachedStepLimit);
+  // Each of the functions could be reduced in more steps than the limit
+  // allows, but the workers must share the steps between them.
+  ASSERT_LE(num_steps, 6u);
+  ASSERT_TRUE(t.Validate(binary_out));
+}
+
+TEST(ReducerTest, CheckpointAndResume) {
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+  ASSERT_TRUE(
+      t.Assemble(kShaderWithLoopsDivAndMul, &binary_in, kReduceAssembleOption));
+  spvtools::ValidatorOptions validator_options;
+
+  // Interrupt a reduction by giving it a small step limit, keeping hold of the
+  // last checkpoint.
+  std::vector<uint32_t> checkpoint;
+  {
+    Reducer reducer(kEnv);
+    reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+    reducer.AddDefaultReductionPasses();
+    reducer.SetMessageConsumer(kMessageConsumer);
+    reducer.SetCheckpointFunction(
+        [&checkpoint](const std::vector<uint32_t>& latest) {
+          checkpoint = latest;
+        },
+        1);
+
+    std::vector<uint32_t> binary_out;
+    spvtools::ReducerOptions reducer_options;
+    reducer_options.set_step_limit(10);
+    reducer_options.set_fail_on_validation_error(true);
+    Reducer::ReductionResultStatus status = reducer.Run(
+        binary_in, &binary_out, reducer_options, validator_options);
+    ASSERT_EQ(status, Reducer::ReductionResultStatus::kReachedStepLimit);
+    ASSERT_FALSE(checkpoint.empty());
+  }
+
+  // Resume the reduction with a fresh reducer.
+  Reducer reducer(kEnv);
+  reducer.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  reducer.AddDefaultReductionPasses();
+  reducer.SetMessageConsumer(kMessageConsumer);
+
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  reducer_options.set_step_limit(500);
+  reducer_options.set_fail_on_validation_error(true);
+
+  // A truncated checkpoint is rejected.
+  std::vector<uint32_t> truncated(checkpoint.begin(), checkpoint.end() - 1);
+  ASSERT_EQ(reducer.Resume(truncated, &binary_out, reducer_options,
+                           validator_options),
+            Reducer::ReductionResultStatus::kCheckpointInvalid);
+
+  Reducer::ReductionResultStatus status = reducer.Resume(
+      checkpoint, &binary_out, reducer_options, validator_options);
+  ASSERT_EQ(status, Reducer::ReductionResultStatus::kComplete);
+  ASSERT_LT(binary_out.size(), binary_in.size());
+  ASSERT_TRUE(InterestingWhileIMulReachable(binary_out, 0));
+}
+
+TEST(ReducerTest, RejectedCheckpointLeavesPassesUnchanged) {
+  std::vector<uint32_t> binary_in;
+  SpirvTools t(kEnv);
+  ASSERT_TRUE(
+      t.Assemble(kShaderWithLoopsDivAndMul, &binary_in, kReduceAssembleOption));
+  spvtools::ValidatorOptions validator_options;
+
+  // Runs |reducer| for |step_limit| steps from |binary_in|, yielding the last
+  // checkpoint it takes.
+  auto run = [&binary_in, &validator_options](
+                 Reducer* reducer,
+                 uint32_t step_limit) -> std::vector<uint32_t> {
+    std::vector<uint32_t> checkpoint;
+    reducer->SetCheckpointFunction(
+        [&checkpoint](const std::vector<uint32_t>& latest) {
+          checkpoint = latest;
+        },
+        1);
+    std::vector<uint32_t> binary_out;
+    spvtools::ReducerOptions reducer_options;
+    reducer_options.set_step_limit(step_limit);
+    reducer_options.set_fail_on_validation_error(true);
+    reducer->Run(binary_in, &binary_out, reducer_options, validator_options);
+    return checkpoint;
+  };
+
+  Reducer interrupted(kEnv);
+  interrupted.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  interrupted.AddDefaultReductionPasses();
+  interrupted.SetMessageConsumer(kMessageConsumer);
+  std::vector<uint32_t> checkpoint = run(&interrupted, 10);
+  ASSERT_FALSE(checkpoint.empty());
+
+  // The progress of every pass in this checkpoint is well formed, but the
+  // binary that follows it is not.
+  checkpoint.push_back(0);
+
+  Reducer resumed(kEnv);
+  resumed.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  resumed.AddDefaultReductionPasses();
+  resumed.SetMessageConsumer(kMessageConsumer);
+  std::vector<uint32_t> binary_out;
+  spvtools::ReducerOptions reducer_options;
+  ASSERT_EQ(resumed.Resume(checkpoint, &binary_out, reducer_options,
+                           validator_options),
+            Reducer::ReductionResultStatus::kCheckpointInvalid);
+
+  // The rejected checkpoint must not have changed the passes, so the reducer
+  // takes its first step exactly as a fresh one does.
+  Reducer fresh(kEnv);
+  fresh.SetInterestingnessFunction(InterestingWhileIMulReachable);
+  fresh.AddDefaultReductionPasses();
+  fresh.SetMessageConsumer(kMessageConsumer);
+  ASSERT_EQ(run(&resumed, 1), run(&fresh, 1));
+}
+
 }  // namespace
 }  // namespace reduce
 }  // namespace spvtools
@@ -0,0 +1,255 @@
+# Copyright (c) 2021 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import subprocess
+import tempfile
+
+import placeholder
+import expect
+
+from spirv_test_framework import inside_spirv_testsuite
+
+
+def reference_assembly():
+  return """
+         OpCapability Shader
+         OpMemoryModel Logical GLSL450
+         OpEntryPoint Fragment %4 "main"
+         OpExecutionMode %4 OriginUpperLeft
+    %2 = OpTypeVoid
+    %3 = OpTypeFunction %2
+    %6 = OpTypeInt 32 1
+    %7 = OpTypePointer Function %6
+    %9 = OpConstant %6 1
+    %4 = OpFunction %2 None %3
+    %5 = OpLabel
+    %8 = OpVariable %7 Function
+         OpStore %8 %9
+   %10 = OpLoad %6 %8
+   %11 = OpIAdd %6 %10 %9
+         OpStore %8 %11
+         OpReturn
+         OpFunctionEnd"""
+
+
+def donor_assembly():
+  return """
+         OpCapability Shader
+         OpMemoryModel Logical GLSL450
+         OpEntryPoint Fragment %4 "main"
+         OpExecutionMode %4 OriginUpperLeft
+    %2 = OpTypeVoid
+    %3 = OpTypeFunction %2
+    %6 = OpTypeFloat 32
+    %7 = OpTypeFunction %6 %6
+    %4 = OpFunction %2 None %3
+    %5 = OpLabel
+         OpReturn
+         OpFunctionEnd
+   %10 = OpFunction %6 None %7
+   %11 = OpFunctionParameter %6
+   %12 = OpLabel
+   %13 = OpFMul %6 %11 %11
+         OpReturnValue %13
+         OpFunctionEnd"""
+
+
+def assemble(testcase, source):
+  """Writes |source| to a file in the test directory and assembles it for
+    SPIR-V 1.3, the default target of spirv-fuzz.
+
+    Returns:
+        The name of the assembled file.
+    """
+  asm_fd, asm_filename = tempfile.mkstemp(
+      dir=testcase.directory, suffix='.spvasm')
+  with os.fdopen(asm_fd, 'w') as asm_file:
+    asm_file.write(source)
+  filename = '%s.spv' % asm_filename
+  cmd = [
+      testcase.test_manager.assembler_path, '--target-env', 'spv1.3',
+      asm_filename, '-o', filename
+  ]
+  process = subprocess.Popen(
+      args=cmd,
+      stdin=subprocess.PIPE,
+      stdout=subprocess.PIPE,
+      stderr=subprocess.PIPE,
+      cwd=testcase.directory)
+  output = process.communicate()
+  assert process.returncode == 0 and not output[0] and not output[1]
+  return filename
+
+
+class Spirv13Shader(placeholder.PlaceHolder):
+  """Stands for a shader assembled for SPIR-V 1.3."""
+
+  def __init__(self, source):
+    self.source = source
+    self.filename = None
+
+  def instantiate_for_spirv_args(self, testcase):
+    self.filename = assemble(testcase, self.source)
+    return self.filename
+
+  def instantiate_for_expectation(self, testcase):
+    assert self.filename is not None
+    return self.filename
+
+
+class DonorsFlag(placeholder.PlaceHolder):
+  """Stands for a --donors flag naming a file that lists one donor shader."""
+
+  def __init__(self, donor_source):
+    self.donor_source = donor_source
+    self.filename = None
+
+  def instantiate_for_spirv_args(self, testcase):
+    donor_filename = assemble(testcase, self.donor_source)
+    donors_fd, self.filename = tempfile.mkstemp(
+        dir=testcase.directory, suffix='.txt')
+    with os.fdopen(donors_fd, 'w') as donors_file:
+      donors_file.write(donor_filename + '\n')
+    return '--donors=%s' % self.filename
+
+  def instantiate_for_expectation(self, testcase):
+    assert self.filename is not None
+    return self.filename
+
+
+class ValidOutputsForSeeds(expect.ReturnCodeIsZero,
+                           expect.CorrectBinaryLengthAndPreamble):
+  """Mixin class for checking that a valid SPIR-V 1.3 binary and the
+    transformations applied to get it are written for every seed.
+
+    To mix in this class, subclasses need to provide expected_seeds as the
+    seeds the fuzzer runs with, and expected_output_prefix as the name of the
+    output binary without its extension.
+    """
+
+  def check_outputs_for_seeds(self, status):
+    for seed in self.expected_seeds:
+      prefix = '%s_%d' % (self.expected_output_prefix, seed)
+      for suffix in ['.transformations', '.transformations_json']:
+        success, message = expect.verify_file_non_empty(prefix + suffix)
+        if not success:
+          return False, message
+      binary_filename = prefix + '.spv'
+      success, message = expect.verify_file_non_empty(binary_filename)
+      if not success:
+        return False, message
+      with open(binary_filename, 'rb') as binary_file:
+        success, message = self.verify_binary_length_and_header(
+            bytes(binary_file.read()), 0x10300)
+      if not success:
+        return False, message
+    return True, ''
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestSeedsOnOneThread(ValidOutputsForSeeds):
+  """Tests that --seeds fuzzes once for every seed in the range."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=1..3'
+  ]
+  expected_seeds = range(1, 4)
+  expected_output_prefix = placeholder.TempFileName('out')
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestSeedsOnSeveralThreads(ValidOutputsForSeeds):
+  """Tests that -j fuzzes the seeds of the range on several threads, all of
+    them sharing the donors."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=10..17', '-j', '4'
+  ]
+  expected_seeds = range(10, 18)
+  expected_output_prefix = placeholder.TempFileName('out')
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestJobsFlagWithValue(ValidOutputsForSeeds):
+  """Tests the --jobs=<N> form of -j, with more jobs than seeds."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=5..6', '--jobs=8'
+  ]
+  expected_seeds = range(5, 7)
+  expected_output_prefix = placeholder.TempFileName('out')
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestReversedSeedRange(expect.ErrorMessageSubstr):
+  """Tests that a range of seeds whose first seed exceeds its last seed is
+    rejected."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=3..1'
+  ]
+  expected_error_substr = 'The --seeds argument must have the form <A>..<B>'
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestMalformedSeedRange(expect.ErrorMessageSubstr):
+  """Tests that a range of seeds without the '..' separator is rejected."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=1-3'
+  ]
+  expected_error_substr = 'The --seeds argument must have the form <A>..<B>'
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestSeedAndSeeds(expect.ErrorMessageSubstr):
+  """Tests that --seed and --seeds cannot be combined."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seed=1', '--seeds=1..2'
+  ]
+  expected_error_substr = 'The --seed and --seeds arguments are mutually ' \
+                          'exclusive.'
+
+
+@inside_spirv_testsuite('SpirvFuzzSeeds')
+class TestZeroJobs(expect.ErrorMessageSubstr):
+  """Tests that -j requires a positive number of jobs."""
+
+  shader = Spirv13Shader(reference_assembly())
+  output = placeholder.TempFileName('out.spv')
+  spirv_args = [
+      shader, '-o', output,
+      DonorsFlag(donor_assembly()), '--seeds=1..2', '-j', '0'
+  ]
+  expected_error_substr = 'The number of jobs must be a positive integer.'
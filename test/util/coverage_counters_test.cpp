@@ -0,0 +1,152 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "gmock/gmock.h"
+
+#include "source/util/coverage_counters.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(CoverageCountersTest, RegisterIsIdempotent) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t index1 = counters.Register("test.register.a");
+  const uint32_t index2 = counters.Register("test.register.b");
+  EXPECT_NE(index1, index2);
+  EXPECT_EQ(index1, counters.Register("test.register.a"));
+  EXPECT_EQ(index2, counters.Register("test.register.b"));
+  EXPECT_EQ("test.register.a", counters.GetName(index1));
+  EXPECT_EQ("test.register.b", counters.GetName(index2));
+  EXPECT_LT(index1, counters.GetNumPoints());
+  EXPECT_LT(index2, counters.GetNumPoints());
+}
+
+TEST(CoverageCountersTest, HitAndReset) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t index1 = counters.Register("test.hit.a");
+  const uint32_t index2 = counters.Register("test.hit.b");
+  counters.Reset();
+  for (uint32_t i = 0; i < 3; i++) {
+    counters.Hit(index1);
+  }
+  counters.Hit(index2);
+  EXPECT_EQ(3u, counters.GetCount(index1));
+  EXPECT_EQ(1u, counters.GetCount(index2));
+
+  auto counts = counters.GetCounts();
+  ASSERT_EQ(counters.GetNumPoints(), counts.size());
+  EXPECT_EQ(3u, counts[index1]);
+  EXPECT_EQ(1u, counts[index2]);
+
+  counters.Reset();
+  EXPECT_EQ(0u, counters.GetCount(index1));
+  EXPECT_EQ(0u, counters.GetCount(index2));
+  // Resetting the counts should not unregister the points.
+  EXPECT_EQ(index1, counters.Register("test.hit.a"));
+}
+
+TEST(CoverageCountersTest, Macros) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t static_index = counters.Register("test.macro.static");
+  const uint32_t dynamic_index = counters.Register("test.macro.dynamic.1");
+  counters.Reset();
+  CoverageRecorder recorder;
+  for (uint32_t i = 0; i < 2; i++) {
+    SPIRV_COVERAGE_POINT("test.macro.static");
+    SPIRV_COVERAGE_POINT_DYNAMIC(std::string("test.macro.dynamic.") +
+                                 std::to_string(i + 1));
+  }
+  const uint64_t expected = CoverageCounters::Enabled() ? 2 : 0;
+  EXPECT_EQ(expected, counters.GetCount(static_index));
+  EXPECT_EQ(expected / 2, counters.GetCount(dynamic_index));
+  EXPECT_EQ(CoverageCounters::Enabled(), recorder.WasHit(static_index));
+  EXPECT_EQ(CoverageCounters::Enabled(), recorder.WasHit(dynamic_index));
+}
+
+TEST(CoverageCountersTest, MacrosDoNothingWithoutRecorder) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t index = counters.Register("test.unrecorded");
+  counters.Reset();
+  uint32_t num_names_built = 0;
+  SPIRV_COVERAGE_POINT("test.unrecorded");
+  SPIRV_COVERAGE_POINT_DYNAMIC(
+      (num_names_built++, std::string("test.unrecorded")));
+  SPIRV_COVERAGE_POINT_KEYED(
+      1, 1, 0, 0, (num_names_built++, std::string("test.unrecorded")));
+  EXPECT_EQ(0u, counters.GetCount(index));
+  EXPECT_EQ(0u, num_names_built);
+}
+
+TEST(CoverageCountersTest, NestedRecorders) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t outer_index = counters.Register("test.recorder.outer");
+  const uint32_t inner_index = counters.Register("test.recorder.inner");
+  EXPECT_EQ(nullptr, CoverageRecorder::Current());
+  CoverageRecorder outer;
+  EXPECT_EQ(&outer, CoverageRecorder::Current());
+  counters.Hit(outer_index);
+  {
+    CoverageRecorder inner;
+    EXPECT_EQ(&inner, CoverageRecorder::Current());
+    counters.Hit(inner_index);
+    EXPECT_FALSE(inner.WasHit(outer_index));
+    EXPECT_TRUE(inner.WasHit(inner_index));
+  }
+  EXPECT_EQ(&outer, CoverageRecorder::Current());
+  EXPECT_TRUE(outer.WasHit(outer_index));
+  // Hits made while the inner recorder was installed are not recorded by the
+  // outer one.
+  EXPECT_FALSE(outer.WasHit(inner_index));
+  EXPECT_LE(outer_index + 1, outer.GetNumPoints());
+}
+
+TEST(CoverageCountersTest, KeyedPoints) {
+  auto& counters = CoverageCounters::Get();
+  const uint32_t cached_index = counters.Register("test.keyed.1.2");
+  const uint32_t uncached_index = counters.Register("test.keyed.5.0");
+  counters.Reset();
+  CoverageRecorder recorder;
+  uint32_t num_names_built = 0;
+  for (uint32_t i = 0; i < 3; i++) {
+    SPIRV_COVERAGE_POINT_KEYED(
+        4, 4, 1, 2, (num_names_built++, std::string("test.keyed.1.2")));
+    SPIRV_COVERAGE_POINT_KEYED(
+        4, 4, 5, 0, (num_names_built++, std::string("test.keyed.5.0")));
+  }
+  if (CoverageCounters::Enabled()) {
+    EXPECT_EQ(3u, counters.GetCount(cached_index));
+    EXPECT_EQ(3u, counters.GetCount(uncached_index));
+    // The name of the cached point is only built when it is registered, while
+    // the name of the point outside the cached range is built on every hit.
+    EXPECT_EQ(4u, num_names_built);
+  } else {
+    EXPECT_EQ(0u, num_names_built);
+  }
+
+  // A family can be used directly, regardless of how the library was built.
+  CoveragePointFamily family(2, 2);
+  const auto name = []() { return std::string("test.keyed.direct"); };
+  family.Hit(1, 1, name);
+  family.Hit(1, 1, name);
+  const uint32_t direct_index = counters.Register("test.keyed.direct");
+  EXPECT_EQ(2u, counters.GetCount(direct_index));
+  EXPECT_TRUE(recorder.WasHit(direct_index));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
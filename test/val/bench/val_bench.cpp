@@ -0,0 +1,282 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time the validator spends on modules shaped like the inputs
+// which make it slow: deeply nested selections, huge switches, long chains of
+// blocks using the same value, and structs nested in several members.
+//
+// Each module is validated without work limits, then with every work limit
+// set, so that the cost of the slow checks and the bound put on them by the
+// limits can be compared.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "source/diagnostic.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+const spv_target_env kTargetEnv = SPV_ENV_UNIVERSAL_1_3;
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkOptions {
+  // The number of times each module is validated.
+  uint32_t rounds = 3;
+  // The value of every work limit for the bounded validation.
+  uint32_t limit = 100000;
+  // Only cases whose name contains this string are run.
+  std::string case_filter;
+};
+
+// A family of modules which are slow to validate, generated at a given size.
+struct BenchmarkCase {
+  const char* name;
+  uint32_t size;
+  std::function<std::string(uint32_t)> generate;
+};
+
+const char kHeader[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%true = OpConstantTrue %bool
+%int = OpTypeInt 32 0
+%zero = OpConstant %int 0
+)";
+
+// Selections nested |depth| times, whose merge blocks branch to each other.
+std::string GenerateNestedSelections(uint32_t depth) {
+  std::ostringstream spirv;
+  spirv << kHeader << "%main = OpFunction %void None %fn\n"
+        << "%entry = OpLabel\nOpBranch %header0\n";
+  for (uint32_t i = 0; i < depth; ++i) {
+    spirv << "%header" << i << " = OpLabel\n"
+          << "OpSelectionMerge %merge" << i << " None\n"
+          << "OpBranchConditional %true %header" << i + 1 << " %merge" << i
+          << "\n";
+  }
+  spirv << "%header" << depth << " = OpLabel\nOpBranch %merge" << depth - 1
+        << "\n";
+  for (uint32_t i = depth; i-- > 0;) {
+    spirv << "%merge" << i << " = OpLabel\n";
+    if (i > 0) {
+      spirv << "OpBranch %merge" << i - 1 << "\n";
+    } else {
+      spirv << "OpReturn\n";
+    }
+  }
+  spirv << "OpFunctionEnd\n";
+  return spirv.str();
+}
+
+// A switch with |num_cases| case constructs.
+std::string GenerateSwitch(uint32_t num_cases) {
+  std::ostringstream spirv;
+  spirv << kHeader << "%main = OpFunction %void None %fn\n"
+        << "%entry = OpLabel\nOpSelectionMerge %merge None\n"
+        << "OpSwitch %zero %merge";
+  for (uint32_t i = 0; i < num_cases; ++i) {
+    spirv << " " << i << " %case" << i;
+  }
+  spirv << "\n";
+  for (uint32_t i = 0; i < num_cases; ++i) {
+    spirv << "%case" << i << " = OpLabel\nOpBranch %merge\n";
+  }
+  spirv << "%merge = OpLabel\nOpReturn\nOpFunctionEnd\n";
+  return spirv.str();
+}
+
+// A chain of |num_blocks| blocks, each using a value defined in the entry
+// block.  Each use walks the dominator tree up to the entry block.
+std::string GenerateBlockChain(uint32_t num_blocks) {
+  std::ostringstream spirv;
+  spirv << kHeader << "%main = OpFunction %void None %fn\n"
+        << "%entry = OpLabel\n%value = OpIAdd %int %zero %zero\n"
+        << "OpBranch %block0\n";
+  for (uint32_t i = 0; i < num_blocks; ++i) {
+    spirv << "%block" << i << " = OpLabel\n"
+          << "%use" << i << " = OpIAdd %int %value %value\n"
+          << "OpBranch %block" << i + 1 << "\n";
+  }
+  spirv << "%block" << num_blocks << " = OpLabel\nOpReturn\nOpFunctionEnd\n";
+  return spirv.str();
+}
+
+// A load of a struct made of two copies of a struct, nested |depth| times.
+// Walking its members visits 2^|depth| types.
+std::string GenerateNestedStructs(uint32_t depth) {
+  std::ostringstream spirv;
+  spirv << kHeader << "%struct0 = OpTypeStruct %int %int\n";
+  for (uint32_t i = 1; i <= depth; ++i) {
+    spirv << "%struct" << i << " = OpTypeStruct %struct" << i - 1
+          << " %struct" << i - 1 << "\n";
+  }
+  spirv << "%ptr = OpTypePointer Private %struct" << depth << "\n"
+        << "%var = OpVariable %ptr Private\n"
+        << "%main = OpFunction %void None %fn\n%entry = OpLabel\n"
+        << "%load = OpLoad %struct" << depth << " %var\n"
+        << "OpReturn\nOpFunctionEnd\n";
+  return spirv.str();
+}
+
+std::vector<BenchmarkCase> GetBenchmarkCases() {
+  return {{"nested-selections", 1000, GenerateNestedSelections},
+          {"switch", 16383, GenerateSwitch},
+          {"block-chain", 20000, GenerateBlockChain},
+          {"nested-structs", 20, GenerateNestedStructs}};
+}
+
+// Validates |binary| |rounds| times.  Returns the result of the last
+// validation and sets |milliseconds| to the average time of a validation.
+spv_result_t TimeValidation(spv_const_context context,
+                            const std::vector<uint32_t>& binary,
+                            const ValidatorOptions& options, uint32_t rounds,
+                            double* milliseconds) {
+  spv_const_binary_t module = {binary.data(), binary.size()};
+  spv_result_t result = SPV_SUCCESS;
+  const auto start = Clock::now();
+  for (uint32_t round = 0; round < rounds; ++round) {
+    result = spvValidateWithOptions(context, options, &module, nullptr);
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+      Clock::now() - start;
+  *milliseconds = elapsed.count() / rounds;
+  return result;
+}
+
+void PrintUsage(const char* program) {
+  std::printf(
+      R"(%s - Measures the time spirv-val spends on modules which are slow to
+validate, with and without work limits.
+
+USAGE: %s [options]
+
+Each module is validated without work limits, then with every work limit set.
+The report gives the size of each module, and the average time and the result
+of both validations.
+
+Options (in lexicographical order):
+  --case=<substring>
+               Only run the cases whose name contains <substring>.
+  -h, --help
+               Print this help.
+  --limit=<n>
+               The value of every work limit.  Defaults to 100000.
+  --rounds=<n>
+               Validate each module <n> times.  Defaults to 3.
+)",
+      program, program);
+}
+
+bool ParseUint32(const char* arg, uint32_t* value) {
+  char* end = nullptr;
+  const unsigned long parsed = std::strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || parsed > UINT32_MAX) {
+    return false;
+  }
+  *value = static_cast<uint32_t>(parsed);
+  return true;
+}
+
+int Run(int argc, const char** argv) {
+  BenchmarkOptions options;
+  for (int argi = 1; argi < argc; argi++) {
+    const char* arg = argv[argi];
+    if (0 == strcmp(arg, "-h") || 0 == strcmp(arg, "--help")) {
+      PrintUsage(argv[0]);
+      return 0;
+    } else if (0 == strncmp(arg, "--case=", sizeof("--case=") - 1)) {
+      options.case_filter = arg + sizeof("--case=") - 1;
+    } else if (0 == strncmp(arg, "--limit=", sizeof("--limit=") - 1)) {
+      if (!ParseUint32(arg + sizeof("--limit=") - 1, &options.limit)) {
+        std::fprintf(stderr, "error: invalid argument: %s\n", arg);
+        return 1;
+      }
+    } else if (0 == strncmp(arg, "--rounds=", sizeof("--rounds=") - 1)) {
+      if (!ParseUint32(arg + sizeof("--rounds=") - 1, &options.rounds) ||
+          options.rounds == 0) {
+        std::fprintf(stderr, "error: invalid argument: %s\n", arg);
+        return 1;
+      }
+    } else {
+      std::fprintf(stderr, "error: unknown argument: %s\n", arg);
+      return 1;
+    }
+  }
+
+  SpirvTools tools(kTargetEnv);
+  tools.SetMessageConsumer([](spv_message_level_t, const char*,
+                              const spv_position_t&, const char*) {});
+  spv_context context = spvContextCreate(kTargetEnv);
+
+  ValidatorOptions unbounded;
+  ValidatorOptions bounded;
+  bounded.SetWorkLimit(spv_validator_work_limit_max_cfg_edges, options.limit);
+  bounded.SetWorkLimit(spv_validator_work_limit_max_dominance_queries,
+                       options.limit);
+  bounded.SetWorkLimit(spv_validator_work_limit_max_type_traversal,
+                       options.limit);
+
+  bool all_succeeded = true;
+  std::printf("%-20s %8s %14s %-26s %14s %-26s\n", "case", "size",
+              "unbounded(ms)", "result", "bounded(ms)", "result");
+  for (const auto& benchmark_case : GetBenchmarkCases()) {
+    if (std::string(benchmark_case.name).find(options.case_filter) ==
+        std::string::npos) {
+      continue;
+    }
+    std::vector<uint32_t> binary;
+    if (!tools.Assemble(benchmark_case.generate(benchmark_case.size),
+                        &binary)) {
+      std::fprintf(stderr, "error: failed to assemble case %s\n",
+                   benchmark_case.name);
+      all_succeeded = false;
+      continue;
+    }
+    double unbounded_ms = 0;
+    double bounded_ms = 0;
+    const auto unbounded_result = TimeValidation(
+        context, binary, unbounded, options.rounds, &unbounded_ms);
+    const auto bounded_result =
+        TimeValidation(context, binary, bounded, options.rounds, &bounded_ms);
+    std::printf("%-20s %8u %14.3f %-26s %14.3f %-26s\n", benchmark_case.name,
+                benchmark_case.size, unbounded_ms,
+                spvResultToString(unbounded_result).c_str(), bounded_ms,
+                spvResultToString(bounded_result).c_str());
+  }
+  spvContextDestroy(context);
+  return all_succeeded ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
+
+int main(int argc, const char** argv) {
+  return spvtools::val::Run(argc, argv);
+}
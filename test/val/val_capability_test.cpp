@@ -2977,6 +2977,70 @@ TEST_F(ValidateCapability, CapShaderLayerSucceedsInNewSpirvVersion) {
   EXPECT_THAT(getDiagnosticString(), Eq(""));
 }
 
+TEST_F(ValidateCapability, RepeatedOperandRecheckedAfterCapabilitySection) {
+  // The capability section declares Shader, which enables Flat.  Flat is
+  // then used twice, and Sample, which needs SampleRateShading, is used
+  // after it.  Only satisfied requirements may be remembered.
+  const std::string spirv = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main" %in1 %in2 %in3
+OpExecutionMode %main OriginUpperLeft
+OpDecorate %in1 Flat
+OpDecorate %in2 Flat
+OpDecorate %in3 Sample
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%ptr = OpTypePointer Input %float
+%in1 = OpVariable %ptr Input
+%in2 = OpVariable %ptr Input
+%in3 = OpVariable %ptr Input
+%main = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_CAPABILITY, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Operand 2 of Decorate requires one of these "
+                        "capabilities: SampleRateShading"));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("OpDecorate %in3 Sample"));
+}
+
+TEST_F(ValidateCapability, FailedOperandRequirementIsNotRemembered) {
+  // Both loads use Volatile, which is remembered as satisfied after the
+  // first load.  The second load also uses Nontemporal, which needs SPIR-V
+  // 1.4, and must still be rejected in SPIR-V 1.0.
+  const std::string spirv = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%ptr = OpTypePointer Function %float
+%func = OpFunction %void None %fn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+%first = OpLoad %float %var Volatile
+%second = OpLoad %float %var Volatile|Nontemporal
+OpReturn
+OpFunctionEnd
+)";
+  CompileSuccessfully(spirv, SPV_ENV_UNIVERSAL_1_4);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_UNIVERSAL_1_4));
+
+  CompileSuccessfully(spirv, SPV_ENV_UNIVERSAL_1_0);
+  EXPECT_EQ(SPV_ERROR_WRONG_VERSION,
+            ValidateInstructions(SPV_ENV_UNIVERSAL_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("operand Nontemporal(16384) requires SPIR-V version "
+                        "1.4 or later"));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("%second = OpLoad"));
+}
+
 }  // namespace
 }  // namespace val
 }  // namespace spvtools
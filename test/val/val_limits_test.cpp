@@ -777,6 +777,140 @@ TEST_F(ValidateLimits, ControlFlowNoEntryToLoopGood) {
   EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
 }
 
+// Returns a function whose entry block branches to |num_cases| case blocks
+// through an OpSwitch.
+std::string GenerateSwitch(int num_cases) {
+  std::ostringstream spirv;
+  spirv << header << R"(
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeInt 32 0
+%4 = OpConstant %3 1234
+%5 = OpFunction %1 None %2
+%7 = OpLabel
+     OpSelectionMerge %10 None
+     OpSwitch %4 %10)";
+  for (int i = 0; i < num_cases; ++i) {
+    spirv << " " << i << " %case" << i;
+  }
+  spirv << "\n";
+  for (int i = 0; i < num_cases; ++i) {
+    spirv << "%case" << i << " = OpLabel\nOpBranch %10\n";
+  }
+  spirv << R"(
+%10 = OpLabel
+OpReturn
+OpFunctionEnd
+  )";
+  return spirv.str();
+}
+
+TEST_F(ValidateLimits, CfgEdgesUnboundedByDefault) {
+  CompileSuccessfully(GenerateSwitch(100));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateLimits, CfgEdgesWithinWorkLimit) {
+  spvValidatorOptionsSetWorkLimit(
+      options_, spv_validator_work_limit_max_cfg_edges, 100u);
+  CompileSuccessfully(GenerateSwitch(10));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateLimits, CfgEdgesExceedWorkLimit) {
+  spvValidatorOptionsSetWorkLimit(
+      options_, spv_validator_work_limit_max_cfg_edges, 10u);
+  CompileSuccessfully(GenerateSwitch(10));
+  EXPECT_EQ(SPV_ERROR_WORK_LIMIT, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Validation stopped after exceeding the limit of 10 "
+                        "CFG edges."));
+}
+
+// Returns a function made of a chain of |num_blocks| blocks, each using a value
+// defined in the entry block.
+std::string GenerateBlockChain(int num_blocks) {
+  std::ostringstream spirv;
+  spirv << header << R"(
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeInt 32 0
+%4 = OpConstant %3 1234
+%5 = OpFunction %1 None %2
+%7 = OpLabel
+%8 = OpIAdd %3 %4 %4
+     OpBranch %block0
+)";
+  for (int i = 0; i < num_blocks; ++i) {
+    spirv << "%block" << i << " = OpLabel\n"
+          << "%use" << i << " = OpIAdd %3 %8 %8\n"
+          << "OpBranch %block" << i + 1 << "\n";
+  }
+  spirv << "%block" << num_blocks << R"( = OpLabel
+OpReturn
+OpFunctionEnd
+  )";
+  return spirv.str();
+}
+
+TEST_F(ValidateLimits, DominanceQueriesWithinWorkLimit) {
+  spvValidatorOptionsSetWorkLimit(
+      options_, spv_validator_work_limit_max_dominance_queries, 100u);
+  CompileSuccessfully(GenerateBlockChain(10));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateLimits, DominanceQueriesExceedWorkLimit) {
+  spvValidatorOptionsSetWorkLimit(
+      options_, spv_validator_work_limit_max_dominance_queries, 5u);
+  CompileSuccessfully(GenerateBlockChain(10));
+  EXPECT_EQ(SPV_ERROR_WORK_LIMIT, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Validation stopped after exceeding the limit of 5 "
+                        "dominance queries."));
+}
+
+// Returns a module loading a struct made of two copies of a struct, nested
+// |depth| times.
+std::string GenerateNestedStructs(int depth) {
+  std::ostringstream spirv;
+  spirv << header << R"(
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeInt 32 0
+%struct0 = OpTypeStruct %3 %3
+)";
+  for (int i = 1; i <= depth; ++i) {
+    spirv << "%struct" << i << " = OpTypeStruct %struct" << i - 1
+          << " %struct" << i - 1 << "\n";
+  }
+  spirv << "%ptr = OpTypePointer Private %struct" << depth << R"(
+%var = OpVariable %ptr Private
+%5 = OpFunction %1 None %2
+%7 = OpLabel
+%8 = OpLoad %struct)"
+        << depth << R"( %var
+OpReturn
+OpFunctionEnd
+  )";
+  return spirv.str();
+}
+
+TEST_F(ValidateLimits, TypeTraversalUnboundedByDefault) {
+  CompileSuccessfully(GenerateNestedStructs(8));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateLimits, TypeTraversalExceedsWorkLimit) {
+  spvValidatorOptionsSetWorkLimit(
+      options_, spv_validator_work_limit_max_type_traversal, 100u);
+  CompileSuccessfully(GenerateNestedStructs(8));
+  EXPECT_EQ(SPV_ERROR_WORK_LIMIT, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Validation stopped after exceeding the limit of 100 "
+                        "types traversed."));
+}
+
 }  // namespace
 }  // namespace val
 }  // namespace spvtools
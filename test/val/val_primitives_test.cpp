@@ -126,6 +126,27 @@ TEST_F(ValidatePrimitives, EmitVertexFailWrongExecutionModeNestedFunction) {
       HasSubstr("EmitVertex instructions require Geometry execution model"));
 }
 
+TEST_F(ValidatePrimitives, RepeatedWrongExecutionModelReportedOnce) {
+  const std::string body = R"(
+OpEmitVertex
+OpEndPrimitive
+OpEmitVertex
+OpEndPrimitive
+)";
+  CompileSuccessfully(
+      GenerateShaderCode(body, "OpCapability Geometry", "Vertex"));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  const std::string diagnostic = getDiagnosticString();
+  const std::string emit_vertex_message =
+      "EmitVertex instructions require Geometry execution model";
+  const auto first = diagnostic.find(emit_vertex_message);
+  ASSERT_NE(std::string::npos, first);
+  EXPECT_EQ(std::string::npos, diagnostic.find(emit_vertex_message, first + 1));
+  EXPECT_THAT(
+      diagnostic,
+      HasSubstr("EndPrimitive instructions require Geometry execution model"));
+}
+
 // OpEndPrimitive doesn't have any parameters, so other validation
 // is handled by the binary parser, and generic dominance checks.
 TEST_F(ValidatePrimitives, EndPrimitiveSuccess) {
@@ -0,0 +1,228 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the validator profiles.
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "test/unit_spirv.h"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+using ValidateProfile = spvtest::ValidateBase<bool>;
+
+std::string GenerateShaderCode(const std::string& decorations,
+                               const std::string& body) {
+  return R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+)" + decorations +
+         R"(
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%v2float = OpTypeVector %float 2
+%int_1 = OpConstant %int 1
+%float_1 = OpConstant %float 1
+%true = OpConstantTrue %bool
+%main = OpFunction %void None %fn
+%entry = OpLabel
+)" + body +
+         R"(
+OpReturn
+OpFunctionEnd
+)";
+}
+
+TEST_F(ValidateProfile, StructuralSkipsInstructionChecks) {
+  const std::string body = "%sum = OpIAdd %float %int_1 %int_1";
+
+  CompileSuccessfully(GenerateShaderCode("", body));
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Expected int scalar or vector type as Result Type"));
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(GenerateShaderCode("", body));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateProfile, StructuralSkipsDecorationChecks) {
+  const std::string spirv = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+OpDecorate %func LinkageAttributes "func" Import
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%func = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("may not be decorated with Import Linkage type"));
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateProfile, StructuralChecksUndefinedIds) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(
+      GenerateShaderCode("", "%sum = OpIAdd %int %int_1 %undefined"));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("has not been defined"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksDominance) {
+  const std::string body = R"(
+OpSelectionMerge %merge None
+OpBranchConditional %true %left %right
+%left = OpLabel
+%value = OpIAdd %int %int_1 %int_1
+OpBranch %merge
+%right = OpLabel
+OpBranch %merge
+%merge = OpLabel
+%use = OpIAdd %int %value %int_1
+)";
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(GenerateShaderCode("", body));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("does not dominate its use"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksLogicalLayout) {
+  const std::string spirv = R"(
+OpMemoryModel Logical GLSL450
+OpCapability Shader
+)";
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_LAYOUT, ValidateInstructions());
+}
+
+TEST_F(ValidateProfile, StructuralChecksBranchTargets) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(
+      GenerateShaderCode("", "OpBranch %int_1\n%next = OpLabel"));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("must be the ID of an OpLabel instruction"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksEntryPoints) {
+  const std::string spirv = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %int_1 "main"
+%int = OpTypeInt 32 1
+%int_1 = OpConstant %int 1
+)";
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("is not a function"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksExecutionModes) {
+  const std::string spirv = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %other OriginUpperLeft
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%main = OpFunction %void None %fn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+%other = OpFunction %void None %fn
+%other_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("is not the Entry Point operand of an OpEntryPoint"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksCompositeIndices) {
+  const std::string body = R"(
+%vec = OpCompositeConstruct %v2float %float_1 %float_1
+%elem = OpCompositeExtract %float %vec 2
+)";
+
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(GenerateShaderCode("", body));
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Vector access is out of bounds"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksLoads) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                SPV_VAL_PROFILE_STRUCTURAL);
+  CompileSuccessfully(GenerateShaderCode("", "%value = OpLoad %int %int_1"));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("is not a logical pointer"));
+}
+
+TEST_F(ValidateProfile, FullIsTheDefault) {
+  const std::string body = "%sum = OpIAdd %float %int_1 %int_1";
+
+  // Options which were never given a profile run all the checks.
+  spv_validator_options options = spvValidatorOptionsCreate();
+  spvtest::ScopedContext context;
+  CompileSuccessfully(GenerateShaderCode("", body));
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA,
+            spvValidateWithOptions(context.context, options,
+                                   get_const_binary(), nullptr));
+  spvValidatorOptionsDestroy(options);
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -167,6 +167,28 @@ TEST_F(ValidateTypeUnique, duplicate_vfunc) {
               HasSubstr(GetErrorString(SpvOpTypeFunction)));
 }
 
+TEST_F(ValidateTypeUnique, distinct_function_parameters) {
+  std::string str = GetHeader() + R"(
+%func1t = OpTypeFunction %voidt %floatt %intt
+%func2t = OpTypeFunction %voidt %intt %floatt
+%func3t = OpTypeFunction %voidt %floatt
+%func4t = OpTypeFunction %voidt %floatt %intt %intt
+)" + GetBody();
+  CompileSuccessfully(str.c_str());
+  ASSERT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_F(ValidateTypeUnique, duplicate_function_parameters) {
+  std::string str = GetHeader() + R"(
+%func1t = OpTypeFunction %voidt %floatt %intt
+%func2t = OpTypeFunction %voidt %floatt %intt
+)" + GetBody();
+  CompileSuccessfully(str.c_str());
+  ASSERT_EQ(kDuplicateTypeError, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr(GetErrorString(SpvOpTypeFunction)));
+}
+
 TEST_F(ValidateTypeUnique, duplicate_pipe_storage) {
   std::string str = R"(
 OpCapability Addresses
@@ -141,6 +141,106 @@ TEST_F(ValidationStateTest, CheckNumGlobalVars) {
   EXPECT_EQ(unsigned(2), vstate_->num_global_vars());
 }
 
+// Tests that the uses of each id in ValidationState are correct.
+TEST_F(ValidationStateTest, CheckIdUses) {
+  std::string spirv = std::string(kHeader) + R"(
+     %int = OpTypeInt 32 0
+%_ptr_int = OpTypePointer Input %int
+   %var_1 = OpVariable %_ptr_int Input
+   %var_2 = OpVariable %_ptr_int Input
+  )";
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  EXPECT_EQ(size_t(16), vstate_->num_operands());
+  EXPECT_EQ(size_t(3), vstate_->num_id_uses());
+
+  const auto int_uses = vstate_->FindDef(1)->uses();
+  ASSERT_EQ(size_t(1), int_uses.size());
+  EXPECT_EQ(SpvOpTypePointer, int_uses[0].first->opcode());
+  EXPECT_EQ(3u, int_uses[0].second);
+
+  const auto ptr_uses = vstate_->FindDef(2)->uses();
+  ASSERT_EQ(size_t(2), ptr_uses.size());
+  EXPECT_EQ(3u, ptr_uses[0].first->id());
+  EXPECT_EQ(4u, ptr_uses[1].first->id());
+  EXPECT_EQ(1u, ptr_uses[0].second);
+  EXPECT_EQ(1u, ptr_uses[1].second);
+
+  EXPECT_TRUE(vstate_->FindDef(3)->uses().empty());
+}
+
+// Tests that the instructions of a module in the other endianness refer to
+// host endian words.
+TEST_F(ValidationStateTest, CheckOtherEndianWords) {
+  std::string spirv = std::string(kHeader) + R"(
+     %int = OpTypeInt 32 0
+%_ptr_int = OpTypePointer Input %int
+  )";
+  CompileSuccessfully(spirv);
+  for (size_t i = 0; i < get_const_binary()->wordCount; ++i) {
+    const uint32_t word = get_const_binary()->code[i];
+    OverwriteAssembledBinary(
+        static_cast<uint32_t>(i),
+        (word >> 24) | ((word >> 8) & 0xff00) | ((word << 8) & 0xff0000) |
+            (word << 24));
+  }
+  EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  EXPECT_EQ(uint32_t(SpvMagicNumber), vstate_->words()[0]);
+  EXPECT_EQ(uint32_t(SpvStorageClassInput), vstate_->FindDef(2)->word(2));
+  EXPECT_EQ(size_t(1), vstate_->FindDef(1)->uses().size());
+}
+
+// Returns a module with a layout error in its 5th instruction, and an invalid
+// opcode in its last instruction.
+std::string GetModuleWithLayoutError() {
+  return std::string(kHeader) + R"(
+     %int = OpTypeInt 32 0
+            OpCapability Int64
+    %void = OpTypeVoid
+   %float = OpTypeFloat 32
+  )";
+}
+
+// Tests that the checks run once the whole module is parsed by default.
+TEST_F(ValidationStateTest, CheckAfterParsing) {
+  CompileSuccessfully(GetModuleWithLayoutError());
+  const uint32_t last_inst = get_const_binary()->wordCount - 3;
+  OverwriteAssembledBinary(last_inst, (3 << 16) | 0xffff);
+  EXPECT_EQ(SPV_ERROR_INVALID_BINARY, ValidateAndRetrieveValidationState());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("Invalid opcode: 65535"));
+}
+
+// Tests that streaming validation stops parsing at the first error.
+TEST_F(ValidationStateTest, CheckWhileStreaming) {
+  spvValidatorOptionsSetStreaming(getValidatorOptions(), true);
+  CompileSuccessfully(GetModuleWithLayoutError());
+  const uint32_t last_inst = get_const_binary()->wordCount - 3;
+  OverwriteAssembledBinary(last_inst, (3 << 16) | 0xffff);
+  EXPECT_EQ(SPV_ERROR_INVALID_LAYOUT, ValidateAndRetrieveValidationState());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Capability is in an invalid layout section"));
+  EXPECT_EQ(size_t(5), vstate_->ordered_instructions().size());
+}
+
+// Tests that streaming validation accepts valid modules.
+TEST_F(ValidationStateTest, CheckValidModuleWhileStreaming) {
+  spvValidatorOptionsSetStreaming(getValidatorOptions(), true);
+  std::string spirv = std::string(kHeader) + kVoidFVoid;
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  EXPECT_EQ(size_t(9), vstate_->ordered_instructions().size());
+}
+
+// Tests that streaming validation registers the extensions declared after a
+// capability before checking the capability.
+TEST_F(ValidationStateTest, CheckCapabilityEnabledByExtensionWhileStreaming) {
+  spvValidatorOptionsSetStreaming(getValidatorOptions(), true);
+  std::string spirv = std::string(kVulkanMemoryHeader) + kNonRecursiveBody;
+  CompileSuccessfully(spirv, SPV_ENV_VULKAN_1_1);
+  EXPECT_EQ(SPV_SUCCESS,
+            ValidateAndRetrieveValidationState(SPV_ENV_VULKAN_1_1));
+}
+
 // Tests that the number of local variables in ValidationState is correct.
 TEST_F(ValidationStateTest, CheckNumLocalVars) {
   std::string spirv = std::string(kHeader) + R"(
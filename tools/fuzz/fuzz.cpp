@@ -12,15 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "source/fuzz/compact_transformation_sequence.h"
 #include "source/fuzz/force_render_red.h"
 #include "source/fuzz/fuzzer.h"
 #include "source/fuzz/fuzzer_util.h"
@@ -61,13 +69,17 @@ bool ExecuteCommand(const std::string& command) {
 
 // Status and actions to perform after parsing command-line arguments.
 enum class FuzzActions {
+  CONVERT_TRANSFORMATIONS,  // Convert a sequence of transformations from one
+                            // format to another.
   FORCE_RENDER_RED,  // Turn the shader into a form such that it is guaranteed
                      // to render a red image.
-  FUZZ,    // Run the fuzzer to apply transformations in a randomized fashion.
-  REPLAY,  // Replay an existing sequence of transformations.
-  SHRINK,  // Shrink an existing sequence of transformations with respect to an
-           // interestingness function.
-  STOP     // Do nothing.
+  FUZZ,        // Run the fuzzer to apply transformations in a randomized
+               // fashion.
+  FUZZ_SEEDS,  // Run the fuzzer once for every seed in a range of seeds.
+  REPLAY,      // Replay an existing sequence of transformations.
+  SHRINK,      // Shrink an existing sequence of transformations with respect to
+               // an interestingness function.
+  STOP         // Do nothing.
 };
 
 struct FuzzStatus {
@@ -82,15 +94,31 @@ void PrintUsage(const char* program) {
 
 USAGE: %s [options] <input.spv> -o <output.spv> \
   --donors=<donors.txt>
+USAGE: %s [options] <input.spv> -o <output.spv> \
+  --donors=<donors.txt> --seeds=<A>..<B> [-j <N>]
 USAGE: %s [options] <input.spv> -o <output.spv> \
   --shrink=<input.transformations> -- <interestingness_test> [args...]
+USAGE: %s --convert-transformations=<input.transformations> \
+  -o <output.transformations>
 
 The SPIR-V binary is read from <input.spv>.  If <input.facts> is also present,
 facts about the SPIR-V binary are read from this file.
 
 The transformed SPIR-V binary is written to <output.spv>.  Human-readable and
 binary representations of the transformations that were applied are written to
-<output.transformations_json> and <output.transformations>, respectively.
+<output.transformations_json> and <output.transformations>, respectively.  With
+--compact-transformations, the transformations are instead written only to
+<output.transformations_compact>, in a compact form that can be replayed
+without reading the whole file.
+
+Transformation files given to --replay, --shrink and --convert-transformations
+may be in the binary, JSON or compact form; the form is detected
+automatically.
+
+When passing --seeds=<A>..<B> the fuzzer is run once for each seed from A to B
+inclusive, and the outputs for seed S are written to <output_S.spv>,
+<output_S.transformations_json> and <output_S.transformations>.  The input
+binary, its facts and the donors are read and validated only once.
 
 When passing --shrink=<input.transformations> an <interestingness_test>
 must also be provided; this is the path to a script that returns 0 if and only
@@ -106,6 +134,27 @@ Options (in lexicographical order):
 
   -h, --help
                Print this help.
+  -j <N>, --jobs=<N>
+               Positive 32-bit integer specifying the number of threads to use.
+               When fuzzing with --seeds, up to N seeds are fuzzed
+               concurrently.  When shrinking, up to N chunk removal attempts
+               are replayed and checked for interestingness concurrently, so
+               the interestingness test must tolerate being run concurrently
+               on different files.  The earliest interesting attempt is
+               accepted, so the result does not depend on N, except that every
+               attempt counts towards --shrinker-step-limit.  Defaults to 1.
+               Ignored unless --seeds or --shrink is used.
+  --compact-transformations
+               Write the transformations that were applied in compact form to
+               <output.transformations_compact>, instead of writing them in
+               binary and JSON forms.  This is much smaller and faster to read
+               back than the JSON form for long transformation sequences.
+  --convert-transformations=
+               File from which to read a sequence of transformations, which is
+               then written to the file given by -o without fuzzing.  No input
+               SPIR-V binary is needed.  The output is written in JSON form if
+               the output file name ends with "json", in compact form if it
+               ends with "compact", and in binary form otherwise.
   --donors=
                File specifying a series of donor files, one per line.  Must be
                provided if the tool is invoked in fuzzing mode; incompatible
@@ -132,6 +181,13 @@ Options (in lexicographical order):
                Useful for debugging spirv-fuzz.
   --repeated-pass-strategy=
                Available strategies are:
+               - coverage: each time a fuzzer pass is requested, this strategy
+                 either provides one at random from the set of enabled passes,
+                 or favours passes whose earlier applications led the
+                 optimizer and validator to hit code they had not hit before.
+                 This requires SPIRV-Tools to be built with
+                 SPIRV_ENABLE_COVERAGE_COUNTERS; otherwise it behaves like
+                 'simple'.
                - looped (the default): a sequence of fuzzer passes is chosen at
                  the start of fuzzing, via randomly choosing enabled passes, and
                  augmenting these choices with fuzzer passes that it is
@@ -158,7 +214,8 @@ Options (in lexicographical order):
                a negative value -N, all but the final N transformations will be
                applied during replay.  If set to 0 (the default), all
                transformations will be applied during replay.  Ignored unless
-               --replay is used.
+               --replay is used.  When replaying from a file in compact form,
+               transformations outside the range are not read.
   --replay-validation
                Run the validator after applying each transformation during
                replay (including the replay that occurs during shrinking).
@@ -167,6 +224,11 @@ Options (in lexicographical order):
   --seed=
                Unsigned 32-bit integer seed to control random number
                generation.
+  --seeds=<A>..<B>
+               Unsigned 32-bit integers A <= B.  Runs the fuzzer once for each
+               seed in the inclusive range [A, B], writing separate outputs
+               for each seed.  Incompatible with --seed, and with replay and
+               shrink modes.
   --shrink=
                File from which to read a sequence of transformations to shrink
                (instead of fuzzing)
@@ -191,7 +253,7 @@ Supported validator options are as follows. See `spirv-val --help` for details.
   --scalar-block-layout
   --skip-block-layout
 )",
-      program, program, program, program);
+      program, program, program, program, program, program);
 }
 
 // Message consumer for this tool.  Used to emit diagnostics during
@@ -205,19 +267,49 @@ void FuzzDiagnostic(spv_message_level_t level, const char* /*source*/,
   fprintf(stderr, "%s\n", message);
 }
 
+// Parses |range|, which should have the form "A..B" where A and B are unsigned
+// 32-bit integers with A <= B, into |first_seed| and |last_seed|.  Returns
+// false if |range| is malformed.
+bool ParseSeedRange(const std::string& range, uint32_t* first_seed,
+                    uint32_t* last_seed) {
+  const auto separator = range.find("..");
+  if (separator == std::string::npos) {
+    return false;
+  }
+  const std::string bounds[2] = {range.substr(0, separator),
+                                 range.substr(separator + 2)};
+  uint32_t* results[2] = {first_seed, last_seed};
+  for (uint32_t i = 0; i < 2; i++) {
+    if (bounds[i].empty() || bounds[i][0] == '-') {
+      return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const auto value = strtoull(bounds[i].c_str(), &end, 10);
+    if (*end != '\0' || errno != 0 || value > UINT32_MAX) {
+      return false;
+    }
+    *results[i] = static_cast<uint32_t>(value);
+  }
+  return *first_seed <= *last_seed;
+}
+
 FuzzStatus ParseFlags(
     int argc, const char** argv, std::string* in_binary_file,
     std::string* out_binary_file, std::string* donors_file,
     std::string* replay_transformations_file,
     std::vector<std::string>* interestingness_test,
     std::string* shrink_transformations_file,
-    std::string* shrink_temp_file_prefix,
+    std::string* shrink_temp_file_prefix, uint32_t* num_jobs,
+    uint32_t* first_seed, uint32_t* last_seed,
+    std::string* convert_transformations_file, bool* compact_transformations,
     spvtools::fuzz::RepeatedPassStrategy* repeated_pass_strategy,
     FuzzingTarget* fuzzing_target, spvtools::FuzzerOptions* fuzzer_options,
     spvtools::ValidatorOptions* validator_options) {
   uint32_t positional_arg_index = 0;
   bool only_positional_arguments_remain = false;
   bool force_render_red = false;
+  bool seed_range_given = false;
 
   *repeated_pass_strategy =
       spvtools::fuzz::RepeatedPassStrategy::kLoopedWithRecommendations;
@@ -239,6 +331,34 @@ FuzzStatus ParseFlags(
           PrintUsage(argv[0]);
           return {FuzzActions::STOP, 1};
         }
+      } else if (0 == strcmp(cur_arg, "-j") ||
+                 0 == strncmp(cur_arg, "--jobs=", sizeof("--jobs=") - 1)) {
+        std::string jobs;
+        if (0 == strcmp(cur_arg, "-j")) {
+          if (argi + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return {FuzzActions::STOP, 1};
+          }
+          jobs = argv[++argi];
+        } else {
+          jobs = spvtools::utils::SplitFlagArgs(cur_arg).second;
+        }
+        char* end = nullptr;
+        errno = 0;
+        const auto parsed_jobs = strtol(jobs.c_str(), &end, 10);
+        if (end == jobs.c_str() || *end != '\0' || errno != 0 ||
+            parsed_jobs < 1) {
+          spvtools::Error(FuzzDiagnostic, nullptr, {},
+                          "The number of jobs must be a positive integer.");
+          return {FuzzActions::STOP, 1};
+        }
+        *num_jobs = static_cast<uint32_t>(parsed_jobs);
+      } else if (0 == strcmp(cur_arg, "--compact-transformations")) {
+        *compact_transformations = true;
+      } else if (0 == strncmp(cur_arg, "--convert-transformations=",
+                              sizeof("--convert-transformations=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        *convert_transformations_file = std::string(split_flag.second);
       } else if (0 == strncmp(cur_arg, "--donors=", sizeof("--donors=") - 1)) {
         const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
         *donors_file = std::string(split_flag.second);
@@ -257,7 +377,10 @@ FuzzStatus ParseFlags(
       } else if (0 == strncmp(cur_arg, "--repeated-pass-strategy=",
                               sizeof("--repeated-pass-strategy=") - 1)) {
         std::string strategy = spvtools::utils::SplitFlagArgs(cur_arg).second;
-        if (strategy == "looped") {
+        if (strategy == "coverage") {
+          *repeated_pass_strategy =
+              spvtools::fuzz::RepeatedPassStrategy::kCoverageGuided;
+        } else if (strategy == "looped") {
           *repeated_pass_strategy =
               spvtools::fuzz::RepeatedPassStrategy::kLoopedWithRecommendations;
         } else if (strategy == "random") {
@@ -270,7 +393,8 @@ FuzzStatus ParseFlags(
           std::stringstream ss;
           ss << "Unknown repeated pass strategy '" << strategy << "'"
              << std::endl;
-          ss << "Valid options are 'looped', 'random' and 'simple'.";
+          ss << "Valid options are 'coverage', 'looped', 'random' and "
+                "'simple'.";
           spvtools::Error(FuzzDiagnostic, nullptr, {}, ss.str().c_str());
           return {FuzzActions::STOP, 1};
         }
@@ -311,6 +435,15 @@ FuzzStatus ParseFlags(
             static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
         assert(end != split_flag.second.c_str() && errno == 0);
         fuzzer_options->set_random_seed(seed);
+      } else if (0 == strncmp(cur_arg, "--seeds=", sizeof("--seeds=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        if (!ParseSeedRange(split_flag.second, first_seed, last_seed)) {
+          spvtools::Error(FuzzDiagnostic, nullptr, {},
+                          "The --seeds argument must have the form <A>..<B>, "
+                          "where A <= B are unsigned 32-bit integers.");
+          return {FuzzActions::STOP, 1};
+        }
+        seed_range_given = true;
       } else if (0 == strncmp(cur_arg, "--shrinker-step-limit=",
                               sizeof("--shrinker-step-limit=") - 1)) {
         const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
@@ -355,6 +488,24 @@ FuzzStatus ParseFlags(
     }
   }
 
+  if (!convert_transformations_file->empty()) {
+    // Conversion does not involve a SPIR-V binary, so it is incompatible with
+    // every mode that does.
+    if (!in_binary_file->empty() || !replay_transformations_file->empty() ||
+        !shrink_transformations_file->empty() || !donors_file->empty() ||
+        seed_range_given || force_render_red) {
+      spvtools::Error(FuzzDiagnostic, nullptr, {},
+                      "The --convert-transformations argument cannot be used "
+                      "with an input binary or any other mode.");
+      return {FuzzActions::STOP, 1};
+    }
+    if (out_binary_file->empty()) {
+      spvtools::Error(FuzzDiagnostic, nullptr, {}, "-o required");
+      return {FuzzActions::STOP, 1};
+    }
+    return {FuzzActions::CONVERT_TRANSFORMATIONS, 0};
+  }
+
   if (in_binary_file->empty()) {
     spvtools::Error(FuzzDiagnostic, nullptr, {}, "No input file specified");
     return {FuzzActions::STOP, 1};
@@ -370,7 +521,7 @@ FuzzStatus ParseFlags(
   if (force_render_red) {
     if (!replay_transformations_file->empty() ||
         !shrink_transformations_file->empty() ||
-        const_fuzzer_options->replay_validation_enabled) {
+        const_fuzzer_options->replay_validation_enabled || seed_range_given) {
       spvtools::Error(FuzzDiagnostic, nullptr, {},
                       "The --force-render-red argument cannot be used with any "
                       "other arguments except -o.");
@@ -414,6 +565,13 @@ FuzzStatus ParseFlags(
                       "nor --shrink.");
       return {FuzzActions::STOP, 1};
     }
+    // Similarly, a range of seeds only makes sense during fuzzing.
+    if (seed_range_given) {
+      spvtools::Error(FuzzDiagnostic, nullptr, {},
+                      "The --seeds argument is not compatible with --replay "
+                      "nor --shrink.");
+      return {FuzzActions::STOP, 1};
+    }
   }
 
   if (!replay_transformations_file->empty()) {
@@ -442,17 +600,86 @@ FuzzStatus ParseFlags(
                     "Fuzzing requires that the --donors option is used.");
     return {FuzzActions::STOP, 1};
   }
+  if (seed_range_given) {
+    if (const_fuzzer_options->has_random_seed) {
+      spvtools::Error(
+          FuzzDiagnostic, nullptr, {},
+          "The --seed and --seeds arguments are mutually exclusive.");
+      return {FuzzActions::STOP, 1};
+    }
+    return {FuzzActions::FUZZ_SEEDS, 0};
+  }
   return {FuzzActions::FUZZ, 0};
 }
 
+// Returns the number of transformations, out of a sequence of
+// |num_transformations| transformations, that should be replayed according to
+// |replay_range|; see the description of --replay-range.
+uint32_t GetNumTransformationsInReplayRange(int32_t replay_range,
+                                            uint32_t num_transformations) {
+  if (replay_range > 0) {
+    // We have a positive replay range, N.  We would like transformations
+    // [0, N), truncated to the number of available transformations if N is too
+    // large.
+    return std::min(static_cast<uint32_t>(replay_range), num_transformations);
+  }
+  // We have non-positive replay range, -N (where N may be 0).  We would like
+  // transformations [0, num_transformations - N), or no transformations if N
+  // is too large.
+  const uint32_t num_to_drop = static_cast<uint32_t>(
+      -static_cast<int64_t>(replay_range));
+  return num_transformations > num_to_drop ? num_transformations - num_to_drop
+                                           : 0;
+}
+
+// Reads the sequence of transformations in |transformations_file| into
+// |transformations|, detecting whether the file is in compact, JSON or binary
+// protobuf form.  Only the transformations selected by |replay_range| are
+// kept; if the file is in compact form, the others are not even read.
 bool ParseTransformations(
-    const std::string& transformations_file,
+    const std::string& transformations_file, int32_t replay_range,
     spvtools::fuzz::protobufs::TransformationSequence* transformations) {
   std::ifstream transformations_stream;
   transformations_stream.open(transformations_file,
                               std::ios::in | std::ios::binary);
-  auto parse_success =
-      transformations->ParseFromIstream(&transformations_stream);
+  bool parse_success = false;
+  if (transformations_stream &&
+      spvtools::fuzz::IsCompactTransformationSequence(
+          &transformations_stream)) {
+    spvtools::fuzz::CompactTransformationSequenceReader reader(
+        &transformations_stream);
+    if (reader.HasValidHeader()) {
+      const uint32_t num_to_read = GetNumTransformationsInReplayRange(
+          replay_range, reader.GetNumTransformations());
+      parse_success = true;
+      while (parse_success &&
+             reader.GetNumTransformationsRead() < num_to_read) {
+        parse_success = reader.ReadNext(transformations->add_transformation());
+      }
+    }
+  } else if (transformations_stream) {
+    std::string contents((std::istreambuf_iterator<char>(
+                             transformations_stream)),
+                         std::istreambuf_iterator<char>());
+    // Binary sequences may start with bytes that look like JSON, so the JSON
+    // format is only tried if the binary format does not parse.
+    parse_success = transformations->ParseFromString(contents);
+    if (!parse_success) {
+      transformations->Clear();
+      parse_success =
+          google::protobuf::util::JsonStringToMessage(contents, transformations)
+              .ok();
+    }
+    if (parse_success) {
+      const auto num_transformations =
+          static_cast<uint32_t>(transformations->transformation_size());
+      const auto num_to_keep =
+          GetNumTransformationsInReplayRange(replay_range, num_transformations);
+      transformations->mutable_transformation()->DeleteSubrange(
+          static_cast<int>(num_to_keep),
+          static_cast<int>(num_transformations - num_to_keep));
+    }
+  }
   transformations_stream.close();
   if (!parse_success) {
     spvtools::Error(FuzzDiagnostic, nullptr, {},
@@ -473,28 +700,15 @@ bool Replay(const spv_target_env& target_env,
             std::vector<uint32_t>* binary_out,
             spvtools::fuzz::protobufs::TransformationSequence*
                 transformations_applied) {
+  // Only the transformations in the replay range are read.
   spvtools::fuzz::protobufs::TransformationSequence transformation_sequence;
   if (!ParseTransformations(replay_transformations_file,
+                            fuzzer_options->replay_range,
                             &transformation_sequence)) {
     return false;
   }
-
-  uint32_t num_transformations_to_apply;
-  if (fuzzer_options->replay_range > 0) {
-    // We have a positive replay range, N.  We would like transformations
-    // [0, N), truncated to the number of available transformations if N is too
-    // large.
-    num_transformations_to_apply = static_cast<uint32_t>(
-        std::min(fuzzer_options->replay_range,
-                 transformation_sequence.transformation_size()));
-  } else {
-    // We have non-positive replay range, -N (where N may be 0).  We would like
-    // transformations [0, num_transformations - N), or no transformations if N
-    // is too large.
-    num_transformations_to_apply = static_cast<uint32_t>(
-        std::max(0, transformation_sequence.transformation_size() +
-                        fuzzer_options->replay_range));
-  }
+  const auto num_transformations_to_apply =
+      static_cast<uint32_t>(transformation_sequence.transformation_size());
 
   auto replay_result =
       spvtools::fuzz::Replayer(
@@ -514,13 +728,13 @@ bool Shrink(const spv_target_env& target_env,
             const std::vector<uint32_t>& binary_in,
             const spvtools::fuzz::protobufs::FactSequence& initial_facts,
             const std::string& shrink_transformations_file,
-            const std::string& shrink_temp_file_prefix,
+            const std::string& shrink_temp_file_prefix, uint32_t num_jobs,
             const std::vector<std::string>& interestingness_command,
             std::vector<uint32_t>* binary_out,
             spvtools::fuzz::protobufs::TransformationSequence*
                 transformations_applied) {
   spvtools::fuzz::protobufs::TransformationSequence transformation_sequence;
-  if (!ParseTransformations(shrink_transformations_file,
+  if (!ParseTransformations(shrink_transformations_file, 0,
                             &transformation_sequence)) {
     return false;
   }
@@ -549,13 +763,13 @@ bool Shrink(const spv_target_env& target_env,
     return ExecuteCommand(command);
   };
 
-  auto shrink_result =
-      spvtools::fuzz::Shrinker(
-          target_env, spvtools::utils::CLIMessageConsumer, binary_in,
-          initial_facts, transformation_sequence, interestingness_function,
-          fuzzer_options->shrinker_step_limit,
-          fuzzer_options->replay_validation_enabled, validator_options)
-          .Run();
+  spvtools::fuzz::Shrinker shrinker(
+      target_env, spvtools::utils::CLIMessageConsumer, binary_in,
+      initial_facts, transformation_sequence, interestingness_function,
+      fuzzer_options->shrinker_step_limit,
+      fuzzer_options->replay_validation_enabled, validator_options);
+  shrinker.SetNumThreads(num_jobs);
+  auto shrink_result = shrinker.Run();
 
   *binary_out = std::move(shrink_result.transformed_binary);
   *transformations_applied = std::move(shrink_result.applied_transformations);
@@ -565,20 +779,30 @@ bool Shrink(const spv_target_env& target_env,
              shrink_result.status;
 }
 
-bool Fuzz(const spv_target_env& target_env,
-          spv_const_fuzzer_options fuzzer_options,
-          spv_validator_options validator_options,
-          const std::vector<uint32_t>& binary_in,
-          const spvtools::fuzz::protobufs::FactSequence& initial_facts,
-          const std::string& donors,
-          spvtools::fuzz::RepeatedPassStrategy repeated_pass_strategy,
-          FuzzingTarget fuzzing_target, std::vector<uint32_t>* binary_out,
-          spvtools::fuzz::protobufs::TransformationSequence*
-              transformations_applied) {
-  auto message_consumer = spvtools::utils::CLIMessageConsumer;
-
-  std::vector<spvtools::fuzz::fuzzerutil::ModuleSupplier> donor_suppliers;
+// A donor shared by the donor suppliers of all fuzzers.  The donor is built
+// and validated once, by the first fuzzer that asks for it; the binary of the
+// validated module is then kept, so that every fuzzer builds its own module
+// from that binary without validating it again.
+struct SharedDonor {
+  // The contents of the donor file, until the donor is validated.
+  std::vector<uint32_t> contents;
+  std::once_flag validated;
+  // The binary of the validated donor module, or empty if the donor could not
+  // be read, built or validated.
+  std::vector<uint32_t> binary;
+};
 
+// Reads the donor file names listed, one per line, in the file |donors|, and
+// makes a module supplier for each donor.  Each donor binary is read once, up
+// front, and validated at most once according to |validator_options|; the
+// suppliers build modules from binaries held in memory, so that they can be
+// shared by fuzzers running on different threads.  The supplied modules are
+// valid, so the fuzzers need not validate them.
+bool MakeDonorSuppliers(
+    const spv_target_env& target_env,
+    const spvtools::MessageConsumer& message_consumer,
+    spv_validator_options validator_options, const std::string& donors,
+    std::vector<spvtools::fuzz::fuzzerutil::ModuleSupplier>* donor_suppliers) {
   std::ifstream donors_file(donors);
   if (!donors_file) {
     spvtools::Error(FuzzDiagnostic, nullptr, {}, "Error opening donors file");
@@ -586,36 +810,60 @@ bool Fuzz(const spv_target_env& target_env,
   }
   std::string donor_filename;
   while (std::getline(donors_file, donor_filename)) {
-    donor_suppliers.emplace_back(
-        [donor_filename, message_consumer,
-         target_env]() -> std::unique_ptr<spvtools::opt::IRContext> {
-          std::vector<uint32_t> donor_binary;
-          if (!ReadBinaryFile<uint32_t>(donor_filename.c_str(),
-                                        &donor_binary)) {
+    // A donor that cannot be read is not an error at this point: its supplier
+    // returns null, as it would if the donor were read lazily.
+    auto donor = std::make_shared<SharedDonor>();
+    ReadBinaryFile<uint32_t>(donor_filename.c_str(), &donor->contents);
+    donor_suppliers->emplace_back(
+        [donor, message_consumer, target_env,
+         validator_options]() -> std::unique_ptr<spvtools::opt::IRContext> {
+          std::call_once(donor->validated, [&donor, &message_consumer,
+                                            target_env, validator_options]() {
+            if (donor->contents.empty()) {
+              return;
+            }
+            auto ir_context = spvtools::BuildModule(
+                target_env, message_consumer, donor->contents.data(),
+                donor->contents.size());
+            if (ir_context &&
+                spvtools::fuzz::fuzzerutil::IsValid(
+                    ir_context.get(), validator_options,
+                    spvtools::fuzz::fuzzerutil::kSilentMessageConsumer)) {
+              // This is the binary that was validated.
+              ir_context->module()->ToBinary(&donor->binary, false);
+            }
+            std::vector<uint32_t>().swap(donor->contents);
+          });
+          if (donor->binary.empty()) {
             return nullptr;
           }
           return spvtools::BuildModule(target_env, message_consumer,
-                                       donor_binary.data(),
-                                       donor_binary.size());
+                                       donor->binary.data(),
+                                       donor->binary.size());
         });
   }
+  return true;
+}
 
-  std::unique_ptr<spvtools::opt::IRContext> ir_context;
-  if (!spvtools::fuzz::fuzzerutil::BuildIRContext(target_env, message_consumer,
-                                                  binary_in, validator_options,
-                                                  &ir_context)) {
-    spvtools::Error(FuzzDiagnostic, nullptr, {}, "Initial binary is invalid");
-    return false;
-  }
-
+// Fuzzes |ir_context|, which must be valid, using |seed| to control random
+// number generation.
+bool Fuzz(spv_const_fuzzer_options fuzzer_options,
+          spv_validator_options validator_options,
+          std::unique_ptr<spvtools::opt::IRContext> ir_context, uint32_t seed,
+          const spvtools::fuzz::protobufs::FactSequence& initial_facts,
+          const std::vector<spvtools::fuzz::fuzzerutil::ModuleSupplier>&
+              donor_suppliers,
+          spvtools::fuzz::RepeatedPassStrategy repeated_pass_strategy,
+          FuzzingTarget fuzzing_target,
+          const spvtools::MessageConsumer& message_consumer,
+          std::vector<uint32_t>* binary_out,
+          spvtools::fuzz::protobufs::TransformationSequence*
+              transformations_applied) {
   assert((fuzzing_target == FuzzingTarget::kWgsl ||
           fuzzing_target == FuzzingTarget::kSpirv) &&
          "Not all fuzzing targets are handled");
   auto fuzzer_context = spvtools::MakeUnique<spvtools::fuzz::FuzzerContext>(
-      spvtools::MakeUnique<spvtools::fuzz::PseudoRandomGenerator>(
-          fuzzer_options->has_random_seed
-              ? fuzzer_options->random_seed
-              : static_cast<uint32_t>(std::random_device()())),
+      spvtools::MakeUnique<spvtools::fuzz::PseudoRandomGenerator>(seed),
       spvtools::fuzz::FuzzerContext::GetMinFreshId(ir_context.get()),
       fuzzing_target == FuzzingTarget::kWgsl);
 
@@ -630,7 +878,8 @@ bool Fuzz(const spv_target_env& target_env,
       std::move(ir_context), std::move(transformation_context),
       std::move(fuzzer_context), message_consumer, donor_suppliers,
       fuzzer_options->all_passes_enabled, repeated_pass_strategy,
-      fuzzer_options->fuzzer_pass_validation_enabled, validator_options, false);
+      fuzzer_options->fuzzer_pass_validation_enabled, validator_options, false,
+      /*donors_are_valid=*/true);
   auto fuzz_result = fuzzer.Run(0);
   if (fuzz_result.status ==
       spvtools::fuzz::Fuzzer::Status::kFuzzerPassLedToInvalidModule) {
@@ -643,6 +892,202 @@ bool Fuzz(const spv_target_env& target_env,
   return true;
 }
 
+// Writes |transformations| in binary protobuf form to |filename|.
+bool WriteTransformationsBinary(
+    const std::string& filename,
+    const spvtools::fuzz::protobufs::TransformationSequence& transformations) {
+  std::ofstream transformations_file;
+  transformations_file.open(filename, std::ios::out | std::ios::binary);
+  bool success = transformations.SerializeToOstream(&transformations_file);
+  transformations_file.close();
+  if (!success) {
+    spvtools::Error(FuzzDiagnostic, nullptr, {},
+                    "Error writing out transformations binary");
+    return false;
+  }
+  return true;
+}
+
+// Writes |transformations| in JSON form to |filename|.
+bool WriteTransformationsJson(
+    const std::string& filename,
+    const spvtools::fuzz::protobufs::TransformationSequence& transformations) {
+  std::string json_string;
+  auto json_options = google::protobuf::util::JsonOptions();
+  json_options.add_whitespace = true;
+  auto json_generation_status = google::protobuf::util::MessageToJsonString(
+      transformations, &json_string, json_options);
+  if (!json_generation_status.ok()) {
+    spvtools::Error(FuzzDiagnostic, nullptr, {},
+                    "Error writing out transformations in JSON format");
+    return false;
+  }
+
+  std::ofstream transformations_json_file(filename);
+  transformations_json_file << json_string;
+  transformations_json_file.close();
+  return true;
+}
+
+// Writes |transformations| in compact form to |filename|.
+bool WriteTransformationsCompact(
+    const std::string& filename,
+    const spvtools::fuzz::protobufs::TransformationSequence& transformations) {
+  std::ofstream transformations_file;
+  transformations_file.open(filename, std::ios::out | std::ios::binary);
+  bool success = spvtools::fuzz::WriteCompactTransformationSequence(
+      transformations, &transformations_file);
+  transformations_file.close();
+  if (!success) {
+    spvtools::Error(FuzzDiagnostic, nullptr, {},
+                    "Error writing out transformations in compact format");
+    return false;
+  }
+  return true;
+}
+
+// If |compact| holds, writes |transformations| in compact form to a file named
+// |output_file_prefix| followed by ".transformations_compact".  Otherwise,
+// writes |transformations| in binary and JSON formats to files named
+// |output_file_prefix| followed by ".transformations" and
+// ".transformations_json", respectively.
+bool WriteTransformations(
+    const std::string& output_file_prefix,
+    const spvtools::fuzz::protobufs::TransformationSequence& transformations,
+    bool compact) {
+  if (compact) {
+    return WriteTransformationsCompact(
+        output_file_prefix + ".transformations_compact", transformations);
+  }
+  return WriteTransformationsBinary(output_file_prefix + ".transformations",
+                                    transformations) &&
+         WriteTransformationsJson(output_file_prefix + ".transformations_json",
+                                  transformations);
+}
+
+// Returns true if and only if |str| ends with |suffix|.
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Reads the transformations in |in_file|, in any supported form, and writes
+// them to |out_file|: in JSON form if its name ends with "json", in compact
+// form if its name ends with "compact", and in binary form otherwise.
+bool ConvertTransformations(const std::string& in_file,
+                            const std::string& out_file) {
+  spvtools::fuzz::protobufs::TransformationSequence transformations;
+  if (!ParseTransformations(in_file, 0, &transformations)) {
+    return false;
+  }
+  if (EndsWith(out_file, "json")) {
+    return WriteTransformationsJson(out_file, transformations);
+  }
+  if (EndsWith(out_file, "compact")) {
+    return WriteTransformationsCompact(out_file, transformations);
+  }
+  return WriteTransformationsBinary(out_file, transformations);
+}
+
+// Runs the fuzzer once for each seed in [|first_seed|, |last_seed|], using up
+// to |num_jobs| threads.  The reference binary is validated, and the donors
+// are read, once; each seed's fuzzer works on its own module built from the
+// shared, validated binary.  The results for seed S are written to files named
+// after |out_binary_file| with "_S" inserted before the extension.  Returns
+// true if and only if fuzzing succeeded for every seed.
+bool FuzzSeeds(const spv_target_env& target_env,
+               spv_const_fuzzer_options fuzzer_options,
+               spv_validator_options validator_options,
+               const std::vector<uint32_t>& binary_in,
+               const spvtools::fuzz::protobufs::FactSequence& initial_facts,
+               const std::string& donors,
+               spvtools::fuzz::RepeatedPassStrategy repeated_pass_strategy,
+               FuzzingTarget fuzzing_target, uint32_t first_seed,
+               uint32_t last_seed, uint32_t num_jobs,
+               const std::string& out_binary_file,
+               bool compact_transformations) {
+  auto message_consumer = spvtools::utils::CLIMessageConsumer;
+
+  std::vector<spvtools::fuzz::fuzzerutil::ModuleSupplier> donor_suppliers;
+  if (!MakeDonorSuppliers(target_env, message_consumer, validator_options,
+                          donors, &donor_suppliers)) {
+    return false;
+  }
+
+  // The reference binary is validated once; each seed's module is then built
+  // from it without validating it again.
+  std::unique_ptr<spvtools::opt::IRContext> reference_ir_context;
+  if (!spvtools::fuzz::fuzzerutil::BuildIRContext(
+          target_env, message_consumer, binary_in, validator_options,
+          &reference_ir_context)) {
+    spvtools::Error(FuzzDiagnostic, nullptr, {}, "Initial binary is invalid");
+    return false;
+  }
+
+  // If not found, dot_pos will be std::string::npos, which can be used in
+  // substr to mean "the end of the string"; there is no need to check the
+  // result.
+  const size_t dot_pos = out_binary_file.rfind('.');
+  const std::string output_file_prefix = out_binary_file.substr(0, dot_pos);
+  const std::string output_file_extension =
+      dot_pos == std::string::npos ? "" : out_binary_file.substr(dot_pos);
+
+  // Seeds are handed out to the threads in increasing order.  A 64-bit
+  // counter is used so that a range ending at UINT32_MAX does not overflow.
+  std::atomic<uint64_t> next_seed(first_seed);
+  std::atomic<bool> all_succeeded(true);
+  auto worker = [&]() {
+    for (uint64_t seed = next_seed++; seed <= last_seed; seed = next_seed++) {
+      const std::string seed_string = std::to_string(seed);
+      // Prefix messages with the seed, as the fuzzers for different seeds may
+      // be interleaved.
+      spvtools::MessageConsumer seed_consumer =
+          [&seed_string, &message_consumer](spv_message_level_t level,
+                                            const char* source,
+                                            const spv_position_t& position,
+                                            const char* message) {
+            message_consumer(level, source, position,
+                             ("seed " + seed_string + ": " + message).c_str());
+          };
+
+      std::vector<uint32_t> binary_out;
+      spvtools::fuzz::protobufs::TransformationSequence transformations_applied;
+      const std::string seed_output_file_prefix =
+          output_file_prefix + "_" + seed_string;
+      const std::string seed_out_binary_file =
+          seed_output_file_prefix + output_file_extension;
+      auto ir_context = spvtools::BuildModule(
+          target_env, seed_consumer, binary_in.data(), binary_in.size());
+      if (!ir_context ||
+          !Fuzz(fuzzer_options, validator_options, std::move(ir_context),
+                static_cast<uint32_t>(seed), initial_facts, donor_suppliers,
+                repeated_pass_strategy, fuzzing_target, seed_consumer,
+                &binary_out, &transformations_applied) ||
+          !WriteFile<uint32_t>(seed_out_binary_file.c_str(), "wb",
+                               binary_out.data(), binary_out.size()) ||
+          !WriteTransformations(seed_output_file_prefix,
+                                transformations_applied,
+                                compact_transformations)) {
+        const std::string error = "Fuzzing failed for seed " + seed_string;
+        spvtools::Error(FuzzDiagnostic, nullptr, {}, error.c_str());
+        all_succeeded = false;
+      }
+    }
+  };
+
+  const uint64_t num_seeds = static_cast<uint64_t>(last_seed) - first_seed + 1;
+  const auto num_threads =
+      static_cast<uint32_t>(std::min<uint64_t>(num_jobs, num_seeds));
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return all_succeeded;
+}
+
 }  // namespace
 
 // Dumps |binary| to file |filename|. Useful for interactive debugging.
@@ -700,6 +1145,11 @@ int main(int argc, const char** argv) {
   std::vector<std::string> interestingness_test;
   std::string shrink_transformations_file;
   std::string shrink_temp_file_prefix = "temp_";
+  uint32_t num_jobs = 1;
+  uint32_t first_seed = 0;
+  uint32_t last_seed = 0;
+  std::string convert_transformations_file;
+  bool compact_transformations = false;
   spvtools::fuzz::RepeatedPassStrategy repeated_pass_strategy;
   auto fuzzing_target = FuzzingTarget::kSpirv;
 
@@ -710,6 +1160,8 @@ int main(int argc, const char** argv) {
       ParseFlags(argc, argv, &in_binary_file, &out_binary_file, &donors_file,
                  &replay_transformations_file, &interestingness_test,
                  &shrink_transformations_file, &shrink_temp_file_prefix,
+                 &num_jobs, &first_seed, &last_seed,
+                 &convert_transformations_file, &compact_transformations,
                  &repeated_pass_strategy, &fuzzing_target, &fuzzer_options,
                  &validator_options);
 
@@ -717,6 +1169,13 @@ int main(int argc, const char** argv) {
     return status.code;
   }
 
+  if (status.action == FuzzActions::CONVERT_TRANSFORMATIONS) {
+    return ConvertTransformations(convert_transformations_file,
+                                  out_binary_file)
+               ? 0
+               : 1;
+  }
+
   std::vector<uint32_t> binary_in;
   if (!ReadBinaryFile<uint32_t>(in_binary_file.c_str(), &binary_in)) {
     return 1;
@@ -755,13 +1214,44 @@ int main(int argc, const char** argv) {
         return 1;
       }
       break;
-    case FuzzActions::FUZZ:
-      if (!Fuzz(target_env, fuzzer_options, validator_options, binary_in,
-                initial_facts, donors_file, repeated_pass_strategy,
-                fuzzing_target, &binary_out, &transformations_applied)) {
+    case FuzzActions::FUZZ: {
+      auto message_consumer = spvtools::utils::CLIMessageConsumer;
+      std::vector<spvtools::fuzz::fuzzerutil::ModuleSupplier> donor_suppliers;
+      if (!MakeDonorSuppliers(target_env, message_consumer, validator_options,
+                              donors_file, &donor_suppliers)) {
         return 1;
       }
-      break;
+      std::unique_ptr<spvtools::opt::IRContext> ir_context;
+      if (!spvtools::fuzz::fuzzerutil::BuildIRContext(
+              target_env, message_consumer, binary_in, validator_options,
+              &ir_context)) {
+        spvtools::Error(FuzzDiagnostic, nullptr, {},
+                        "Initial binary is invalid");
+        return 1;
+      }
+      auto const_fuzzer_options =
+          static_cast<spv_const_fuzzer_options>(fuzzer_options);
+      const uint32_t seed =
+          const_fuzzer_options->has_random_seed
+              ? const_fuzzer_options->random_seed
+              : static_cast<uint32_t>(std::random_device()());
+      if (!Fuzz(fuzzer_options, validator_options, std::move(ir_context), seed,
+                initial_facts, donor_suppliers, repeated_pass_strategy,
+                fuzzing_target, message_consumer, &binary_out,
+                &transformations_applied)) {
+        return 1;
+      }
+    } break;
+    case FuzzActions::FUZZ_SEEDS:
+      // Every seed's outputs are written by FuzzSeeds, so there is nothing
+      // left to write.
+      return FuzzSeeds(target_env, fuzzer_options, validator_options,
+                       binary_in, initial_facts, donors_file,
+                       repeated_pass_strategy, fuzzing_target, first_seed,
+                       last_seed, num_jobs, out_binary_file,
+                       compact_transformations)
+                 ? 0
+                 : 1;
     case FuzzActions::REPLAY:
       if (!Replay(target_env, fuzzer_options, validator_options, binary_in,
                   initial_facts, replay_transformations_file, &binary_out,
@@ -777,8 +1267,8 @@ int main(int argc, const char** argv) {
       }
       if (!Shrink(target_env, fuzzer_options, validator_options, binary_in,
                   initial_facts, shrink_transformations_file,
-                  shrink_temp_file_prefix, interestingness_test, &binary_out,
-                  &transformations_applied)) {
+                  shrink_temp_file_prefix, num_jobs, interestingness_test,
+                  &binary_out, &transformations_applied)) {
         return 1;
       }
     } break;
@@ -799,33 +1289,10 @@ int main(int argc, const char** argv) {
     // result.
     dot_pos = out_binary_file.rfind('.');
     std::string output_file_prefix = out_binary_file.substr(0, dot_pos);
-    std::ofstream transformations_file;
-    transformations_file.open(output_file_prefix + ".transformations",
-                              std::ios::out | std::ios::binary);
-    bool success =
-        transformations_applied.SerializeToOstream(&transformations_file);
-    transformations_file.close();
-    if (!success) {
-      spvtools::Error(FuzzDiagnostic, nullptr, {},
-                      "Error writing out transformations binary");
+    if (!WriteTransformations(output_file_prefix, transformations_applied,
+                              compact_transformations)) {
       return 1;
     }
-
-    std::string json_string;
-    auto json_options = google::protobuf::util::JsonOptions();
-    json_options.add_whitespace = true;
-    auto json_generation_status = google::protobuf::util::MessageToJsonString(
-        transformations_applied, &json_string, json_options);
-    if (!json_generation_status.ok()) {
-      spvtools::Error(FuzzDiagnostic, nullptr, {},
-                      "Error writing out transformations in JSON format");
-      return 1;
-    }
-
-    std::ofstream transformations_json_file(output_file_prefix +
-                                            ".transformations_json");
-    transformations_json_file << json_string;
-    transformations_json_file.close();
   }
 
   return 0;
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <cassert>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <functional>
 #include <sstream>
@@ -95,11 +97,44 @@ NOTE: The reducer is a work in progress.
 
 Options (in lexicographical order):
 
+  --checkpoint=
+               Specifies a file to which the progress of the reduction is
+               periodically saved, so that an interrupted reduction can be
+               carried on using --resume.  The file is replaced each time.
+  --checkpoint-interval=
+               32-bit unsigned integer specifying the number of reduction steps
+               between checkpoints.  The default is 50.  Has no effect unless
+               --checkpoint is given.
   --fail-on-validation-error
                Stop reduction with an error if any reduction step produces a
                SPIR-V module that fails to validate.
   -h, --help
                Print this help.
+  --jobs=
+               32-bit unsigned integer specifying the number of threads to use
+               for function-parallel reduction.  If greater than 1, and no
+               target function is given, each function of the input module is
+               first reduced independently, with up to this many functions
+               being reduced at once, and the reduced functions are merged
+               before the module is reduced as a whole.  The interestingness
+               test must then be safe to run concurrently.  The default is 1.
+  --reduction-strategy=
+               Available strategies are:
+               - round-robin (the default): reduction passes are run in a
+                 fixed order, round after round, halving the number of
+                 reduction opportunities each pass applies at once at the end
+                 of every round.
+               - adaptive: reduction passes are run in order of how productive
+                 they have been so far; passes that keep failing move to
+                 finer granularities early, passes that cannot make progress
+                 are skipped, and chunks of opportunities that fail are split
+                 in half and retried.
+  --resume=
+               Specifies a checkpoint file, written by an earlier invocation
+               with --checkpoint, from which to carry on with the reduction.
+               The same reduction strategy should be used as for the earlier
+               invocation.  The reduction carries on from the binary stored in
+               the checkpoint; <input.spv> should be the original input.
   --step-limit=
                32-bit unsigned integer specifying maximum number of steps the
                reducer will take before giving up.
@@ -147,6 +182,12 @@ ReduceStatus ParseFlags(int argc, const char** argv,
                         std::string* out_binary_file,
                         std::vector<std::string>* interestingness_test,
                         std::string* temp_file_prefix,
+                        spvtools::reduce::Reducer::ReductionStrategy*
+                            reduction_strategy,
+                        uint32_t* num_threads,
+                        std::string* checkpoint_file,
+                        uint32_t* checkpoint_interval,
+                        std::string* resume_file,
                         spvtools::ReducerOptions* reducer_options,
                         spvtools::ValidatorOptions* validator_options) {
   uint32_t positional_arg_index = 0;
@@ -169,6 +210,44 @@ ReduceStatus ParseFlags(int argc, const char** argv,
           PrintUsage(argv[0]);
           return {REDUCE_STOP, 1};
         }
+      } else if (0 == strncmp(cur_arg, "--checkpoint=",
+                              sizeof("--checkpoint=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        *checkpoint_file = std::string(split_flag.second);
+      } else if (0 == strncmp(cur_arg, "--checkpoint-interval=",
+                              sizeof("--checkpoint-interval=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        char* end = nullptr;
+        errno = 0;
+        *checkpoint_interval =
+            static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
+        assert(end != split_flag.second.c_str() && errno == 0);
+      } else if (0 == strncmp(cur_arg, "--resume=", sizeof("--resume=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        *resume_file = std::string(split_flag.second);
+      } else if (0 == strncmp(cur_arg, "--jobs=", sizeof("--jobs=") - 1)) {
+        const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
+        char* end = nullptr;
+        errno = 0;
+        *num_threads =
+            static_cast<uint32_t>(strtol(split_flag.second.c_str(), &end, 10));
+        assert(end != split_flag.second.c_str() && errno == 0);
+      } else if (0 == strncmp(cur_arg, "--reduction-strategy=",
+                              sizeof("--reduction-strategy=") - 1)) {
+        std::string strategy = spvtools::utils::SplitFlagArgs(cur_arg).second;
+        if (strategy == "round-robin") {
+          *reduction_strategy =
+              spvtools::reduce::Reducer::ReductionStrategy::kRoundRobin;
+        } else if (strategy == "adaptive") {
+          *reduction_strategy =
+              spvtools::reduce::Reducer::ReductionStrategy::kAdaptive;
+        } else {
+          std::stringstream ss;
+          ss << "Unknown reduction strategy '" << strategy << "'"
+             << std::endl;
+          spvtools::Error(ReduceDiagnostic, nullptr, {}, ss.str().c_str());
+          return {REDUCE_STOP, 1};
+        }
       } else if (0 == strncmp(cur_arg,
                               "--step-limit=", sizeof("--step-limit=") - 1)) {
         const auto split_flag = spvtools::utils::SplitFlagArgs(cur_arg);
@@ -271,12 +350,19 @@ int main(int argc, const char** argv) {
   std::string temp_file_prefix = "temp_";
 
   spv_target_env target_env = kDefaultEnvironment;
+  spvtools::reduce::Reducer::ReductionStrategy reduction_strategy =
+      spvtools::reduce::Reducer::ReductionStrategy::kRoundRobin;
+  uint32_t num_threads = 1;
+  std::string checkpoint_file;
+  uint32_t checkpoint_interval = 50;
+  std::string resume_file;
   spvtools::ReducerOptions reducer_options;
   spvtools::ValidatorOptions validator_options;
 
   ReduceStatus status = ParseFlags(
       argc, argv, &in_binary_file, &out_binary_file, &interestingness_test,
-      &temp_file_prefix, &reducer_options, &validator_options);
+      &temp_file_prefix, &reduction_strategy, &num_threads, &checkpoint_file,
+      &checkpoint_interval, &resume_file, &reducer_options, &validator_options);
 
   if (status.action == REDUCE_STOP) {
     return status.code;
@@ -297,12 +383,18 @@ int main(int argc, const char** argv) {
   }
   std::string interestingness_command_joined = joined.str();
 
+  // When functions are reduced in parallel, the reduction step counts of the
+  // workers overlap, so temporary files are numbered by this counter instead.
+  std::atomic<uint32_t> temp_file_counter(0);
+
   reducer.SetInterestingnessFunction(
-      [interestingness_command_joined, temp_file_prefix](
-          std::vector<uint32_t> binary, uint32_t reductions_applied) -> bool {
+      [interestingness_command_joined, temp_file_prefix, num_threads,
+       &temp_file_counter](std::vector<uint32_t> binary,
+                           uint32_t reductions_applied) -> bool {
         std::stringstream ss;
         ss << temp_file_prefix << std::setw(4) << std::setfill('0')
-           << reductions_applied << ".spv";
+           << (num_threads > 1 ? temp_file_counter++ : reductions_applied)
+           << ".spv";
         const auto spv_file = ss.str();
         const std::string command =
             interestingness_command_joined + " " + spv_file;
@@ -314,6 +406,33 @@ int main(int argc, const char** argv) {
       });
 
   reducer.AddDefaultReductionPasses();
+  reducer.SetReductionStrategy(reduction_strategy);
+  reducer.SetNumThreads(num_threads);
+
+  if (!checkpoint_file.empty()) {
+    reducer.SetCheckpointFunction(
+        [checkpoint_file](const std::vector<uint32_t>& checkpoint) {
+          // Write to a temporary file first, so that an interruption while
+          // writing does not destroy the previous checkpoint.
+          const std::string temp_checkpoint_file = checkpoint_file + ".tmp";
+          bool written =
+              WriteFile<uint32_t>(temp_checkpoint_file.c_str(), "wb",
+                                  checkpoint.data(), checkpoint.size());
+          if (written && std::rename(temp_checkpoint_file.c_str(),
+                                     checkpoint_file.c_str()) != 0) {
+            // Renaming onto an existing file fails on some platforms.
+            std::remove(checkpoint_file.c_str());
+            written = std::rename(temp_checkpoint_file.c_str(),
+                                  checkpoint_file.c_str()) == 0;
+          }
+          if (!written) {
+            spvtools::utils::CLIMessageConsumer(
+                SPV_MSG_WARNING, nullptr, {},
+                ("Failed to write checkpoint " + checkpoint_file).c_str());
+          }
+        },
+        checkpoint_interval);
+  }
 
   reducer.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
 
@@ -346,8 +465,22 @@ int main(int argc, const char** argv) {
   }
 
   std::vector<uint32_t> binary_out;
-  const auto reduction_status = reducer.Run(std::move(binary_in), &binary_out,
-                                            reducer_options, validator_options);
+  spvtools::reduce::Reducer::ReductionResultStatus reduction_status;
+  if (resume_file.empty()) {
+    reduction_status = reducer.Run(std::move(binary_in), &binary_out,
+                                   reducer_options, validator_options);
+  } else {
+    std::vector<uint32_t> checkpoint;
+    if (!ReadBinaryFile<uint32_t>(resume_file.c_str(), &checkpoint)) {
+      return 1;
+    }
+    reduction_status = reducer.Resume(checkpoint, &binary_out,
+                                      reducer_options, validator_options);
+    if (reduction_status == spvtools::reduce::Reducer::ReductionResultStatus::
+                                kCheckpointInvalid) {
+      return 1;
+    }
+  }
 
   // Always try to write the output file, even if the reduction failed.
   if (!WriteFile<uint32_t>(out_binary_file.c_str(), "wb", binary_out.data(),
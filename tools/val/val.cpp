@@ -68,6 +68,26 @@ Options:
                                    be allowed by the target environment.
   --before-hlsl-legalization       Allows code patterns that are intended to be
                                    fixed by spirv-opt's legalization passes.
+  --profile                        {full|structural}
+                                   Select the checks to run.  The structural
+                                   profile only checks ids, forward
+                                   references, the module layout, memory and
+                                   composite instructions and the structure of
+                                   the control flow graph, and is meant for
+                                   modules from a trusted producer.  The
+                                   default is full.
+  --max-cfg-edges                  <maximum number of edges between the blocks of the module>
+  --max-dominance-queries          <maximum number of dominance queries made by the validator>
+  --max-type-traversal             <maximum number of types visited when walking composite types>
+  --streaming                      Check the instructions while parsing the
+                                   module, and stop at the first error, so
+                                   that invalid modules are rejected sooner.
+                                   The first error reported for a module
+                                   with several errors may differ.
+  --stats                          Print the time spent and the number of
+                                   instructions inspected by each family of
+                                   checks, and the sizes of the module's main
+                                   data structures.
   --version                        Display validator version information.
   --target-env                     {%s}
                                    Use validation rules from the specified environment.
@@ -88,6 +108,7 @@ int main(int argc, char** argv) {
       if (0 == strncmp(cur_arg, "--max-", 6)) {
         if (argi + 1 < argc) {
           spv_validator_limit limit_type;
+          spv_validator_work_limit work_limit_type;
           if (spvParseUniversalLimitsOptions(cur_arg, &limit_type)) {
             uint32_t limit = 0;
             if (sscanf(argv[++argi], "%u", &limit)) {
@@ -97,6 +118,15 @@ int main(int argc, char** argv) {
               continue_processing = false;
               return_code = 1;
             }
+          } else if (spvParseWorkLimitsOptions(cur_arg, &work_limit_type)) {
+            uint32_t limit = 0;
+            if (sscanf(argv[++argi], "%u", &limit)) {
+              options.SetWorkLimit(work_limit_type, limit);
+            } else {
+              fprintf(stderr, "error: missing argument to %s\n", cur_arg);
+              continue_processing = false;
+              return_code = 1;
+            }
           } else {
             fprintf(stderr, "error: unrecognized option: %s\n", cur_arg);
             continue_processing = false;
@@ -144,6 +174,23 @@ int main(int argc, char** argv) {
           continue_processing = false;
           return_code = 1;
         }
+      } else if (0 == strcmp(cur_arg, "--profile")) {
+        if (argi + 1 < argc) {
+          const auto profile_str = argv[++argi];
+          if (0 == strcmp(profile_str, "full")) {
+            options.SetProfile(SPV_VAL_PROFILE_FULL);
+          } else if (0 == strcmp(profile_str, "structural")) {
+            options.SetProfile(SPV_VAL_PROFILE_STRUCTURAL);
+          } else {
+            fprintf(stderr, "error: Unrecognized profile: %s\n", profile_str);
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to --profile\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == strcmp(cur_arg, "--before-hlsl-legalization")) {
         options.SetBeforeHlslLegalization(true);
       } else if (0 == strcmp(cur_arg, "--relax-logical-pointer")) {
@@ -162,6 +209,10 @@ int main(int argc, char** argv) {
         options.SetAllowLocalSizeId(true);
       } else if (0 == strcmp(cur_arg, "--relax-struct-store")) {
         options.SetRelaxStructStore(true);
+      } else if (0 == strcmp(cur_arg, "--streaming")) {
+        options.SetStreaming(true);
+      } else if (0 == strcmp(cur_arg, "--stats")) {
+        options.SetCollectStats(true);
       } else if (0 == cur_arg[1]) {
         // Setting a filename of "-" to indicate stdin.
         if (!inFile) {
@@ -196,7 +247,17 @@ int main(int argc, char** argv) {
   if (!ReadBinaryFile<uint32_t>(inFile, &contents)) return 1;
 
   spvtools::SpirvTools tools(target_env);
-  tools.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
+  tools.SetMessageConsumer([](spv_message_level_t level, const char* source,
+                              const spv_position_t& position,
+                              const char* message) {
+    // The statistics are the only info message of the validator, and are
+    // printed as they are.
+    if (level == SPV_MSG_INFO) {
+      printf("%s", message);
+      return;
+    }
+    spvtools::utils::CLIMessageConsumer(level, source, position, message);
+  });
 
   bool succeed = tools.Validate(contents.data(), contents.size(), options);
 